@@ -178,6 +178,44 @@ int API_MC_Delete_Key(unsigned char *Key_id, size_t Key_id_length)
     return KEY_OPERATION_OK; // Success
 }
 
+int API_MC_Select_Packet_Suite(unsigned char suite)
+{
+    if (API_SM_get_current_state() != STATE_OPERATIONAL)
+    {
+        API_LT_traceWrite("incorrect state to select packet suite, returning error", NULL);
+        API_EM_increment_error_counter(10);
+        return SM_ERROR_STATE; // Not in operational state
+    }
+
+    API_SM_State_Change(STATE_CSP); // Switch to CSP mode
+    API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
+
+    int Operation_result = API_KM_set_packet_suite(suite); // Select suite of the loaded key
+
+    if (Operation_result == MT_MEMORYVIOLATION)
+    {
+        API_LT_traceWrite("Key integrity compromised, switching to error state: ", API_EM_get_error_message(Operation_result), NULL);
+        API_SM_State_Change(SM_ERROR);
+        API_EM_zeroize_entire_module();
+        API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
+        return Operation_result;
+    }
+    if (Operation_result != KM_OK)
+    {
+        API_LT_traceWrite("Error in packet suite selection:", API_EM_get_error_message(Operation_result), NULL);
+        API_EM_increment_error_counter(5);      // Log error and increment counter
+        API_SM_State_Change(STATE_OPERATIONAL); // Revert state
+        API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
+        return Operation_result;
+    }
+
+    API_LT_traceWrite("Packet suite of the loaded key:", (suite == PCA_SUITE_AES_GCM) ? "AES-GCM" : (suite == PCA_SUITE_CHACHA20_POLY1305) ? "ChaCha20-Poly1305" : "AES-CBC + HMAC-SHA256", "selected", NULL);
+    API_SM_State_Change(STATE_OPERATIONAL); // Revert state
+    API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
+
+    return KEY_OPERATION_OK; // Success
+}
+
 int API_MC_fill_buffer_random(unsigned char *buffer, size_t size){ // wrapper of rng function, tbd make it more optimal
     // Check if the system is in an operational state
     if (API_SM_get_current_state() != STATE_OPERATIONAL)
@@ -199,6 +237,11 @@ int API_MC_fill_buffer_random(unsigned char *buffer, size_t size){ // wrapper of
 }
 
 int API_MC_Sing_Cipher_Packet(unsigned char *data_in, size_t data_size, unsigned char *packet_out, size_t *packet_out_length)
+{
+    return API_MC_Sing_Cipher_Packet_Suite(data_in, data_size, PCA_SUITE_KEY, packet_out, packet_out_length);
+}
+
+int API_MC_Sing_Cipher_Packet_Suite(unsigned char *data_in, size_t data_size, unsigned char suite, unsigned char *packet_out, size_t *packet_out_length)
 {
     // Check if the system is in an operational state
     if (API_SM_get_current_state() != STATE_OPERATIONAL)
@@ -217,7 +260,7 @@ int API_MC_Sing_Cipher_Packet(unsigned char *data_in, size_t data_size, unsigned
     }
 
     // Validate input parameters
-    if (data_in == NULL || packet_out == NULL || packet_out_length == NULL)
+    if (data_in == NULL || packet_out == NULL || packet_out_length == NULL || (suite != PCA_SUITE_KEY && !API_PCA_is_valid_suite(suite)))
     {
         API_LT_traceWrite("Error:", API_EM_get_error_message(KM_PARAMETERS_ERROR), NULL);
         return KM_PARAMETERS_ERROR;
@@ -229,6 +272,14 @@ int API_MC_Sing_Cipher_Packet(unsigned char *data_in, size_t data_size, unsigned
 
     // Verify the integrity of the key in use
     int Operation_result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_In_Use]);
+    if (Operation_result == MT_OK)
+    { // and of its key schedules, which cipher every packet
+        Operation_result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_AES_ctx]);
+    }
+    if (Operation_result == MT_OK)
+    {
+        Operation_result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_GCM_ctx]);
+    }
     if (Operation_result != MT_OK)
     {
         API_LT_traceWrite("Key integrity compromised, switching to error state: ", API_EM_get_error_message(Operation_result), NULL);
@@ -243,10 +294,25 @@ int API_MC_Sing_Cipher_Packet(unsigned char *data_in, size_t data_size, unsigned
     API_SM_State_Change(STATE_CRYPTOGRAPHIC);
     API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
 
-    // Perform the sign and encrypt operation
-    unsigned char *out_data;
+    // Perform the sign and encrypt operation with the requested suite, AEAD packets are built directly in the output buffer
+    unsigned char *out_data = packet_out;
     size_t out_length;
-    Operation_result = API_PCA_sign_encrypt_packet(data_in, data_size, Current_key_in_use.Cipher_key, Current_key_in_use.Auth_key, &out_data, &out_length);
+    if (suite == PCA_SUITE_KEY)
+    {
+        suite = Current_key_in_use.Packet_suite;
+    }
+    if (suite == PCA_SUITE_AES_GCM)
+    {
+        Operation_result = API_PCA_encrypt_packet_GCM(data_in, data_size, &Current_key_GCM_ctx, packet_out, &out_length);
+    }
+    else if (suite == PCA_SUITE_CHACHA20_POLY1305)
+    {
+        Operation_result = API_PCA_encrypt_packet_CHACHA(data_in, data_size, Current_key_in_use.ChaCha_key, packet_out, &out_length);
+    }
+    else
+    {
+        Operation_result = API_PCA_sign_encrypt_packet(data_in, data_size, &Current_key_AES_ctx, &Current_key_in_use.Auth_midstate, &out_data, &out_length);
+    }
 
     if (Operation_result == SM_ERROR_STATE)
     {
@@ -258,7 +324,10 @@ int API_MC_Sing_Cipher_Packet(unsigned char *data_in, size_t data_size, unsigned
         return PRNG_GENERATION_FAILED;
     }
     // Copy the signed and encrypted data to the output buffer
-    memcpy(packet_out, out_data, out_length);
+    if (out_data != packet_out)
+    {
+        memcpy(packet_out, out_data, out_length);
+    }
     *packet_out_length = out_length;
 
     // Free the allocated memory if necessary
@@ -275,6 +344,121 @@ int API_MC_Sing_Cipher_Packet(unsigned char *data_in, size_t data_size, unsigned
     return CIPHER_AUTH_OPERATION_OK; // Return success code
 }
 
+int API_MC_Sing_Cipher_Packets(unsigned char **data_in, size_t *data_size, size_t npackets, unsigned char **packet_out, size_t *packet_out_length)
+{
+    // Check if the system is in an operational state
+    if (API_SM_get_current_state() != STATE_OPERATIONAL)
+    {
+        API_LT_traceWrite("incorrect state to cipher packet", API_SM_get_current_state_name(), NULL);
+        API_EM_increment_error_counter(10);
+        return SM_ERROR_STATE; // Return error if not operational
+    }
+
+    // Check if the current key is loaded
+    if (Current_key_in_use.IsLoaded == 0)
+    {
+        API_LT_traceWrite("Error:", API_EM_get_error_message(KM_KEY_NOT_LOADED), NULL);
+        API_EM_increment_error_counter(5); // Log error and increment counter
+        return KM_KEY_NOT_LOADED;          // Return error if key is not loaded
+    }
+
+    // Validate input parameters
+    if (data_in == NULL || data_size == NULL || packet_out == NULL || packet_out_length == NULL)
+    {
+        API_LT_traceWrite("Error:", API_EM_get_error_message(KM_PARAMETERS_ERROR), NULL);
+        return KM_PARAMETERS_ERROR;
+    }
+    for (size_t i = 0; i < npackets; i++)
+    {
+        if (data_in[i] == NULL || packet_out[i] == NULL)
+        {
+            API_LT_traceWrite("Error:", API_EM_get_error_message(KM_PARAMETERS_ERROR), NULL);
+            return KM_PARAMETERS_ERROR;
+        }
+    }
+
+    // Switch system state to CSP mode for cryptographic operations
+    API_SM_State_Change(STATE_CSP);
+    API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
+
+    // Verify the integrity of the key in use, once for the whole batch
+    int Operation_result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_In_Use]);
+    if (Operation_result == MT_OK)
+    { // and of its key schedules, which cipher every packet
+        Operation_result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_AES_ctx]);
+    }
+    if (Operation_result == MT_OK)
+    {
+        Operation_result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_GCM_ctx]);
+    }
+    if (Operation_result != MT_OK)
+    {
+        API_LT_traceWrite("Key integrity compromised, switching to error state: ", API_EM_get_error_message(Operation_result), NULL);
+        API_SM_State_Change(SM_ERROR);
+        API_EM_zeroize_entire_module();
+        API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
+        return Operation_result;
+    }
+
+    // Key integrity is verified, proceed to sign and encrypt the packets
+    API_LT_traceWrite("Key Integrity checked,", "proceeding to sign and cipher batch", NULL);
+    API_SM_State_Change(STATE_CRYPTOGRAPHIC);
+    API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
+
+    // Perform the sign and encrypt operation directly on the output buffers, with the suite of the loaded key.
+    // The lengths start at 0 so the packets built before a failure can be told apart and erased
+    memset(packet_out_length, 0, npackets * sizeof(size_t));
+    if (Current_key_in_use.Packet_suite == PCA_SUITE_AES_GCM)
+    {
+        for (size_t i = 0; i < npackets; i++)
+        {
+            Operation_result = API_PCA_encrypt_packet_GCM(data_in[i], data_size[i], &Current_key_GCM_ctx, packet_out[i], &packet_out_length[i]);
+            if (Operation_result != NOT_ALLOCATED_MEMORY)
+            {
+                break;
+            }
+        }
+    }
+    else if (Current_key_in_use.Packet_suite == PCA_SUITE_CHACHA20_POLY1305)
+    {
+        for (size_t i = 0; i < npackets; i++)
+        {
+            Operation_result = API_PCA_encrypt_packet_CHACHA(data_in[i], data_size[i], Current_key_in_use.ChaCha_key, packet_out[i], &packet_out_length[i]);
+            if (Operation_result != NOT_ALLOCATED_MEMORY)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        Operation_result = API_PCA_sign_encrypt_packets(data_in, data_size, npackets, &Current_key_AES_ctx, &Current_key_in_use.Auth_midstate, packet_out, packet_out_length);
+    }
+
+    if (Operation_result == SM_ERROR_STATE)
+    {
+        API_SM_State_Change(STATE_OPERATIONAL);
+        return SM_ERROR_STATE;
+    }
+    else if(Operation_result == PRNG_GENERATION_FAILED){
+        // No partial batch is returned, the AEAD suites build one packet at a time
+        for (size_t i = 0; i < npackets; i++)
+        {
+            memset(packet_out[i], 0, packet_out_length[i]);
+            packet_out_length[i] = 0;
+        }
+        API_SM_State_Change(STATE_OPERATIONAL);
+        return PRNG_GENERATION_FAILED;
+    }
+
+    // Return system state to operational
+    API_LT_traceWrite("Sign and cipher batch operation: ", "OK", NULL);
+    API_SM_State_Change(STATE_OPERATIONAL);
+    API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
+
+    return CIPHER_AUTH_OPERATION_OK; // Return success code
+}
+
 int API_MC_Decipher_Auth_Packet(unsigned char *data_in, size_t data_in_length, unsigned char *out_data, size_t *out_data_length)
 {
     // Check if system is operational
@@ -294,7 +478,7 @@ int API_MC_Decipher_Auth_Packet(unsigned char *data_in, size_t data_in_length, u
     }
 
     // Validate input parameters
-    if (data_in == NULL || out_data == NULL || out_data_length == NULL)
+    if (data_in == NULL || out_data == NULL || out_data_length == NULL || data_in_length < 8)
     {
         API_LT_traceWrite("Error:", API_EM_get_error_message(KM_PARAMETERS_ERROR), NULL);
         return KM_PARAMETERS_ERROR;
@@ -306,6 +490,14 @@ int API_MC_Decipher_Auth_Packet(unsigned char *data_in, size_t data_in_length, u
 
     // Verify key integrity
     int Operation_result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_In_Use]);
+    if (Operation_result == MT_OK)
+    { // and of its key schedules, which cipher every packet
+        Operation_result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_AES_ctx]);
+    }
+    if (Operation_result == MT_OK)
+    {
+        Operation_result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_GCM_ctx]);
+    }
     if (Operation_result != MT_OK)
     {
         API_LT_traceWrite("Key integrity compromised", API_EM_get_error_message(Operation_result), NULL);
@@ -319,11 +511,27 @@ int API_MC_Decipher_Auth_Packet(unsigned char *data_in, size_t data_in_length, u
     API_SM_State_Change(STATE_CRYPTOGRAPHIC); // Switch to cryptographic state
     API_LT_traceWrite("Current state: ", API_SM_get_current_state_name(), NULL);
 
-    // Proceed to decrypt and verify packet
-    unsigned char *out_data_aux;
-    size_t out_length_aux;
+    // Proceed to decrypt and verify packet with the suite written in its header, AEAD packets are decrypted directly in the output buffer.
+    // Every suite has its own key derived from the main key (see API_KM_loadkey), so accepting the suite of the packet does not
+    // use one key under several algorithms
+    unsigned char *out_data_aux = out_data;
+    size_t out_length_aux = 0;
     unsigned char verify;
-    Operation_result = API_PCA_decrypt_verify_packet(data_in, data_in_length, Current_key_in_use.Cipher_key, Current_key_in_use.Auth_key, &out_data_aux, &out_length_aux, &verify);
+    switch (API_PCA_get_packet_suite(data_in))
+    {
+    case PCA_SUITE_AES_GCM:
+        Operation_result = API_PCA_decrypt_packet_GCM(data_in, data_in_length, &Current_key_GCM_ctx, out_data, &out_length_aux, &verify);
+        break;
+    case PCA_SUITE_CHACHA20_POLY1305:
+        Operation_result = API_PCA_decrypt_packet_CHACHA(data_in, data_in_length, Current_key_in_use.ChaCha_key, out_data, &out_length_aux, &verify);
+        break;
+    case PCA_SUITE_AES_CBC_HMAC_SHA256:
+        Operation_result = API_PCA_decrypt_verify_packet(data_in, data_in_length, &Current_key_AES_ctx, &Current_key_in_use.Auth_midstate, &out_data_aux, &out_length_aux, &verify);
+        break;
+    default:
+        Operation_result = MAC_NOT_VERIFIED; // unknown suite
+        break;
+    }
 
     if (Operation_result == SM_ERROR_STATE)
     {
@@ -339,7 +547,10 @@ int API_MC_Decipher_Auth_Packet(unsigned char *data_in, size_t data_in_length, u
     }
 
     // Copy the decrypted and verified data to the output buffer
-    memcpy(out_data, out_data_aux, out_length_aux);
+    if (out_data_aux != out_data)
+    {
+        memcpy(out_data, out_data_aux, out_length_aux);
+    }
     *out_data_length = out_length_aux;
     // Handle packet integrity failure before copying the data
     // Free memory if necessary
@@ -361,6 +572,12 @@ int API_MC_Shutdown_module()
     // Log the shutdown action
     API_LT_traceWrite("Shutting down the cryptomodule: ", "POWER OFF", NULL);
 
+    // Stop the AES-CTR bulk worker threads
+    API_AES_CTR_stop_workers();
+
+    // Stop the ECDSA nonce pool thread, its nonces are zeroized
+    API_ECDSA_nonce_pool_stop();
+
     // Zeroize and free all sensitive data
     API_MT_zeroize_and_free_all();
 
@@ -144,6 +144,25 @@ int API_MC_Load_Key(unsigned char *Key_id, size_t Key_id_length);
  */
 int API_MC_Delete_Key(unsigned char *Key_id, size_t Key_id_length);
 
+/**
+ * @brief Selects the packet suite used with the loaded key.
+ * 
+ * Every key starts with `API_PCA_default_suite()` when it is loaded (ChaCha20-Poly1305 if AES-NI is not available). After this call, `API_MC_Sing_Cipher_Packet` and
+ * `API_MC_Sing_Cipher_Packets` build the packets of the loaded key with the selected suite. `API_MC_Decipher_Auth_Packet`
+ * always uses the suite written in the packet header, so packets of every suite can be received. Each suite uses its own
+ * key derived from the main key when it is loaded, so no key is ever used by two algorithms and a packet can only be
+ * authenticated under the suite it was built with.
+ * 
+ * @param[in] suite        `PCA_SUITE_AES_CBC_HMAC_SHA256`, `PCA_SUITE_AES_GCM` or `PCA_SUITE_CHACHA20_POLY1305`.
+ * 
+ * @return int             Returns `KEY_OPERATION_OK` on success, `KM_PARAMETERS_ERROR` if the suite is not supported,
+ *                         `KM_KEY_NOT_LOADED` if no key is loaded, `MT_MEMORYVIOLATION` if the loaded key is corrupted
+ *                         (the module goes to the error state), or another error code if the operation fails.
+ * 
+ * @pre The system must be in the `STATE_OPERATIONAL` state and a key must be loaded.
+ */
+int API_MC_Select_Packet_Suite(unsigned char suite);
+
 /**
  * @brief wrapper of RNG for API CORE.Fills a buffer with random bytes with 4MB of max size, attempting to use secure sources.
  *
@@ -165,7 +184,8 @@ int API_MC_fill_buffer_random(unsigned char *buffer, size_t size);
 /**
  * @brief Signs and encrypts a data packet.
  *
- * This function performs a secure encryption and sign operation on the input data.
+ * This function performs a secure encryption and sign operation on the input data, with the packet suite
+ * of the loaded key (see `API_MC_Select_Packet_Suite`).
  * It checks the system's operational state and loaded key integrity before processing. If the
  * system is not in the correct state or the key is not loaded, appropriate error codes
  * are returned. The resulting signed and encrypted data is stored in `packet_out`, and
@@ -192,10 +212,64 @@ int API_MC_fill_buffer_random(unsigned char *buffer, size_t size);
 
 int API_MC_Sing_Cipher_Packet(unsigned char *data_in, size_t data_size, unsigned char *packet_out, size_t *packet_out_length);
 
+/**
+ * @brief Signs and encrypts a data packet with the given packet suite.
+ *
+ * Same as `API_MC_Sing_Cipher_Packet`, but the packet suite is chosen for this call. With `PCA_SUITE_AES_GCM` the
+ * payload is encrypted and authenticated in a single AES-GCM pass and the packet is only 36 bytes larger than the input data,
+ * `PCA_SUITE_CHACHA20_POLY1305` builds the same packet layout with ChaCha20-Poly1305.
+ *
+ * @warning The memory pointed to by `unsigned char *packet_out` must be at least 72 bytes
+ * larger than the input data size (`data_size`).
+ *
+ * @param[in]  data_in           Pointer to the input data to be signed and encrypted.
+ * @param[in]  data_size         Size of the input data in bytes.
+ * @param[in]  suite             `PCA_SUITE_AES_CBC_HMAC_SHA256`, `PCA_SUITE_AES_GCM`, `PCA_SUITE_CHACHA20_POLY1305`, or `PCA_SUITE_KEY` for the suite of the loaded key.
+ * @param[out] packet_out        Pointer to the output buffer where the packet will be stored.
+ * @param[out] packet_out_length Pointer to store the length of the packet.
+ *
+ * @return int
+ *         - CIPHER_AUTH_OPERATION_OK on success.
+ *         - SM_ERROR_STATE if the system is not in an operational state.
+ *         - KM_KEY_NOT_LOADED if the cryptographic key is not loaded.
+ *         - KM_PARAMETERS_ERROR if the parameters or the suite are not valid.
+ *         - Various other error codes depending on the result of the key integrity check.
+ */
+
+int API_MC_Sing_Cipher_Packet_Suite(unsigned char *data_in, size_t data_size, unsigned char suite, unsigned char *packet_out, size_t *packet_out_length);
+
+/**
+ * @brief Signs and encrypts several queued data packets with the loaded key.
+ *
+ * Batch version of `API_MC_Sing_Cipher_Packet`, the state and key integrity checks are done once for the
+ * whole batch and, with the AES-CBC suite, the CBC encryption of several packets advances in lockstep. Every
+ * packet has the same format as the ones produced by `API_MC_Sing_Cipher_Packet` (suite of the loaded key).
+ *
+ * @warning Each buffer `packet_out[i]` must be at least 72 bytes larger than `data_size[i]`.
+ *
+ * @param[in]  data_in           Array of pointers to the input data of each packet.
+ * @param[in]  data_size         Array with the size in bytes of each input data.
+ * @param[in]  npackets          Number of packets.
+ * @param[out] packet_out        Array of pointers to the output buffers.
+ * @param[out] packet_out_length Array where the length of each packet is stored.
+ *
+ * @return int
+ *         - CIPHER_AUTH_OPERATION_OK on success.
+ *         - SM_ERROR_STATE if the system is not in an operational state.
+ *         - KM_KEY_NOT_LOADED if the cryptographic key is not loaded.
+ *         - PRNG_GENERATION_FAILED if an IV cannot be generated, then no packet is returned: the output buffers
+ *           are left without packets and every length is set to 0.
+ *         - Various other error codes depending on the result of the key integrity check.
+ */
+
+int API_MC_Sing_Cipher_Packets(unsigned char **data_in, size_t *data_size, size_t npackets, unsigned char **packet_out, size_t *packet_out_length);
+
 /**
  * @brief Authenticates an decrypt an encrypted data packet.
  *
- * This function verifies the integrity of a packet, and decrypts it. 
+ * This function verifies the integrity of a packet, and decrypts it. The suite written in the packet header is used,
+ * with the key of that suite derived from the loaded key (see `API_MC_Select_Packet_Suite`), so packets built by
+ * `API_MC_Sing_Cipher_Packet_Suite` with any suite are accepted.
  * It checks whether the system is in an operational state and validates the integrity of the key in use.
  * If the system is not operational or the key is not loaded, the function returns appropriate error codes.
  * After successful decryption and authentication, the resulting data is stored in `out_data`, 
@@ -0,0 +1,172 @@
+/**
+ * @file AES256_CTR_Tests.c
+ * @brief File containing all the neccesary code to perform the AES-CTR tests.
+ */
+#include "AES256_CTR_Tests.h"
+
+
+int SFT_AES256CTR_katTests(){
+    int verified = 1;
+
+	//# NIST SP 800-38A
+	//# F.5.5 CTR-AES256.Encrypt
+	//Testing AES CTR number 0
+	unsigned char key0[] = {
+	0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 
+	0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81, 
+	0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 
+	0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4,  
+	};
+	unsigned char counter0[] = {
+	0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 
+	0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,  
+	};
+	unsigned int len0 = 64;
+	unsigned char plaintext0[] = {
+	0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 
+	0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a, 
+	0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 
+	0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51, 
+	0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 
+	0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef, 
+	0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 
+	0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10,  
+	};
+	unsigned char ciphertext0[] = {
+	0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5, 
+	0xb7, 0xa7, 0xf5, 0x04, 0xbb, 0xf3, 0xd2, 0x28, 
+	0xf4, 0x43, 0xe3, 0xca, 0x4d, 0x62, 0xb5, 0x9a, 
+	0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5, 
+	0x2b, 0x09, 0x30, 0xda, 0xa2, 0x3d, 0xe9, 0x4c, 
+	0xe8, 0x70, 0x17, 0xba, 0x2d, 0x84, 0x98, 0x8d, 
+	0xdf, 0xc9, 0xc5, 0x8d, 0xb6, 0x7a, 0xad, 0xa6, 
+	0x13, 0xc2, 0xdd, 0x08, 0x45, 0x79, 0x41, 0xa6,  
+	};
+	if(SFT_AESCTR_256_encrypt_decrypt_compare(plaintext0, len0, counter0, key0, ciphertext0 ) == 0) verified = 0;
+
+	//# F.5.6 CTR-AES256.Decrypt
+	if(SFT_AESCTR_256_encrypt_decrypt_compare(ciphertext0, len0, counter0, key0, plaintext0 ) == 0) verified = 0;
+
+	// Partial last block, only the used keystream bytes must be applied
+	if(SFT_AESCTR_256_encrypt_decrypt_compare(plaintext0, 37, counter0, key0, ciphertext0 ) == 0) verified = 0;
+
+    return verified;
+}
+
+int SFT_AES256CTR_counterTests(){
+    int verified = 1;
+
+	// The counter is a full 128-bit big-endian integer, the carry has to cross the 64-bit halves
+	unsigned char key0[] = {
+	0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 
+	0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81, 
+	0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 
+	0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4,  
+	};
+	unsigned char counter0[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,  
+	};
+	unsigned int len0 = 48;
+	unsigned char plaintext0[48] = {0};
+	unsigned char ciphertext0[] = {
+	0xb7, 0x31, 0x01, 0x1f, 0x28, 0xc6, 0x51, 0xc2, 
+	0x61, 0x44, 0xc6, 0x08, 0x4a, 0xf1, 0x73, 0x4a, 
+	0x0d, 0x82, 0x9d, 0x44, 0x21, 0x23, 0x5e, 0xf5, 
+	0xf9, 0xad, 0x37, 0x55, 0xc8, 0xa5, 0x4d, 0x8e, 
+	0x0a, 0xce, 0x37, 0x0f, 0x7b, 0x14, 0x65, 0x2a, 
+	0x7f, 0x2e, 0x9b, 0xe6, 0xfd, 0x64, 0xd6, 0xdf,  
+	};
+	unsigned char next_counter0[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,  
+	};
+	if(SFT_AESCTR_256_encrypt_decrypt_compare(plaintext0, len0, counter0, key0, ciphertext0 ) == 0) verified = 0;
+
+	// The counter returned must be the next unused one
+	unsigned char aux_text[48];
+	API_AES_CTR_EncryptDecrypt(plaintext0, len0, key0, AES_KEY_SIZE_256, counter0, aux_text);
+	if(memcmp(counter0, next_counter0, AES_BLOCK_SIZE) != 0) verified = 0;
+
+    return verified;
+}
+
+int SFT_AES256CTR_parallelTests(){
+    int verified = 1;
+    size_t len = 2 * AES_CTR_PARALLEL_THRESHOLD + 37; // big enough to be split, with a partial last block
+    unsigned char key[AES_KEY_SIZE_256];
+    unsigned char counter_serial[AES_BLOCK_SIZE], counter_parallel[AES_BLOCK_SIZE];
+    AesContext ctx;
+
+    unsigned char *plaintext = malloc(len);
+    unsigned char *ciphertext_serial = malloc(len);
+    unsigned char *ciphertext_parallel = malloc(len);
+    if(plaintext == NULL || ciphertext_serial == NULL || ciphertext_parallel == NULL){
+        free(plaintext);
+        free(ciphertext_serial);
+        free(ciphertext_parallel);
+        return 0;
+    }
+
+    for(size_t i = 0; i < len; i++) plaintext[i] = (unsigned char)(i * 31 + (i >> 8));
+    for(int i = 0; i < AES_KEY_SIZE_256; i++) key[i] = (unsigned char)(0xa5 ^ i);
+    API_AES_initkey(&ctx, key, AES_KEY_SIZE_256);
+
+    // The default pool, then AES_CTR_MAX_WORKERS workers whatever the number of cores. Every round starts a new
+    // pool, so its first job is posted while the new workers may not have run yet
+    int workers[] = {0, AES_CTR_MAX_WORKERS};
+    for(int w = 0; w < 2; w++){
+        for(int round = 0; round < 4; round++){
+            API_AES_CTR_set_workers(workers[w]);
+            // The split version must give the same output and the same next counter as the serial one
+            for(int i = 0; i < AES_BLOCK_SIZE; i++) counter_serial[i] = counter_parallel[i] = (unsigned char)(0xf0 + i);
+            API_AES_CTR_EncryptDecrypt_ctx(&ctx, plaintext, len, counter_serial, ciphertext_serial);
+            API_AES_CTR_EncryptDecrypt_parallel(&ctx, plaintext, len, counter_parallel, ciphertext_parallel);
+            if(memcmp(ciphertext_serial, ciphertext_parallel, len) != 0) verified = 0;
+            if(memcmp(counter_serial, counter_parallel, AES_BLOCK_SIZE) != 0) verified = 0;
+
+            // In place decryption gives the plaintext back
+            for(int i = 0; i < AES_BLOCK_SIZE; i++) counter_parallel[i] = (unsigned char)(0xf0 + i);
+            API_AES_CTR_EncryptDecrypt_parallel(&ctx, ciphertext_parallel, len, counter_parallel, ciphertext_parallel);
+            if(memcmp(ciphertext_parallel, plaintext, len) != 0) verified = 0;
+        }
+    }
+    API_AES_CTR_set_workers(0);
+
+    memset(&ctx, 0, sizeof(ctx));
+    free(plaintext);
+    free(ciphertext_serial);
+    free(ciphertext_parallel);
+    return verified;
+}
+
+int SFT_AESCTR_256_encrypt_decrypt_compare(unsigned char *input, int len, unsigned char *counter, unsigned char* key , unsigned char* expected_output){
+    unsigned char aux_text[256];
+    unsigned char aux_counter[AES_BLOCK_SIZE];
+    size_t len_size_t = (size_t)(len);  // Convert int to size_t
+
+    memcpy(aux_counter, counter, AES_BLOCK_SIZE); // the counter is updated by the call
+    API_AES_CTR_EncryptDecrypt(input, len_size_t, key, AES_KEY_SIZE_256, aux_counter, aux_text);
+
+    // Compare the encrypted output with the expected output
+    if(memcmp(aux_text, expected_output, len_size_t) == 0){
+        return 1;  // Match found
+    }
+    return 0;  // No match
+}
+
+
+int API_SFT_AES256_CTR_Tests(){
+    int verified = 1;
+
+    if(!SFT_AES256CTR_katTests()){
+        verified = 0;
+    }
+    if(!SFT_AES256CTR_counterTests()){
+        verified = 0;
+    }
+    if(!SFT_AES256CTR_parallelTests()){
+        verified = 0;
+    }
+    return verified;
+}
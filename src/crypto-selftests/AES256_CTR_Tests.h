@@ -0,0 +1,41 @@
+/**
+ * @file AES256_CTR_Tests.h
+ * @brief File containing all the neccesary code to perform the AES-CTR tests.
+ */
+
+#ifndef AESCTRTESTS_H
+#define AESCTRTESTS_H
+#pragma once
+
+
+/****************************************************************************************************************
+ * Compiler include files
+ ****************************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/****************************************************************************************************************
+ * Private include files
+ ****************************************************************************************************************/
+
+#include "../crypto/AES_CTR.h"
+
+
+/****************************************************************************************************************
+ * Function definition zone
+ ****************************************************************************************************************/
+
+int SFT_AESCTR_256_encrypt_decrypt_compare(unsigned char *input, int len, unsigned char *counter, unsigned char* key , unsigned char* expected_output );
+
+int SFT_AES256CTR_katTests();
+
+int SFT_AES256CTR_counterTests();
+
+int SFT_AES256CTR_parallelTests();
+
+int API_SFT_AES256_CTR_Tests();
+
+
+#endif
@@ -0,0 +1,317 @@
+/**
+ * @file AES256_GCM_Tests.c
+ * @brief File containing all the neccesary code to perform the AES-GCM tests.
+ */
+#include "AES256_GCM_Tests.h"
+
+
+int SFT_AES256GCM_katTests(){
+    int verified = 1;
+
+	//# The Galois/Counter Mode of Operation (GCM), McGrew and Viega, AES-256 test cases
+	//# (the same vectors are used by the NIST GCM validation examples)
+
+	//Testing AES GCM number 0, Test Case 13
+	unsigned char key0[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  
+	};
+	unsigned char iv0[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00,  
+	};
+	unsigned int iv_len0 = 12;
+	unsigned char plaintext0[1] = {0};
+	unsigned int len0 = 0;
+	unsigned char aad0[1] = {0};
+	unsigned int aad_len0 = 0;
+	unsigned char ciphertext0[1] = {0};
+	unsigned char tag0[] = {
+	0x53, 0x0f, 0x8a, 0xfb, 0xc7, 0x45, 0x36, 0xb9, 
+	0xa9, 0x63, 0xb4, 0xf1, 0xc4, 0xcb, 0x73, 0x8b,  
+	};
+	if(SFT_AESGCM_256_encrypt_decrypt_compare(plaintext0, len0, iv0, iv_len0, aad0, aad_len0, key0, ciphertext0, tag0 ) == 0) verified = 0;
+
+	//Testing AES GCM number 1, Test Case 14
+	unsigned char key1[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  
+	};
+	unsigned char iv1[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00,  
+	};
+	unsigned int iv_len1 = 12;
+	unsigned char plaintext1[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  
+	};
+	unsigned int len1 = 16;
+	unsigned char aad1[1] = {0};
+	unsigned int aad_len1 = 0;
+	unsigned char ciphertext1[] = {
+	0xce, 0xa7, 0x40, 0x3d, 0x4d, 0x60, 0x6b, 0x6e, 
+	0x07, 0x4e, 0xc5, 0xd3, 0xba, 0xf3, 0x9d, 0x18,  
+	};
+	unsigned char tag1[] = {
+	0xd0, 0xd1, 0xc8, 0xa7, 0x99, 0x99, 0x6b, 0xf0, 
+	0x26, 0x5b, 0x98, 0xb5, 0xd4, 0x8a, 0xb9, 0x19,  
+	};
+	if(SFT_AESGCM_256_encrypt_decrypt_compare(plaintext1, len1, iv1, iv_len1, aad1, aad_len1, key1, ciphertext1, tag1 ) == 0) verified = 0;
+
+	//Testing AES GCM number 2, Test Case 15
+	unsigned char key2[] = {
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08, 
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,  
+	};
+	unsigned char iv2[] = {
+	0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 
+	0xde, 0xca, 0xf8, 0x88,  
+	};
+	unsigned int iv_len2 = 12;
+	unsigned char plaintext2[] = {
+	0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 
+	0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a, 
+	0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 
+	0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72, 
+	0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 
+	0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25, 
+	0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 
+	0xba, 0x63, 0x7b, 0x39, 0x1a, 0xaf, 0xd2, 0x55,  
+	};
+	unsigned int len2 = 64;
+	unsigned char aad2[1] = {0};
+	unsigned int aad_len2 = 0;
+	unsigned char ciphertext2[] = {
+	0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07, 
+	0xf4, 0x7f, 0x37, 0xa3, 0x2a, 0x84, 0x42, 0x7d, 
+	0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9, 
+	0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55, 0xd1, 0xaa, 
+	0x8c, 0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d, 
+	0xa7, 0xb0, 0x8b, 0x10, 0x56, 0x82, 0x88, 0x38, 
+	0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a, 
+	0xbc, 0xc9, 0xf6, 0x62, 0x89, 0x80, 0x15, 0xad,  
+	};
+	unsigned char tag2[] = {
+	0xb0, 0x94, 0xda, 0xc5, 0xd9, 0x34, 0x71, 0xbd, 
+	0xec, 0x1a, 0x50, 0x22, 0x70, 0xe3, 0xcc, 0x6c,  
+	};
+	if(SFT_AESGCM_256_encrypt_decrypt_compare(plaintext2, len2, iv2, iv_len2, aad2, aad_len2, key2, ciphertext2, tag2 ) == 0) verified = 0;
+
+	//Testing AES GCM number 3, Test Case 16
+	unsigned char key3[] = {
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08, 
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,  
+	};
+	unsigned char iv3[] = {
+	0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 
+	0xde, 0xca, 0xf8, 0x88,  
+	};
+	unsigned int iv_len3 = 12;
+	unsigned char plaintext3[] = {
+	0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 
+	0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a, 
+	0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 
+	0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72, 
+	0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 
+	0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25, 
+	0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 
+	0xba, 0x63, 0x7b, 0x39,  
+	};
+	unsigned int len3 = 60;
+	unsigned char aad3[] = {
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 
+	0xab, 0xad, 0xda, 0xd2,  
+	};
+	unsigned int aad_len3 = 20;
+	unsigned char ciphertext3[] = {
+	0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07, 
+	0xf4, 0x7f, 0x37, 0xa3, 0x2a, 0x84, 0x42, 0x7d, 
+	0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9, 
+	0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55, 0xd1, 0xaa, 
+	0x8c, 0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d, 
+	0xa7, 0xb0, 0x8b, 0x10, 0x56, 0x82, 0x88, 0x38, 
+	0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a, 
+	0xbc, 0xc9, 0xf6, 0x62,  
+	};
+	unsigned char tag3[] = {
+	0x76, 0xfc, 0x6e, 0xce, 0x0f, 0x4e, 0x17, 0x68, 
+	0xcd, 0xdf, 0x88, 0x53, 0xbb, 0x2d, 0x55, 0x1b,  
+	};
+	if(SFT_AESGCM_256_encrypt_decrypt_compare(plaintext3, len3, iv3, iv_len3, aad3, aad_len3, key3, ciphertext3, tag3 ) == 0) verified = 0;
+
+	//Testing AES GCM number 4, Test Case 17, 64 bits IV
+	unsigned char key4[] = {
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08, 
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,  
+	};
+	unsigned char iv4[] = {
+	0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad,  
+	};
+	unsigned int iv_len4 = 8;
+	unsigned char plaintext4[] = {
+	0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 
+	0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a, 
+	0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 
+	0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72, 
+	0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 
+	0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25, 
+	0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 
+	0xba, 0x63, 0x7b, 0x39,  
+	};
+	unsigned int len4 = 60;
+	unsigned char aad4[] = {
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 
+	0xab, 0xad, 0xda, 0xd2,  
+	};
+	unsigned int aad_len4 = 20;
+	unsigned char ciphertext4[] = {
+	0xc3, 0x76, 0x2d, 0xf1, 0xca, 0x78, 0x7d, 0x32, 
+	0xae, 0x47, 0xc1, 0x3b, 0xf1, 0x98, 0x44, 0xcb, 
+	0xaf, 0x1a, 0xe1, 0x4d, 0x0b, 0x97, 0x6a, 0xfa, 
+	0xc5, 0x2f, 0xf7, 0xd7, 0x9b, 0xba, 0x9d, 0xe0, 
+	0xfe, 0xb5, 0x82, 0xd3, 0x39, 0x34, 0xa4, 0xf0, 
+	0x95, 0x4c, 0xc2, 0x36, 0x3b, 0xc7, 0x3f, 0x78, 
+	0x62, 0xac, 0x43, 0x0e, 0x64, 0xab, 0xe4, 0x99, 
+	0xf4, 0x7c, 0x9b, 0x1f,  
+	};
+	unsigned char tag4[] = {
+	0x3a, 0x33, 0x7d, 0xbf, 0x46, 0xa7, 0x92, 0xc4, 
+	0x5e, 0x45, 0x49, 0x13, 0xfe, 0x2e, 0xa8, 0xf2,  
+	};
+	if(SFT_AESGCM_256_encrypt_decrypt_compare(plaintext4, len4, iv4, iv_len4, aad4, aad_len4, key4, ciphertext4, tag4 ) == 0) verified = 0;
+
+	//Testing AES GCM number 5, Test Case 18, 480 bits IV
+	unsigned char key5[] = {
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08, 
+	0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 
+	0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,  
+	};
+	unsigned char iv5[] = {
+	0x93, 0x13, 0x22, 0x5d, 0xf8, 0x84, 0x06, 0xe5, 
+	0x55, 0x90, 0x9c, 0x5a, 0xff, 0x52, 0x69, 0xaa, 
+	0x6a, 0x7a, 0x95, 0x38, 0x53, 0x4f, 0x7d, 0xa1, 
+	0xe4, 0xc3, 0x03, 0xd2, 0xa3, 0x18, 0xa7, 0x28, 
+	0xc3, 0xc0, 0xc9, 0x51, 0x56, 0x80, 0x95, 0x39, 
+	0xfc, 0xf0, 0xe2, 0x42, 0x9a, 0x6b, 0x52, 0x54, 
+	0x16, 0xae, 0xdb, 0xf5, 0xa0, 0xde, 0x6a, 0x57, 
+	0xa6, 0x37, 0xb3, 0x9b,  
+	};
+	unsigned int iv_len5 = 60;
+	unsigned char plaintext5[] = {
+	0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 
+	0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a, 
+	0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 
+	0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72, 
+	0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 
+	0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25, 
+	0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 
+	0xba, 0x63, 0x7b, 0x39,  
+	};
+	unsigned int len5 = 60;
+	unsigned char aad5[] = {
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 
+	0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 
+	0xab, 0xad, 0xda, 0xd2,  
+	};
+	unsigned int aad_len5 = 20;
+	unsigned char ciphertext5[] = {
+	0x5a, 0x8d, 0xef, 0x2f, 0x0c, 0x9e, 0x53, 0xf1, 
+	0xf7, 0x5d, 0x78, 0x53, 0x65, 0x9e, 0x2a, 0x20, 
+	0xee, 0xb2, 0xb2, 0x2a, 0xaf, 0xde, 0x64, 0x19, 
+	0xa0, 0x58, 0xab, 0x4f, 0x6f, 0x74, 0x6b, 0xf4, 
+	0x0f, 0xc0, 0xc3, 0xb7, 0x80, 0xf2, 0x44, 0x45, 
+	0x2d, 0xa3, 0xeb, 0xf1, 0xc5, 0xd8, 0x2c, 0xde, 
+	0xa2, 0x41, 0x89, 0x97, 0x20, 0x0e, 0xf8, 0x2e, 
+	0x44, 0xae, 0x7e, 0x3f,  
+	};
+	unsigned char tag5[] = {
+	0xa4, 0x4a, 0x82, 0x66, 0xee, 0x1c, 0x8e, 0xb0, 
+	0xc8, 0xb5, 0xd4, 0xcf, 0x5a, 0xe9, 0xf1, 0x9a,  
+	};
+	if(SFT_AESGCM_256_encrypt_decrypt_compare(plaintext5, len5, iv5, iv_len5, aad5, aad_len5, key5, ciphertext5, tag5 ) == 0) verified = 0;
+
+    return verified;
+}
+
+int SFT_AES256GCM_authTests(){
+    int verified = 1;
+    unsigned char key[AES_KEY_SIZE_256], iv[AES_GCM_IV_SIZE], aad[20], tag[AES_GCM_TAG_SIZE];
+    unsigned char plaintext[1000], ciphertext[1000], decrypted[1000];
+
+    for(int i = 0; i < AES_KEY_SIZE_256; i++) key[i] = (unsigned char)(0x5a ^ i);
+    for(int i = 0; i < AES_GCM_IV_SIZE; i++) iv[i] = (unsigned char)(i * 7);
+    for(int i = 0; i < 20; i++) aad[i] = (unsigned char)(0xc3 + i);
+    for(int i = 0; i < 1000; i++) plaintext[i] = (unsigned char)(i * 13 + 1);
+
+    // Several chunks and a partial last block, the round trip must give the plaintext back
+    API_AES_GCM_encrypt(plaintext, 1000, key, AES_KEY_SIZE_256, iv, AES_GCM_IV_SIZE, aad, 20, ciphertext, tag);
+    if(API_AES_GCM_decrypt(ciphertext, 1000, key, AES_KEY_SIZE_256, iv, AES_GCM_IV_SIZE, aad, 20, tag, AES_GCM_TAG_SIZE, decrypted) != AES_GCM_TAG_OK) verified = 0;
+    if(memcmp(decrypted, plaintext, 1000) != 0) verified = 0;
+
+    // A modified ciphertext, additional data or tag must be rejected and the output zeroized
+    ciphertext[517] ^= 0x01;
+    if(API_AES_GCM_decrypt(ciphertext, 1000, key, AES_KEY_SIZE_256, iv, AES_GCM_IV_SIZE, aad, 20, tag, AES_GCM_TAG_SIZE, decrypted) != AES_GCM_TAG_NOT_VERIFIED) verified = 0;
+    for(int i = 0; i < 1000; i++) if(decrypted[i] != 0) verified = 0;
+    ciphertext[517] ^= 0x01;
+    aad[3] ^= 0x80;
+    if(API_AES_GCM_decrypt(ciphertext, 1000, key, AES_KEY_SIZE_256, iv, AES_GCM_IV_SIZE, aad, 20, tag, AES_GCM_TAG_SIZE, decrypted) != AES_GCM_TAG_NOT_VERIFIED) verified = 0;
+    aad[3] ^= 0x80;
+    tag[15] ^= 0x01;
+    if(API_AES_GCM_decrypt(ciphertext, 1000, key, AES_KEY_SIZE_256, iv, AES_GCM_IV_SIZE, aad, 20, tag, AES_GCM_TAG_SIZE, decrypted) != AES_GCM_TAG_NOT_VERIFIED) verified = 0;
+
+    // Truncated tags are accepted down to AES_GCM_MIN_TAG_SIZE bytes only
+    tag[15] ^= 0x01;
+    if(API_AES_GCM_decrypt(ciphertext, 1000, key, AES_KEY_SIZE_256, iv, AES_GCM_IV_SIZE, aad, 20, tag, AES_GCM_MIN_TAG_SIZE, decrypted) != AES_GCM_TAG_OK) verified = 0;
+    if(API_AES_GCM_decrypt(ciphertext, 1000, key, AES_KEY_SIZE_256, iv, AES_GCM_IV_SIZE, aad, 20, tag, AES_GCM_MIN_TAG_SIZE - 1, decrypted) != AES_GCM_TAG_NOT_VERIFIED) verified = 0;
+    if(API_AES_GCM_decrypt(ciphertext, 1000, key, AES_KEY_SIZE_256, iv, AES_GCM_IV_SIZE, aad, 20, tag, 1, decrypted) != AES_GCM_TAG_NOT_VERIFIED) verified = 0;
+
+    return verified;
+}
+
+int SFT_AESGCM_256_encrypt_decrypt_compare(unsigned char *input, int len, unsigned char *iv, int iv_len, unsigned char *aad, int aad_len, unsigned char* key , unsigned char* expected_output, unsigned char* expected_tag){
+    unsigned char aux_text[256];
+    unsigned char aux_tag[AES_GCM_TAG_SIZE];
+    size_t len_size_t = (size_t)(len);  // Convert int to size_t
+
+    // Encrypt and compare the ciphertext and the tag with the expected ones
+    API_AES_GCM_encrypt(input, len_size_t, key, AES_KEY_SIZE_256, iv, (size_t)iv_len, aad, (size_t)aad_len, aux_text, aux_tag);
+    if(memcmp(aux_text, expected_output, len_size_t) != 0 || memcmp(aux_tag, expected_tag, AES_GCM_TAG_SIZE) != 0){
+        return 0;  // No match
+    }
+
+    // Decrypt the expected ciphertext, the tag must be verified and the plaintext recovered
+    if(API_AES_GCM_decrypt(expected_output, len_size_t, key, AES_KEY_SIZE_256, iv, (size_t)iv_len, aad, (size_t)aad_len, expected_tag, AES_GCM_TAG_SIZE, aux_text) != AES_GCM_TAG_OK){
+        return 0;
+    }
+    if(memcmp(aux_text, input, len_size_t) != 0){
+        return 0;
+    }
+    return 1;  // Match found
+}
+
+
+int API_SFT_AES256_GCM_Tests(){
+    int verified = 1;
+
+    if(!SFT_AES256GCM_katTests()){
+        verified = 0;
+    }
+    if(!SFT_AES256GCM_authTests()){
+        verified = 0;
+    }
+    return verified;
+}
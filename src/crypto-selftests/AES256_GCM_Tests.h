@@ -0,0 +1,39 @@
+/**
+ * @file AES256_GCM_Tests.h
+ * @brief File containing all the neccesary code to perform the AES-GCM tests.
+ */
+
+#ifndef AESGCMTESTS_H
+#define AESGCMTESTS_H
+#pragma once
+
+
+/****************************************************************************************************************
+ * Compiler include files
+ ****************************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/****************************************************************************************************************
+ * Private include files
+ ****************************************************************************************************************/
+
+#include "../crypto/AES_GCM.h"
+
+
+/****************************************************************************************************************
+ * Function definition zone
+ ****************************************************************************************************************/
+
+int SFT_AESGCM_256_encrypt_decrypt_compare(unsigned char *input, int len, unsigned char *iv, int iv_len, unsigned char *aad, int aad_len, unsigned char* key , unsigned char* expected_output, unsigned char* expected_tag );
+
+int SFT_AES256GCM_katTests();
+
+int SFT_AES256GCM_authTests();
+
+int API_SFT_AES256_GCM_Tests();
+
+
+#endif
@@ -0,0 +1,267 @@
+/**
+ * @file CHACHA20_POLY1305_Tests.c
+ * @brief File containing all the neccesary code to perform the ChaCha20-Poly1305 tests.
+ */
+#include "CHACHA20_POLY1305_Tests.h"
+
+
+int SFT_CHACHA20_katTests(){
+    int verified = 1;
+    unsigned char aux_text[256];
+
+	//# RFC 8439, 2.4.2. Example and Test Vector for the ChaCha20 Cipher
+	unsigned char key0[] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 
+	0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 
+	};
+	unsigned char nonce0[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a, 
+	0x00, 0x00, 0x00, 0x00, 
+	};
+	unsigned char *plaintext0 = (unsigned char *)"Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+	unsigned int len0 = 114;
+	unsigned char ciphertext0[] = {
+	0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 
+	0x41, 0xba, 0x07, 0x28, 0xdd, 0x0d, 0x69, 0x81, 
+	0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2, 
+	0x0a, 0x27, 0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b, 
+	0xf9, 0x1b, 0x65, 0xc5, 0x52, 0x47, 0x33, 0xab, 
+	0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57, 
+	0x16, 0x39, 0xd6, 0x24, 0xe6, 0x51, 0x52, 0xab, 
+	0x8f, 0x53, 0x0c, 0x35, 0x9f, 0x08, 0x61, 0xd8, 
+	0x07, 0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61, 
+	0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22, 0xb6, 0x5e, 
+	0x52, 0xbc, 0x51, 0x4d, 0x16, 0xcc, 0xf8, 0x06, 
+	0x81, 0x8c, 0xe9, 0x1a, 0xb7, 0x79, 0x37, 0x36, 
+	0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6, 
+	0xb4, 0x0b, 0x8e, 0xed, 0xf2, 0x78, 0x5e, 0x42, 
+	0x87, 0x4d, 
+	};
+	API_CHACHA20_encrypt(key0, 1, nonce0, plaintext0, len0, aux_text);
+	if(memcmp(aux_text, ciphertext0, len0) != 0) verified = 0;
+
+	//# RFC 8439, 2.5.2. Test Vector for Poly1305
+	unsigned char key1[] = {
+	0x85, 0xd6, 0xbe, 0x78, 0x57, 0x55, 0x6d, 0x33, 
+	0x7f, 0x44, 0x52, 0xfe, 0x42, 0xd5, 0x06, 0xa8, 
+	0x01, 0x03, 0x80, 0x8a, 0xfb, 0x0d, 0xb2, 0xfd, 
+	0x4a, 0xbf, 0xf6, 0xaf, 0x41, 0x49, 0xf5, 0x1b, 
+	};
+	unsigned char *message1 = (unsigned char *)"Cryptographic Forum Research Group";
+	unsigned int len1 = 34;
+	unsigned char tag1[] = {
+	0xa8, 0x06, 0x1d, 0xc1, 0x30, 0x51, 0x36, 0xc6, 
+	0xc2, 0x2b, 0x8b, 0xaf, 0x0c, 0x01, 0x27, 0xa9, 
+	};
+	API_POLY1305_mac(key1, message1, len1, aux_text);
+	if(memcmp(aux_text, tag1, POLY1305_TAG_SIZE) != 0) verified = 0;
+
+	//# RFC 8439, 2.8.2. Example and Test Vector for AEAD_CHACHA20_POLY1305
+	unsigned char key2[] = {
+	0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 
+	0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 
+	0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 
+	0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f, 
+	};
+	unsigned char nonce2[] = {
+	0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 
+	0x44, 0x45, 0x46, 0x47, 
+	};
+	unsigned char aad2[] = {
+	0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 
+	0xc4, 0xc5, 0xc6, 0xc7, 
+	};
+	unsigned char *plaintext2 = (unsigned char *)"Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+	unsigned int len2 = 114;
+	unsigned char ciphertext2[] = {
+	0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 
+	0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2, 
+	0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 
+	0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6, 
+	0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 
+	0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b, 
+	0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 
+	0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36, 
+	0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 
+	0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58, 
+	0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 
+	0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc, 
+	0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 
+	0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b, 
+	0x61, 0x16, 
+	};
+	unsigned char tag2[] = {
+	0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 
+	0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91, 
+	};
+	if(SFT_CHACHA20_POLY1305_encrypt_decrypt_compare(plaintext2, len2, nonce2, aad2, 12, key2, ciphertext2, tag2) == 0) verified = 0;
+
+	//# RFC 8439, A.5. ChaCha20-Poly1305 AEAD Decryption
+	unsigned char key3[] = {
+	0x1c, 0x92, 0x40, 0xa5, 0xeb, 0x55, 0xd3, 0x8a, 
+	0xf3, 0x33, 0x88, 0x86, 0x04, 0xf6, 0xb5, 0xf0, 
+	0x47, 0x39, 0x17, 0xc1, 0x40, 0x2b, 0x80, 0x09, 
+	0x9d, 0xca, 0x5c, 0xbc, 0x20, 0x70, 0x75, 0xc0, 
+	};
+	unsigned char nonce3[] = {
+	0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 
+	0x05, 0x06, 0x07, 0x08, 
+	};
+	unsigned char aad3[] = {
+	0xf3, 0x33, 0x88, 0x86, 0x00, 0x00, 0x00, 0x00, 
+	0x00, 0x00, 0x4e, 0x91, 
+	};
+	unsigned char plaintext3[] = {
+	0x49, 0x6e, 0x74, 0x65, 0x72, 0x6e, 0x65, 0x74, 
+	0x2d, 0x44, 0x72, 0x61, 0x66, 0x74, 0x73, 0x20, 
+	0x61, 0x72, 0x65, 0x20, 0x64, 0x72, 0x61, 0x66, 
+	0x74, 0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 
+	0x6e, 0x74, 0x73, 0x20, 0x76, 0x61, 0x6c, 0x69, 
+	0x64, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x61, 0x20, 
+	0x6d, 0x61, 0x78, 0x69, 0x6d, 0x75, 0x6d, 0x20, 
+	0x6f, 0x66, 0x20, 0x73, 0x69, 0x78, 0x20, 0x6d, 
+	0x6f, 0x6e, 0x74, 0x68, 0x73, 0x20, 0x61, 0x6e, 
+	0x64, 0x20, 0x6d, 0x61, 0x79, 0x20, 0x62, 0x65, 
+	0x20, 0x75, 0x70, 0x64, 0x61, 0x74, 0x65, 0x64, 
+	0x2c, 0x20, 0x72, 0x65, 0x70, 0x6c, 0x61, 0x63, 
+	0x65, 0x64, 0x2c, 0x20, 0x6f, 0x72, 0x20, 0x6f, 
+	0x62, 0x73, 0x6f, 0x6c, 0x65, 0x74, 0x65, 0x64, 
+	0x20, 0x62, 0x79, 0x20, 0x6f, 0x74, 0x68, 0x65, 
+	0x72, 0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 
+	0x6e, 0x74, 0x73, 0x20, 0x61, 0x74, 0x20, 0x61, 
+	0x6e, 0x79, 0x20, 0x74, 0x69, 0x6d, 0x65, 0x2e, 
+	0x20, 0x49, 0x74, 0x20, 0x69, 0x73, 0x20, 0x69, 
+	0x6e, 0x61, 0x70, 0x70, 0x72, 0x6f, 0x70, 0x72, 
+	0x69, 0x61, 0x74, 0x65, 0x20, 0x74, 0x6f, 0x20, 
+	0x75, 0x73, 0x65, 0x20, 0x49, 0x6e, 0x74, 0x65, 
+	0x72, 0x6e, 0x65, 0x74, 0x2d, 0x44, 0x72, 0x61, 
+	0x66, 0x74, 0x73, 0x20, 0x61, 0x73, 0x20, 0x72, 
+	0x65, 0x66, 0x65, 0x72, 0x65, 0x6e, 0x63, 0x65, 
+	0x20, 0x6d, 0x61, 0x74, 0x65, 0x72, 0x69, 0x61, 
+	0x6c, 0x20, 0x6f, 0x72, 0x20, 0x74, 0x6f, 0x20, 
+	0x63, 0x69, 0x74, 0x65, 0x20, 0x74, 0x68, 0x65, 
+	0x6d, 0x20, 0x6f, 0x74, 0x68, 0x65, 0x72, 0x20, 
+	0x74, 0x68, 0x61, 0x6e, 0x20, 0x61, 0x73, 0x20, 
+	0x2f, 0xe2, 0x80, 0x9c, 0x77, 0x6f, 0x72, 0x6b, 
+	0x20, 0x69, 0x6e, 0x20, 0x70, 0x72, 0x6f, 0x67, 
+	0x72, 0x65, 0x73, 0x73, 0x2e, 0x2f, 0xe2, 0x80, 
+	0x9d, 
+	};
+	unsigned int len3 = 265;
+	unsigned char ciphertext3[] = {
+	0x64, 0xa0, 0x86, 0x15, 0x75, 0x86, 0x1a, 0xf4, 
+	0x60, 0xf0, 0x62, 0xc7, 0x9b, 0xe6, 0x43, 0xbd, 
+	0x5e, 0x80, 0x5c, 0xfd, 0x34, 0x5c, 0xf3, 0x89, 
+	0xf1, 0x08, 0x67, 0x0a, 0xc7, 0x6c, 0x8c, 0xb2, 
+	0x4c, 0x6c, 0xfc, 0x18, 0x75, 0x5d, 0x43, 0xee, 
+	0xa0, 0x9e, 0xe9, 0x4e, 0x38, 0x2d, 0x26, 0xb0, 
+	0xbd, 0xb7, 0xb7, 0x3c, 0x32, 0x1b, 0x01, 0x00, 
+	0xd4, 0xf0, 0x3b, 0x7f, 0x35, 0x58, 0x94, 0xcf, 
+	0x33, 0x2f, 0x83, 0x0e, 0x71, 0x0b, 0x97, 0xce, 
+	0x98, 0xc8, 0xa8, 0x4a, 0xbd, 0x0b, 0x94, 0x81, 
+	0x14, 0xad, 0x17, 0x6e, 0x00, 0x8d, 0x33, 0xbd, 
+	0x60, 0xf9, 0x82, 0xb1, 0xff, 0x37, 0xc8, 0x55, 
+	0x97, 0x97, 0xa0, 0x6e, 0xf4, 0xf0, 0xef, 0x61, 
+	0xc1, 0x86, 0x32, 0x4e, 0x2b, 0x35, 0x06, 0x38, 
+	0x36, 0x06, 0x90, 0x7b, 0x6a, 0x7c, 0x02, 0xb0, 
+	0xf9, 0xf6, 0x15, 0x7b, 0x53, 0xc8, 0x67, 0xe4, 
+	0xb9, 0x16, 0x6c, 0x76, 0x7b, 0x80, 0x4d, 0x46, 
+	0xa5, 0x9b, 0x52, 0x16, 0xcd, 0xe7, 0xa4, 0xe9, 
+	0x90, 0x40, 0xc5, 0xa4, 0x04, 0x33, 0x22, 0x5e, 
+	0xe2, 0x82, 0xa1, 0xb0, 0xa0, 0x6c, 0x52, 0x3e, 
+	0xaf, 0x45, 0x34, 0xd7, 0xf8, 0x3f, 0xa1, 0x15, 
+	0x5b, 0x00, 0x47, 0x71, 0x8c, 0xbc, 0x54, 0x6a, 
+	0x0d, 0x07, 0x2b, 0x04, 0xb3, 0x56, 0x4e, 0xea, 
+	0x1b, 0x42, 0x22, 0x73, 0xf5, 0x48, 0x27, 0x1a, 
+	0x0b, 0xb2, 0x31, 0x60, 0x53, 0xfa, 0x76, 0x99, 
+	0x19, 0x55, 0xeb, 0xd6, 0x31, 0x59, 0x43, 0x4e, 
+	0xce, 0xbb, 0x4e, 0x46, 0x6d, 0xae, 0x5a, 0x10, 
+	0x73, 0xa6, 0x72, 0x76, 0x27, 0x09, 0x7a, 0x10, 
+	0x49, 0xe6, 0x17, 0xd9, 0x1d, 0x36, 0x10, 0x94, 
+	0xfa, 0x68, 0xf0, 0xff, 0x77, 0x98, 0x71, 0x30, 
+	0x30, 0x5b, 0xea, 0xba, 0x2e, 0xda, 0x04, 0xdf, 
+	0x99, 0x7b, 0x71, 0x4d, 0x6c, 0x6f, 0x2c, 0x29, 
+	0xa6, 0xad, 0x5c, 0xb4, 0x02, 0x2b, 0x02, 0x70, 
+	0x9b, 
+	};
+	unsigned char tag3[] = {
+	0xee, 0xad, 0x9d, 0x67, 0x89, 0x0c, 0xbb, 0x22, 
+	0x39, 0x23, 0x36, 0xfe, 0xa1, 0x85, 0x1f, 0x38, 
+	};
+	if(SFT_CHACHA20_POLY1305_encrypt_decrypt_compare(plaintext3, len3, nonce3, aad3, 12, key3, ciphertext3, tag3) == 0) verified = 0;
+
+    return verified;
+}
+
+int SFT_CHACHA20_POLY1305_authTests(){
+    int verified = 1;
+    unsigned char key[CHACHA20_KEY_SIZE], nonce[CHACHA20_NONCE_SIZE], aad[20], tag[POLY1305_TAG_SIZE];
+    unsigned char plaintext[1000], ciphertext[1000], decrypted[1000];
+
+    for(int i = 0; i < CHACHA20_KEY_SIZE; i++) key[i] = (unsigned char)(0x5a ^ i);
+    for(int i = 0; i < CHACHA20_NONCE_SIZE; i++) nonce[i] = (unsigned char)(i * 7);
+    for(int i = 0; i < 20; i++) aad[i] = (unsigned char)(0xc3 + i);
+    for(int i = 0; i < 1000; i++) plaintext[i] = (unsigned char)(i * 13 + 1);
+
+    // The multi-block kernels (8 and 4 blocks per pass) must give the same keystream as the one block function
+    API_CHACHA20_encrypt(key, 7, nonce, plaintext, 1000, ciphertext);
+    for(int i = 0; i < 1000; i += CHACHA20_BLOCK_SIZE){
+        int n = (1000 - i < CHACHA20_BLOCK_SIZE) ? 1000 - i : CHACHA20_BLOCK_SIZE;
+        API_CHACHA20_encrypt(key, 7 + i / CHACHA20_BLOCK_SIZE, nonce, plaintext + i, n, decrypted + i);
+    }
+    if(memcmp(decrypted, ciphertext, 1000) != 0) verified = 0;
+
+    // Several chunks and a partial last block, the round trip must give the plaintext back
+    API_CHACHA20_POLY1305_encrypt(key, nonce, aad, 20, plaintext, 1000, ciphertext, tag);
+    if(API_CHACHA20_POLY1305_decrypt(key, nonce, aad, 20, ciphertext, 1000, tag, decrypted) != CHACHA20_POLY1305_TAG_OK) verified = 0;
+    if(memcmp(decrypted, plaintext, 1000) != 0) verified = 0;
+
+    // A modified ciphertext, additional data or tag must be rejected and the output zeroized
+    ciphertext[517] ^= 0x01;
+    if(API_CHACHA20_POLY1305_decrypt(key, nonce, aad, 20, ciphertext, 1000, tag, decrypted) != CHACHA20_POLY1305_TAG_NOT_VERIFIED) verified = 0;
+    for(int i = 0; i < 1000; i++) if(decrypted[i] != 0) verified = 0;
+    ciphertext[517] ^= 0x01;
+    aad[3] ^= 0x80;
+    if(API_CHACHA20_POLY1305_decrypt(key, nonce, aad, 20, ciphertext, 1000, tag, decrypted) != CHACHA20_POLY1305_TAG_NOT_VERIFIED) verified = 0;
+    aad[3] ^= 0x80;
+    tag[15] ^= 0x01;
+    if(API_CHACHA20_POLY1305_decrypt(key, nonce, aad, 20, ciphertext, 1000, tag, decrypted) != CHACHA20_POLY1305_TAG_NOT_VERIFIED) verified = 0;
+
+    return verified;
+}
+
+int SFT_CHACHA20_POLY1305_encrypt_decrypt_compare(unsigned char *input, int len, unsigned char *nonce, unsigned char *aad, int aad_len, unsigned char* key , unsigned char* expected_output, unsigned char* expected_tag){
+    unsigned char aux_text[512];
+    unsigned char aux_tag[POLY1305_TAG_SIZE];
+    size_t len_size_t = (size_t)(len);  // Convert int to size_t
+
+    // Encrypt and compare the ciphertext and the tag with the expected ones
+    API_CHACHA20_POLY1305_encrypt(key, nonce, aad, (size_t)aad_len, input, len_size_t, aux_text, aux_tag);
+    if(memcmp(aux_text, expected_output, len_size_t) != 0 || memcmp(aux_tag, expected_tag, POLY1305_TAG_SIZE) != 0){
+        return 0;  // No match
+    }
+
+    // Decrypt the expected ciphertext, the tag must be verified and the plaintext recovered
+    if(API_CHACHA20_POLY1305_decrypt(key, nonce, aad, (size_t)aad_len, expected_output, len_size_t, expected_tag, aux_text) != CHACHA20_POLY1305_TAG_OK){
+        return 0;
+    }
+    if(memcmp(aux_text, input, len_size_t) != 0){
+        return 0;
+    }
+    return 1;  // Match found
+}
+
+
+int API_SFT_CHACHA20_POLY1305_Tests(){
+    int verified = 1;
+
+    if(!SFT_CHACHA20_katTests()){
+        verified = 0;
+    }
+    if(!SFT_CHACHA20_POLY1305_authTests()){
+        verified = 0;
+    }
+    return verified;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file CHACHA20_POLY1305_Tests.h
+ * @brief File containing all the neccesary code to perform the ChaCha20-Poly1305 tests (RFC 8439 test vectors).
+ */
+
+#ifndef CHACHA20POLY1305TESTS_H
+#define CHACHA20POLY1305TESTS_H
+#pragma once
+
+
+/****************************************************************************************************************
+ * Compiler include files
+ ****************************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/****************************************************************************************************************
+ * Private include files
+ ****************************************************************************************************************/
+
+#include "../crypto/CHACHA20_POLY1305.h"
+
+
+/****************************************************************************************************************
+ * Function definition zone
+ ****************************************************************************************************************/
+
+int SFT_CHACHA20_POLY1305_encrypt_decrypt_compare(unsigned char *input, int len, unsigned char *nonce, unsigned char *aad, int aad_len, unsigned char* key , unsigned char* expected_output, unsigned char* expected_tag );
+
+int SFT_CHACHA20_katTests();
+
+int SFT_CHACHA20_POLY1305_authTests();
+
+int API_SFT_CHACHA20_POLY1305_Tests();
+
+
+#endif
@@ -37,6 +37,43 @@ int SFT_ECDSA256_verify_test(unsigned char *Qx, size_t Qx_length, unsigned char
 	return result;
 }
 
+int SFT_ECDSA256_batch_test()
+{
+	uint8_t pub[2][32 + 1], priv[2][32];
+	uint8_t hash[6][32], sign[6][32 * 2];
+	const uint8_t *keys[6], *hashes[6], *signs[6];
+	uint8_t results[6];
+	ECDSA_CTX ctx;
+	int i;
+
+	if(!ecc_make_key(pub[0], priv[0]) || !ecc_make_key(pub[1], priv[1])){
+		return 0;
+	}
+	// Six items with two keys, the fifth one has a modified hash. The second key signs with a caller context
+	for(i = 0; i < 6; i++){
+		unsigned char msg = (unsigned char)i;
+		API_sha256(&msg, 1, hash[i]);
+		if(!((i % 2) ? ecdsa_sign_ctx(&ctx, priv[1], hash[i], sign[i]) : ecdsa_sign(priv[0], hash[i], sign[i]))){
+			return 0;
+		}
+		keys[i] = pub[i % 2];
+		hashes[i] = hash[i];
+		signs[i] = sign[i];
+	}
+	hash[4][0] ^= 1;
+	memset(priv, 0, sizeof(priv));
+
+	if(API_ecdsa_verify_batch(keys, hashes, signs, 6, results) != 0){
+		return 0;
+	}
+	for(i = 0; i < 6; i++){
+		if(results[i] != (i != 4) || results[i] != API_ecdsa_verify(keys[i], hashes[i], signs[i])){
+			return 0;
+		}
+	}
+	return 1;
+}
+
 int API_SFT_ECDSA256_SHA256_Tests()
 {
     int verified = 1;
@@ -792,5 +829,14 @@ int API_SFT_ECDSA256_SHA256_Tests()
 		verified = 0;
 	}
 	
+	if(SFT_ECDSA256_batch_test() != 1){
+		verified = 0;
+	}
+
+	// Constant time inverses against the binary extended Euclidean algorithm
+	if(API_ECDSA_inverse_selftest() != 1){
+		verified = 0;
+	}
+
     return verified;
 }
@@ -41,6 +41,14 @@
  */
 int SFT_ECDSA256_verify_test(unsigned char *Qx, size_t Qx_length, unsigned char *Qy, size_t Qy_length, unsigned char *ECDSA_msg, int ECDSA_msg_len, unsigned char *r, size_t r_length,unsigned char *s, size_t s_length);
 
+/**
+ * @brief Signs six messages with two generated keys (ecdsa_sign and ecdsa_sign_ctx), alters one of them and checks that API_ecdsa_verify_batch reports exactly that item as failed, like API_ecdsa_verify.
+ * 
+ * 
+ * @return Returns 1 if the test is passed, 0 if not
+*/
+int SFT_ECDSA256_batch_test();
+
 /**
  * @brief The function initiates the ECDSA test verifiying all the hardcoded NIST test-vectors, if a single verification fails, the test fails
  * 
@@ -3453,11 +3453,77 @@ int API_SFT_HMAC256_SHA256_Test(){
 	if(SFT_HMAC_Compare(key74, kLen74, msg74, 128, mac74, tLen74) != 1){
 		verified = 0;
 	}
+	if(SFT_HMAC_manyTest(key74, kLen74) != 1){
+		verified = 0;
+	}
+	if(SFT_HMAC_streamTest(key74, kLen74) != 1){
+		verified = 0;
+	}
 	
 
 	return verified;
 }
 
+int SFT_HMAC_manyTest(unsigned char *key, int lenKey)
+{
+	static const size_t lengths[20] = {0, 1, 31, 32, 55, 56, 64, 65, 100, 128, 200, 256, 300, 511, 512, 700, 1000, 1024, 9, 77};
+	unsigned char buffer[1024];
+	unsigned char macs[20][SHA256_HASH_SIZE];
+	unsigned char *msgs[20], *out[20];
+	unsigned char mac[SHA256_HASH_SIZE];
+	HMAC_SHA256_MIDSTATE midstate;
+	int verified = 1;
+
+	for(int i = 0; i < 1024; i++) buffer[i] = (unsigned char)(i * 13 + 5);
+	for(int i = 0; i < 20; i++){
+		msgs[i] = buffer;
+		out[i] = macs[i];
+	}
+
+	// Every HMAC of the batch and from the key midstates must be the same as the single message one
+	API_hmac_sha256_many(key, lenKey, msgs, lengths, 20, out);
+	API_hmac_sha256_precompute(key, lenKey, &midstate);
+	for(int i = 0; i < 20; i++){
+		API_hmac_sha256_midstate(&midstate, msgs[i], lengths[i], mac);
+		if(memcmp(API_hmac_sha256(key, lenKey, msgs[i], (int)lengths[i]), macs[i], SHA256_HASH_SIZE) != 0 || memcmp(mac, macs[i], SHA256_HASH_SIZE) != 0){
+			verified = 0;
+		}
+		if(API_verify_HMAC_midstate(&midstate, msgs[i], macs[i], lengths[i], SHA256_HASH_SIZE) != MAC_VERIFIED){
+			verified = 0;
+		}
+	}
+	return verified;
+}
+
+int SFT_HMAC_streamTest(unsigned char *key, int lenKey)
+{
+	static const size_t pieces[9] = {1, 7, 55, 64, 3, 128, 61, 200, 5};
+	unsigned char buffer[524];
+	unsigned char mac[SHA256_HASH_SIZE];
+	HMAC_SHA256_CTX ctx1, ctx2;
+	size_t offset = 0;
+	int verified = 1;
+
+	for(int i = 0; i < 524; i++) buffer[i] = (unsigned char)(i * 29 + 3);
+
+	// Two interleaved contexts, one fed in pieces of different lengths and the other at once
+	API_hmac_sha256_init(&ctx1, key, lenKey);
+	API_hmac_sha256_init(&ctx2, key, lenKey);
+	for(int i = 0; i < 9; i++){
+		API_hmac_sha256_update(&ctx1, buffer + offset, pieces[i]);
+		offset += pieces[i];
+	}
+	API_hmac_sha256_update(&ctx2, buffer, offset);
+	API_hmac_sha256_final(&ctx1, mac);
+	if(memcmp(API_hmac_sha256(key, lenKey, buffer, (int)offset), mac, SHA256_HASH_SIZE) != 0){
+		verified = 0;
+	}
+	if(API_hmac_sha256_final_verify(&ctx2, mac, SHA256_HASH_SIZE) != MAC_VERIFIED){
+		verified = 0;
+	}
+	return verified;
+}
+
 int SFT_HMAC_Compare(unsigned char *key, int lenKey, unsigned char *msg, int lenMsg, unsigned char *mac, int lenMac)
 {
 	uint8_t result;
@@ -47,4 +47,27 @@ int SFT_HMAC_Compare(unsigned char *key, int lenKey, unsigned char *msg, int len
 */
 int API_SFT_HMAC256_SHA256_Test();
 
+/**
+ * @brief Checks the batch HMAC (API_hmac_sha256_many) and the HMAC from the key midstates (API_hmac_sha256_midstate)
+ * against API_hmac_sha256 with messages of different lengths
+ * 
+ * 
+ * @param key Key used to authenticate the messages
+ * @param lenKey Length of the key
+ * 
+ * @return Returns 1 if every MAC matches, 0 if not
+*/
+int SFT_HMAC_manyTest(unsigned char *key, int lenKey);
+
+/**
+ * @brief Checks the streaming HMAC (API_hmac_sha256_init/update/final) against API_hmac_sha256, feeding the message
+ * in pieces of different lengths to one context while another context is in use
+ * 
+ * @param key Key used to authenticate the message
+ * @param lenKey Length of the key
+ * 
+ * @return Returns 1 if the MACs match, 0 if not
+*/
+int SFT_HMAC_streamTest(unsigned char *key, int lenKey);
+
 #endif
\ No newline at end of file
@@ -1187,9 +1187,45 @@ int API_SFT_SHA256Tests()
         aux = 0;
     }
 
+    if (!SFT_SHA256_manyTest())
+    {
+        aux = 0;
+    }
+
     return aux;
 }
 
+int SFT_SHA256_manyTest()
+{
+    // Lengths around the padding limits and longer messages, more messages than lanes so the lanes are refilled
+    static const size_t lengths[24] = {0, 1, 3, 55, 56, 57, 63, 64, 65, 100, 119, 120, 127, 128, 129, 200, 255, 256, 511, 1000, 1024, 2047, 33, 4096};
+    unsigned char buffer[4096];
+    unsigned char hashes[24][SHA256_BLOCK_SIZE];
+    unsigned char expected[SHA256_BLOCK_SIZE];
+    unsigned char *msgs[24], *out[24];
+    int verified = 1;
+
+    for (int i = 0; i < 4096; i++)
+        buffer[i] = (unsigned char)(i * 31 + 7);
+    for (int i = 0; i < 24; i++)
+    {
+        msgs[i] = buffer + (i * 17) % 64; // different alignments
+        if (lengths[i] + (i * 17) % 64 > sizeof(buffer))
+            msgs[i] = buffer;
+        out[i] = hashes[i];
+    }
+
+    // Every hash of the multi-buffer engine must be the same as the single message one
+    API_sha256_many(msgs, lengths, 24, out);
+    for (int i = 0; i < 24; i++)
+    {
+        API_sha256(msgs[i], (int)lengths[i], expected);
+        if (memcmp(expected, hashes[i], SHA256_BLOCK_SIZE) != 0)
+            verified = 0;
+    }
+    return verified;
+}
+
 int SFT_SHA256compare(unsigned char *hashvector1, int msglength, unsigned char *hashvector2)
 {
     unsigned char hash_out[32];
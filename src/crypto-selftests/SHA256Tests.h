@@ -44,6 +44,14 @@ int SFT_SHA256compare(unsigned char *hashvector1, int msglength, unsigned char *
 */
 int API_SFT_SHA256Tests();
 
+/**
+ * @brief Checks the multi-buffer engine (API_sha256_many) against API_sha256 with a batch of messages of different lengths
+ * 
+ * 
+ * @return Returns 1 if every hash matches, 0 if not
+*/
+int SFT_SHA256_manyTest();
+
 
 /**
  * @brief Puts an array of equal length of the number of test vectors to 1
@@ -42,6 +42,18 @@ int API_SFT_initSelfTests() // FALTA POR IMPLEMENTAR EL TEST DE INTEGRIDAD, HACE
     {
         return SFT_AES256_OFB_SELFTEST_FAILED;
     }
+    if(!API_SFT_AES256_CTR_Tests()) // AESCTR256 selftests starts
+    {
+        return SFT_AES256_CTR_SELFTEST_FAILED;
+    }
+    if(!API_SFT_AES256_GCM_Tests()) // AESGCM256 selftests starts
+    {
+        return SFT_AES256_GCM_SELFTEST_FAILED;
+    }
+    if(!API_SFT_CHACHA20_POLY1305_Tests()) // CHACHA20-POLY1305 selftests starts
+    {
+        return SFT_CHACHA20_POLY1305_SELFTEST_FAILED;
+    }
     if(!API_SFT_check_module_integrity()){
         return SFT_MODULE_INTEGRITY_SELFTEST_FAILED;
     }
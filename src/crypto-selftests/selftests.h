@@ -23,6 +23,9 @@
 #include "ECDSA256Tests.h"
 #include "AES256_CBC_Tests.h"
 #include "AES256_OFB_Tests.h"
+#include "AES256_CTR_Tests.h"
+#include "AES256_GCM_Tests.h"
+#include "CHACHA20_POLY1305_Tests.h"
 #include "Integrity_test.h"
 #include "../secure_memory_management/file_system.h"
 #include "../library_tracer/log_manager.h"
@@ -51,6 +54,9 @@
 #define SFT_AES256_CBC_SELFTEST_FAILED -1604
 #define SFT_AES256_OFB_SELFTEST_FAILED -1605
 #define SFT_MODULE_INTEGRITY_SELFTEST_FAILED -1606
+#define SFT_AES256_CTR_SELFTEST_FAILED -1607
+#define SFT_AES256_GCM_SELFTEST_FAILED -1608
+#define SFT_CHACHA20_POLY1305_SELFTEST_FAILED -1609
 
 /****************************************************************************************************************
  * Function definition zone
@@ -59,11 +59,374 @@ int CP_getPaddingLength(const unsigned char *padded_message, size_t length)
   return lastByte; // Return the length of the padding, which is the value of the last byte
 }
 
-// XOR two AES blocks and store the result
+// XOR two AES blocks and store the result, one 128 bits operation
 void CP_XorAesBlock(uint8_t *Block1, uint8_t const *Block2, uint8_t *result)
 {
-  for (uint32_t i = 0; i < AES_BLOCK_SIZE; i++)
-    result[i] = Block1[i] ^ Block2[i];
+  __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)Block1), _mm_loadu_si128((const __m128i *)Block2));
+  _mm_storeu_si128((__m128i *)result, x);
+}
+
+// AES-NI CBC decryption kernel, 8 blocks in flight per iteration. The ciphertext blocks are kept in registers
+// until they are XORed, so the plaintext buffer may overlap the ciphertext one (in-place decryption)
+static void CP_AESCBC_aesni_decrypt(const __m128i *ks, int rounds, const uint8_t *ciphertext, size_t nblocks, const uint8_t *iv, uint8_t *plaintext)
+{
+  const __m128i *in = (const __m128i *)ciphertext;
+  __m128i *out = (__m128i *)plaintext;
+  __m128i chain = _mm_loadu_si128((const __m128i *)iv);
+  __m128i c0, c1, c2, c3, c4, c5, c6, c7;
+  __m128i s0, s1, s2, s3, s4, s5, s6, s7;
+
+  for (; nblocks >= AES_PARALLEL_BLOCKS; nblocks -= AES_PARALLEL_BLOCKS)
+  {
+    s0 = c0 = _mm_loadu_si128(in + 0);
+    s1 = c1 = _mm_loadu_si128(in + 1);
+    s2 = c2 = _mm_loadu_si128(in + 2);
+    s3 = c3 = _mm_loadu_si128(in + 3);
+    s4 = c4 = _mm_loadu_si128(in + 4);
+    s5 = c5 = _mm_loadu_si128(in + 5);
+    s6 = c6 = _mm_loadu_si128(in + 6);
+    s7 = c7 = _mm_loadu_si128(in + 7);
+
+    AES_AESNI_ROUND8(_mm_xor_si128, ks[rounds]);
+    for (int i = 1; i < rounds; ++i)
+      AES_AESNI_ROUND8(_mm_aesdec_si128, ks[i + rounds]);
+    AES_AESNI_ROUND8(_mm_aesdeclast_si128, ks[0]);
+
+    // each block is XORed with the previous ciphertext block
+    _mm_storeu_si128(out + 0, _mm_xor_si128(s0, chain));
+    _mm_storeu_si128(out + 1, _mm_xor_si128(s1, c0));
+    _mm_storeu_si128(out + 2, _mm_xor_si128(s2, c1));
+    _mm_storeu_si128(out + 3, _mm_xor_si128(s3, c2));
+    _mm_storeu_si128(out + 4, _mm_xor_si128(s4, c3));
+    _mm_storeu_si128(out + 5, _mm_xor_si128(s5, c4));
+    _mm_storeu_si128(out + 6, _mm_xor_si128(s6, c5));
+    _mm_storeu_si128(out + 7, _mm_xor_si128(s7, c6));
+    chain = c7;
+    in += AES_PARALLEL_BLOCKS;
+    out += AES_PARALLEL_BLOCKS;
+  }
+
+  // remaining blocks
+  for (; nblocks > 0; nblocks--)
+  {
+    s0 = c0 = _mm_loadu_si128(in++);
+    s0 = _mm_xor_si128(s0, ks[rounds]);
+    for (int i = 1; i < rounds; ++i)
+      s0 = _mm_aesdec_si128(s0, ks[i + rounds]);
+    s0 = _mm_aesdeclast_si128(s0, ks[0]);
+    _mm_storeu_si128(out++, _mm_xor_si128(s0, chain));
+    chain = c0;
+  }
+}
+
+// VAES-256 CBC decryption kernel, 16 blocks (8 ymm registers) per iteration. The previous ciphertext blocks of
+// each register are rebuilt from the registers already loaded, so in-place decryption stays safe
+__attribute__((target("avx2,vaes")))
+static void CP_AESCBC_vaes256_decrypt(const __m128i *ks, int rounds, const uint8_t *ciphertext, size_t nblocks, const uint8_t *iv, uint8_t *plaintext)
+{
+  const __m256i *in = (const __m256i *)ciphertext;
+  __m256i *out = (__m256i *)plaintext;
+  __m256i rk[15];
+  __m256i chain = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)iv)); // only the high lane is used
+  __m256i c0, c1, c2, c3, c4, c5, c6, c7;
+  __m256i s0, s1, s2, s3, s4, s5, s6, s7;
+  uint8_t last[AES_BLOCK_SIZE];
+
+  rk[0] = _mm256_broadcastsi128_si256(ks[rounds]);
+  for (int i = 1; i < rounds; i++)
+    rk[i] = _mm256_broadcastsi128_si256(ks[i + rounds]);
+  rk[rounds] = _mm256_broadcastsi128_si256(ks[0]);
+
+  for (; nblocks >= AES_VAES_PARALLEL_BLOCKS; nblocks -= AES_VAES_PARALLEL_BLOCKS)
+  {
+    s0 = c0 = _mm256_loadu_si256(in + 0);
+    s1 = c1 = _mm256_loadu_si256(in + 1);
+    s2 = c2 = _mm256_loadu_si256(in + 2);
+    s3 = c3 = _mm256_loadu_si256(in + 3);
+    s4 = c4 = _mm256_loadu_si256(in + 4);
+    s5 = c5 = _mm256_loadu_si256(in + 5);
+    s6 = c6 = _mm256_loadu_si256(in + 6);
+    s7 = c7 = _mm256_loadu_si256(in + 7);
+
+    AES_AESNI_ROUND8(_mm256_xor_si256, rk[0]);
+    for (int i = 1; i < rounds; ++i)
+      AES_AESNI_ROUND8(_mm256_aesdec_epi128, rk[i]);
+    AES_AESNI_ROUND8(_mm256_aesdeclast_epi128, rk[rounds]);
+
+    // {high lane of the previous register, low lane of the current one} are the previous ciphertext blocks
+    _mm256_storeu_si256(out + 0, _mm256_xor_si256(s0, _mm256_permute2x128_si256(chain, c0, 0x21)));
+    _mm256_storeu_si256(out + 1, _mm256_xor_si256(s1, _mm256_permute2x128_si256(c0, c1, 0x21)));
+    _mm256_storeu_si256(out + 2, _mm256_xor_si256(s2, _mm256_permute2x128_si256(c1, c2, 0x21)));
+    _mm256_storeu_si256(out + 3, _mm256_xor_si256(s3, _mm256_permute2x128_si256(c2, c3, 0x21)));
+    _mm256_storeu_si256(out + 4, _mm256_xor_si256(s4, _mm256_permute2x128_si256(c3, c4, 0x21)));
+    _mm256_storeu_si256(out + 5, _mm256_xor_si256(s5, _mm256_permute2x128_si256(c4, c5, 0x21)));
+    _mm256_storeu_si256(out + 6, _mm256_xor_si256(s6, _mm256_permute2x128_si256(c5, c6, 0x21)));
+    _mm256_storeu_si256(out + 7, _mm256_xor_si256(s7, _mm256_permute2x128_si256(c6, c7, 0x21)));
+    chain = c7;
+    in += AES_VAES_PARALLEL_BLOCKS / 2;
+    out += AES_VAES_PARALLEL_BLOCKS / 2;
+  }
+
+  // remaining blocks with the 128 bits kernel, chained with the last ciphertext block
+  _mm_storeu_si128((__m128i *)last, _mm256_extracti128_si256(chain, 1));
+  CP_AESCBC_aesni_decrypt(ks, rounds, (const uint8_t *)in, nblocks, last, (uint8_t *)out);
+}
+
+// VAES-512 CBC decryption kernel, 16 blocks (4 zmm registers) per iteration, in-place safe as the VAES-256 one
+__attribute__((target("avx512f,vaes")))
+static void CP_AESCBC_vaes512_decrypt(const __m128i *ks, int rounds, const uint8_t *ciphertext, size_t nblocks, const uint8_t *iv, uint8_t *plaintext)
+{
+  const __m512i *in = (const __m512i *)ciphertext;
+  __m512i *out = (__m512i *)plaintext;
+  __m512i rk[15];
+  __m512i chain = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)iv)); // only the highest lane is used
+  __m512i c0, c1, c2, c3;
+  __m512i s0, s1, s2, s3;
+  uint8_t last[AES_BLOCK_SIZE];
+
+  rk[0] = _mm512_broadcast_i32x4(ks[rounds]);
+  for (int i = 1; i < rounds; i++)
+    rk[i] = _mm512_broadcast_i32x4(ks[i + rounds]);
+  rk[rounds] = _mm512_broadcast_i32x4(ks[0]);
+
+  for (; nblocks >= AES_VAES_PARALLEL_BLOCKS; nblocks -= AES_VAES_PARALLEL_BLOCKS)
+  {
+    s0 = c0 = _mm512_loadu_si512(in + 0);
+    s1 = c1 = _mm512_loadu_si512(in + 1);
+    s2 = c2 = _mm512_loadu_si512(in + 2);
+    s3 = c3 = _mm512_loadu_si512(in + 3);
+
+    AES_VAES_ROUND4(_mm512_xor_si512, rk[0]);
+    for (int i = 1; i < rounds; ++i)
+      AES_VAES_ROUND4(_mm512_aesdec_epi128, rk[i]);
+    AES_VAES_ROUND4(_mm512_aesdeclast_epi128, rk[rounds]);
+
+    // {highest lane of the previous register, three lowest lanes of the current one} are the previous ciphertext blocks
+    _mm512_storeu_si512(out + 0, _mm512_xor_si512(s0, _mm512_alignr_epi64(c0, chain, 6)));
+    _mm512_storeu_si512(out + 1, _mm512_xor_si512(s1, _mm512_alignr_epi64(c1, c0, 6)));
+    _mm512_storeu_si512(out + 2, _mm512_xor_si512(s2, _mm512_alignr_epi64(c2, c1, 6)));
+    _mm512_storeu_si512(out + 3, _mm512_xor_si512(s3, _mm512_alignr_epi64(c3, c2, 6)));
+    chain = c3;
+    in += AES_VAES_PARALLEL_BLOCKS / 4;
+    out += AES_VAES_PARALLEL_BLOCKS / 4;
+  }
+
+  // remaining blocks with the 128 bits kernel, chained with the last ciphertext block
+  _mm_storeu_si128((__m128i *)last, _mm512_extracti32x4_epi32(chain, 3));
+  CP_AESCBC_aesni_decrypt(ks, rounds, (const uint8_t *)in, nblocks, last, (uint8_t *)out);
+}
+
+void CP_AESCBC_decrypt_blocks(AesContext const *ctx, const uint8_t *ciphertext, size_t nblocks, const uint8_t *iv, uint8_t *plaintext)
+{
+  AES_implementation implementation = API_AES_getImplementation();
+  if (implementation == hardware_VAES_512)
+  {
+    CP_AESCBC_vaes512_decrypt(ctx->HK, ctx->Nr, ciphertext, nblocks, iv, plaintext);
+    return;
+  }
+  if (implementation == hardware_VAES_256)
+  {
+    CP_AESCBC_vaes256_decrypt(ctx->HK, ctx->Nr, ciphertext, nblocks, iv, plaintext);
+    return;
+  }
+  if (implementation == hardware_AES_NI)
+  {
+    CP_AESCBC_aesni_decrypt(ctx->HK, ctx->Nr, ciphertext, nblocks, iv, plaintext);
+    return;
+  }
+
+  // software implementations, chunks of AES_BITSLICED_PARALLEL_BLOCKS blocks through the multi-block API
+  uint8_t chain[AES_BLOCK_SIZE];
+  uint8_t next_chain[AES_BLOCK_SIZE];
+  uint8_t decrypted[AES_BITSLICED_PARALLEL_BLOCKS * AES_BLOCK_SIZE];
+  memcpy(chain, iv, AES_BLOCK_SIZE);
+  while (nblocks > 0)
+  {
+    size_t n = (nblocks < AES_BITSLICED_PARALLEL_BLOCKS) ? nblocks : AES_BITSLICED_PARALLEL_BLOCKS;
+    API_AES_decrypt_blocks(ctx, ciphertext, decrypted, n);
+    memcpy(next_chain, ciphertext + (n - 1) * AES_BLOCK_SIZE, AES_BLOCK_SIZE); // the ciphertext may be overwritten below
+    CP_XorAesBlock(decrypted, chain, decrypted);
+    for (size_t i = 1; i < n; i++)
+      CP_XorAesBlock(decrypted + i * AES_BLOCK_SIZE, ciphertext + (i - 1) * AES_BLOCK_SIZE, decrypted + i * AES_BLOCK_SIZE);
+    memcpy(plaintext, decrypted, n * AES_BLOCK_SIZE);
+    memcpy(chain, next_chain, AES_BLOCK_SIZE);
+    ciphertext += n * AES_BLOCK_SIZE;
+    plaintext += n * AES_BLOCK_SIZE;
+    nblocks -= n;
+  }
+  memset(decrypted, 0, sizeof(decrypted));
+}
+
+void CP_AESCBC_encrypt_blocks(AesContext const *ctx, const uint8_t *plaintext, size_t nblocks, const uint8_t *iv, uint8_t *ciphertext)
+{
+  if (AES_IMPLEMENTATION_IS_AESNI(API_AES_getImplementation()))
+  {
+    // chaining value kept in a register between blocks
+    const __m128i *ks = ctx->HK;
+    int rounds = ctx->Nr;
+    __m128i state = _mm_loadu_si128((const __m128i *)iv);
+    for (size_t i = 0; i < nblocks; i++)
+    {
+      state = _mm_xor_si128(state, _mm_loadu_si128((const __m128i *)(plaintext + i * AES_BLOCK_SIZE)));
+      state = _mm_xor_si128(state, ks[0]);
+      for (int r = 1; r < rounds; ++r)
+        state = _mm_aesenc_si128(state, ks[r]);
+      state = _mm_aesenclast_si128(state, ks[rounds]);
+      _mm_storeu_si128((__m128i *)(ciphertext + i * AES_BLOCK_SIZE), state);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < nblocks; i++)
+  {
+    CP_XorAesBlock((uint8_t *)plaintext + i * AES_BLOCK_SIZE, (i == 0) ? iv : ciphertext + (i - 1) * AES_BLOCK_SIZE, ciphertext + i * AES_BLOCK_SIZE); // XOR with IV or previous ciphertext block
+    API_AES_encrypt_block(ctx, ciphertext + i * AES_BLOCK_SIZE, ciphertext + i * AES_BLOCK_SIZE);                                                  // Encrypt the XORed block
+  }
+}
+
+/**
+ * @brief One AES-NI instruction over the AESCBC_MAX_LANES lanes, each lane with its own key schedule
+ */
+#define AESCBC_LANES_ROUND(op, r)     \
+  do                                  \
+  {                                   \
+    s0 = op(s0, lane_ks[0][r]);       \
+    s1 = op(s1, lane_ks[1][r]);       \
+    s2 = op(s2, lane_ks[2][r]);       \
+    s3 = op(s3, lane_ks[3][r]);       \
+    s4 = op(s4, lane_ks[4][r]);       \
+    s5 = op(s5, lane_ks[5][r]);       \
+    s6 = op(s6, lane_ks[6][r]);       \
+    s7 = op(s7, lane_ks[7][r]);       \
+  } while (0)
+
+// AES-NI multi-lane CBC encryption, every lane advances its own stream one block per iteration. When a lane
+// finishes its stream, it is refilled with the next pending one; lanes without stream run on a dummy block.
+static void CP_AESCBC_aesni_encrypt_multi(AESCBC_stream *streams, size_t nstreams, uint_fast32_t rounds)
+{
+  static const uint8_t idle_block[AES_BLOCK_SIZE] = {0};
+  uint8_t idle_sink[AES_BLOCK_SIZE];
+  const __m128i *lane_ks[AESCBC_MAX_LANES];
+  const uint8_t *lane_in[AESCBC_MAX_LANES];
+  uint8_t *lane_out[AESCBC_MAX_LANES];
+  size_t lane_blocks[AESCBC_MAX_LANES];
+  __m128i chain[AESCBC_MAX_LANES];
+  __m128i s0, s1, s2, s3, s4, s5, s6, s7;
+  size_t next = 0;
+  int active = 0;
+
+  for (int l = 0; l < AESCBC_MAX_LANES; l++)
+  {
+    // next stream with data and the same number of rounds
+    while (next < nstreams && (streams[next].len == 0 || streams[next].ctx->Nr != rounds))
+      next++;
+    if (next < nstreams)
+    {
+      lane_ks[l] = streams[next].ctx->HK;
+      lane_in[l] = streams[next].plaintext;
+      lane_out[l] = streams[next].ciphertext;
+      lane_blocks[l] = streams[next].len / AES_BLOCK_SIZE;
+      chain[l] = _mm_loadu_si128((const __m128i *)streams[next].iv);
+      next++;
+      active++;
+    }
+    else
+    {
+      lane_ks[l] = lane_ks[0];
+      lane_in[l] = idle_block;
+      lane_out[l] = idle_sink;
+      lane_blocks[l] = 0;
+      chain[l] = _mm_setzero_si128();
+    }
+  }
+
+  while (active > 0)
+  {
+    s0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)lane_in[0]), chain[0]);
+    s1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)lane_in[1]), chain[1]);
+    s2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)lane_in[2]), chain[2]);
+    s3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)lane_in[3]), chain[3]);
+    s4 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)lane_in[4]), chain[4]);
+    s5 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)lane_in[5]), chain[5]);
+    s6 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)lane_in[6]), chain[6]);
+    s7 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)lane_in[7]), chain[7]);
+
+    AESCBC_LANES_ROUND(_mm_xor_si128, 0);
+    for (uint_fast32_t r = 1; r < rounds; ++r)
+      AESCBC_LANES_ROUND(_mm_aesenc_si128, r);
+    AESCBC_LANES_ROUND(_mm_aesenclast_si128, rounds);
+
+    chain[0] = s0;
+    chain[1] = s1;
+    chain[2] = s2;
+    chain[3] = s3;
+    chain[4] = s4;
+    chain[5] = s5;
+    chain[6] = s6;
+    chain[7] = s7;
+
+    for (int l = 0; l < AESCBC_MAX_LANES; l++)
+    {
+      _mm_storeu_si128((__m128i *)lane_out[l], chain[l]);
+      if (lane_blocks[l] == 0) // idle lane
+        continue;
+      lane_in[l] += AES_BLOCK_SIZE;
+      lane_out[l] += AES_BLOCK_SIZE;
+      if (--lane_blocks[l] > 0)
+        continue;
+
+      // stream finished, refill the lane
+      while (next < nstreams && (streams[next].len == 0 || streams[next].ctx->Nr != rounds))
+        next++;
+      if (next < nstreams)
+      {
+        lane_ks[l] = streams[next].ctx->HK;
+        lane_in[l] = streams[next].plaintext;
+        lane_out[l] = streams[next].ciphertext;
+        lane_blocks[l] = streams[next].len / AES_BLOCK_SIZE;
+        chain[l] = _mm_loadu_si128((const __m128i *)streams[next].iv);
+        next++;
+      }
+      else
+      {
+        lane_in[l] = idle_block;
+        lane_out[l] = idle_sink;
+        active--;
+      }
+    }
+  }
+}
+
+int API_AESCBC_encrypt_multi(AESCBC_stream *streams, size_t nstreams)
+{
+  uint_fast32_t lane_rounds = 0;
+
+  // check every stream before touching any output
+  for (size_t i = 0; i < nstreams; i++)
+  {
+    if (streams[i].ctx == NULL || streams[i].len % AES_BLOCK_SIZE != 0)
+      return 0;
+  }
+
+  if (AES_IMPLEMENTATION_IS_AESNI(API_AES_getImplementation()))
+  {
+    // the lanes run in lockstep, so they share the number of rounds of the first stream with data
+    for (size_t i = 0; i < nstreams && lane_rounds == 0; i++)
+    {
+      if (streams[i].len != 0)
+        lane_rounds = streams[i].ctx->Nr;
+    }
+    if (lane_rounds != 0)
+      CP_AESCBC_aesni_encrypt_multi(streams, nstreams, lane_rounds);
+  }
+
+  // streams not handled by the lanes (software implementations or different key size)
+  for (size_t i = 0; i < nstreams; i++)
+  {
+    if (streams[i].len != 0 && streams[i].ctx->Nr != lane_rounds)
+      CP_AESCBC_encrypt_blocks(streams[i].ctx, streams[i].plaintext, streams[i].len / AES_BLOCK_SIZE, streams[i].iv, streams[i].ciphertext);
+  }
+  return 1;
 }
 
 // Encrypt data using AES-CBC mode
@@ -72,20 +435,18 @@ int API_AESCBC_encrypt(unsigned char *plaintext, size_t len, unsigned char *key,
   // Initialize AES context with the provided key
   API_AES_initkey(&AES_CBC_ctx, key, AES_KEY_SIZE);
 
+  return API_AESCBC_encrypt_ctx(&AES_CBC_ctx, plaintext, len, iv, ciphertext);
+}
+
+// Encrypt data using AES-CBC mode with an already expanded key
+int API_AESCBC_encrypt_ctx(AesContext const *ctx, unsigned char *plaintext, size_t len, unsigned char *iv, unsigned char *ciphertext)
+{
   // Ensure the plaintext length is a multiple of 16 bytes
   if (len % 16 != 0)
     return 0;
 
-  // Encrypt each block of plaintext
-  for (size_t num_rounds = 0; num_rounds < len / 16; num_rounds++){
-    if(num_rounds == 0){
-      CP_XorAesBlock(plaintext, iv, ciphertext); // XOR with IV for the first block
-    }
-    else{
-      CP_XorAesBlock(plaintext + (num_rounds * 16), ciphertext + ((num_rounds - 1) * 16), ciphertext + (num_rounds * 16)); // XOR with previous ciphertext block
-    }
-    API_AES_encrypt_block(&AES_CBC_ctx, ciphertext + (num_rounds * 16), ciphertext + (num_rounds * 16)); // Encrypt the XORed block
-  }
+  // Encrypt each block of plaintext, chained with the previous ciphertext block
+  CP_AESCBC_encrypt_blocks(ctx, plaintext, len / 16, iv, ciphertext);
   return 1;
 }
 
@@ -95,20 +456,18 @@ int API_AESCBC_decrypt(unsigned char *ciphertext, size_t len, unsigned char *key
   // Initialize AES context with the provided key
   API_AES_initkey(&AES_CBC_ctx, key, AES_KEY_SIZE);
 
+  return API_AESCBC_decrypt_ctx(&AES_CBC_ctx, ciphertext, len, iv, plaintext);
+}
+
+// Decrypt data using AES-CBC mode with an already expanded key
+int API_AESCBC_decrypt_ctx(AesContext const *ctx, unsigned char *ciphertext, size_t len, unsigned char *iv, unsigned char *plaintext)
+{
   // Ensure the ciphertext length is a multiple of 16 bytes
   if (len % 16 != 0)
     return 0;
 
-  // Decrypt each block of ciphertext
-  for (size_t num_rounds = 0; num_rounds < len / 16; num_rounds++){
-    API_AES_decrypt_block(&AES_CBC_ctx, ciphertext + (num_rounds * 16), plaintext + (num_rounds * 16)); // Decrypt the block
-    if(num_rounds == 0){
-      CP_XorAesBlock(plaintext, iv, plaintext); // XOR with IV for the first block
-    }
-    else{
-      CP_XorAesBlock(plaintext + (num_rounds * 16), ciphertext + ((num_rounds - 1) * 16), plaintext + (num_rounds * 16)); // XOR with previous ciphertext block
-    }
-  }
+  // Decrypt all the blocks, several of them in flight at a time
+  CP_AESCBC_decrypt_blocks(ctx, ciphertext, len / 16, iv, plaintext);
   return 1;
 }
 
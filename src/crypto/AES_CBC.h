@@ -35,6 +35,23 @@
 
 extern AesContext AES_CBC_ctx; //auxiliar ctx to store round keys, CSP!
 
+/**
+ * @brief Maximum number of independent streams advanced in lockstep by API_AESCBC_encrypt_multi
+ */
+#define AESCBC_MAX_LANES 8
+
+/**
+ * @brief Independent CBC encryption stream for the multi-lane encryptor API_AESCBC_encrypt_multi
+ */
+typedef struct AESCBC_stream
+{
+  AesContext const *ctx;    /**< AES context initialized with the key of the stream (API_AES_initkey). */
+  const uint8_t *iv;        /**< Initialization vector of the stream. */
+  const uint8_t *plaintext; /**< Plaintext of the stream, already padded. */
+  size_t len;               /**< Length of the plaintext, must be a multiple of 16 bytes. */
+  uint8_t *ciphertext;      /**< Output buffer, len bytes, may be the same as plaintext. */
+} AESCBC_stream;
+
 /* Macros............................................................ */
 
 #define MIN(x, y) (((x) < (y)// SHA256 selftests starts) ? (x) : (y))
@@ -97,6 +114,53 @@ int CP_getPaddingLength(const unsigned char *padded_message, size_t length);
 
 void CP_XorAesBlock(uint8_t *Block1, uint8_t const *Block2, uint8_t *result);
 
+/**
+ * @brief Decrypts nblocks CBC blocks with an already initialized AES context.
+ *
+ * Since in CBC decryption every block only depends on the ciphertext, the blocks are decrypted
+ * AES_PARALLEL_BLOCKS at a time (dedicated 8-way kernel with AES-NI, multi-block API otherwise) and then
+ * XORed with the previous ciphertext blocks using 128 bits operations.
+ * The plaintext buffer may be the same as the ciphertext buffer.
+ *
+ * @param[in]  ctx        Initialized AES context.
+ * @param[in]  ciphertext The buffer containing the nblocks ciphertext blocks.
+ * @param[in]  nblocks    Number of 16 bytes blocks.
+ * @param[in]  iv         The initialization vector for CBC mode.
+ * @param[out] plaintext  The buffer to store the decrypted blocks.
+ */
+
+void CP_AESCBC_decrypt_blocks(AesContext const *ctx, const uint8_t *ciphertext, size_t nblocks, const uint8_t *iv, uint8_t *plaintext);
+
+
+/**
+ * @brief Encrypts nblocks CBC blocks with an already initialized AES context.
+ *
+ * CBC encryption is serial inside one stream, with AES-NI the chaining value is kept in a register.
+ * The ciphertext buffer may be the same as the plaintext buffer.
+ *
+ * @param[in]  ctx        Initialized AES context.
+ * @param[in]  plaintext  The buffer containing the nblocks plaintext blocks.
+ * @param[in]  nblocks    Number of 16 bytes blocks.
+ * @param[in]  iv         The initialization vector for CBC mode.
+ * @param[out] ciphertext The buffer to store the encrypted blocks.
+ */
+
+void CP_AESCBC_encrypt_blocks(AesContext const *ctx, const uint8_t *plaintext, size_t nblocks, const uint8_t *iv, uint8_t *ciphertext);
+
+/**
+ * @brief Encrypts several independent streams (key, IV, plaintext) using AES-CBC mode.
+ *
+ * With AES-NI, up to AESCBC_MAX_LANES streams advance in lockstep, one block each per iteration, filling the
+ * AES pipeline that a single CBC stream leaves idle. When a stream ends, its lane takes the next pending stream.
+ * Without AES-NI (or for streams whose key size differs from the first one) the streams are encrypted one after another.
+ *
+ * @param[in,out] streams  Array of streams to encrypt.
+ * @param[in]     nstreams Number of streams.
+ *
+ * @return 1 on success, 0 on failure (missing context or length not multiple of 16 bytes, nothing is encrypted).
+ */
+
+int API_AESCBC_encrypt_multi(AESCBC_stream *streams, size_t nstreams);
 
 /**
  * @brief Encrypts plaintext using AES-CBC mode.
@@ -115,6 +179,23 @@ void CP_XorAesBlock(uint8_t *Block1, uint8_t const *Block2, uint8_t *result);
 
 int API_AESCBC_encrypt(unsigned char *plaintext, size_t len, unsigned char *key, unsigned int AES_KEY_SIZE, unsigned char *iv, unsigned char *ciphertext);
 
+/**
+ * @brief Encrypts plaintext using AES-CBC mode with an already expanded key.
+ *
+ * Same as API_AESCBC_encrypt, but the key schedule is passed by handle, so keys that are used for
+ * many messages are expanded only once (see API_KM_loadkey).
+ *
+ * @param[in]  ctx        AES context initialized with API_AES_initkey.
+ * @param[in]  plaintext  The buffer containing the plaintext to encrypt.
+ * @param[in]  len        The length of the plaintext buffer, multiple of 16 bytes.
+ * @param[in]  iv         The initialization vector for CBC mode.
+ * @param[out] ciphertext The buffer to store the encrypted ciphertext.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+
+int API_AESCBC_encrypt_ctx(AesContext const *ctx, unsigned char *plaintext, size_t len, unsigned char *iv, unsigned char *ciphertext);
+
 /**
  * @brief Decrypts ciphertext using AES-CBC mode.
  *
@@ -132,5 +213,22 @@ int API_AESCBC_encrypt(unsigned char *plaintext, size_t len, unsigned char *key,
 
 int API_AESCBC_decrypt(unsigned char *ciphertext, size_t len, unsigned char *key, unsigned int AES_KEY_SIZE, unsigned char *iv, unsigned char *plaintext);
 
+/**
+ * @brief Decrypts ciphertext using AES-CBC mode with an already expanded key.
+ *
+ * Same as API_AESCBC_decrypt, but the key schedule is passed by handle, so keys that are used for
+ * many messages are expanded only once (see API_KM_loadkey).
+ *
+ * @param[in]  ctx        AES context initialized with API_AES_initkey.
+ * @param[in]  ciphertext The buffer containing the ciphertext to decrypt.
+ * @param[in]  len        The length of the ciphertext buffer, multiple of 16 bytes.
+ * @param[in]  iv         The initialization vector for CBC mode.
+ * @param[out] plaintext  The buffer to store the decrypted plaintext.
+ *
+ * @return 1 on success, 0 on failure.
+ */
+
+int API_AESCBC_decrypt_ctx(AesContext const *ctx, unsigned char *ciphertext, size_t len, unsigned char *iv, unsigned char *plaintext);
+
 
 #endif 
@@ -648,6 +648,45 @@ int supportsAESNI() {
     return (ecx & (1 << 25)) != 0;
 }
 
+// function to check if SSSE3 instructions are supported
+int supportsSSSE3() {
+    unsigned int eax, ebx, ecx, edx;
+    __cpuid(1, eax, ebx, ecx, edx);
+    return (ecx & (1 << 9)) != 0;
+}
+
+// function to check if PCLMULQDQ (carry-less multiplication) is supported
+int supportsPCLMULQDQ() {
+    unsigned int eax, ebx, ecx, edx;
+    __cpuid(1, eax, ebx, ecx, edx);
+    return (ecx & (1 << 1)) != 0;
+}
+
+// function to check if VAES instructions are supported and which register width can be used
+int supportsVAES() {
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int xcr0_lo, xcr0_hi;
+    int width = 0;
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    if ((ecx & (1 << 27)) == 0 || __get_cpuid_max(0, NULL) < 7) // no OSXSAVE (XGETBV) or no leaf 7
+        return 0;
+
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    if ((ecx & (1 << 9)) == 0) // VAES
+        return 0;
+
+    __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 0x6) != 0x6) // XMM and YMM states saved by the OS
+        return 0;
+
+    if (ebx & (1 << 5)) // AVX2
+        width = 256;
+    if ((ebx & (1 << 16)) && (xcr0_lo & 0xE0) == 0xE0) // AVX-512F and opmask/ZMM states saved by the OS
+        width = 512;
+    return width;
+}
+
 //////////////////////////////////////////// HARDWARE CONSTANT TIME AES-NI IMPLEMENTATION //////////////////////////////////////////
 
 /**
@@ -901,6 +940,253 @@ void aes_aesni_decrypt(const __m128i *ks, int rounds, const uint8_t *ciphertext,
     _mm_storeu_si128((__m128i *)plaintext, state);
 }
 
+void aes_aesni_encrypt_blocks(const __m128i *ks, int rounds, const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks)
+{
+    const __m128i *in = (const __m128i *)plaintext;
+    __m128i *out = (__m128i *)ciphertext;
+    __m128i s0, s1, s2, s3, s4, s5, s6, s7;
+
+    // main loop, AES_PARALLEL_BLOCKS blocks in flight
+    for (; nblocks >= AES_PARALLEL_BLOCKS; nblocks -= AES_PARALLEL_BLOCKS)
+    {
+        s0 = _mm_loadu_si128(in + 0);
+        s1 = _mm_loadu_si128(in + 1);
+        s2 = _mm_loadu_si128(in + 2);
+        s3 = _mm_loadu_si128(in + 3);
+        s4 = _mm_loadu_si128(in + 4);
+        s5 = _mm_loadu_si128(in + 5);
+        s6 = _mm_loadu_si128(in + 6);
+        s7 = _mm_loadu_si128(in + 7);
+
+        AES_AESNI_ROUND8(_mm_xor_si128, ks[0]);
+        for (int i = 1; i < rounds; ++i)
+            AES_AESNI_ROUND8(_mm_aesenc_si128, ks[i]);
+        AES_AESNI_ROUND8(_mm_aesenclast_si128, ks[rounds]);
+
+        _mm_storeu_si128(out + 0, s0);
+        _mm_storeu_si128(out + 1, s1);
+        _mm_storeu_si128(out + 2, s2);
+        _mm_storeu_si128(out + 3, s3);
+        _mm_storeu_si128(out + 4, s4);
+        _mm_storeu_si128(out + 5, s5);
+        _mm_storeu_si128(out + 6, s6);
+        _mm_storeu_si128(out + 7, s7);
+        in += AES_PARALLEL_BLOCKS;
+        out += AES_PARALLEL_BLOCKS;
+    }
+
+    // remaining blocks
+    for (; nblocks > 0; nblocks--)
+    {
+        s0 = _mm_loadu_si128(in++);
+        AES_AESNI_ENCRYPT(ks, rounds, s0);
+        _mm_storeu_si128(out++, s0);
+    }
+}
+
+void aes_aesni_decrypt_blocks(const __m128i *ks, int rounds, const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks)
+{
+    const __m128i *in = (const __m128i *)ciphertext;
+    __m128i *out = (__m128i *)plaintext;
+    __m128i s0, s1, s2, s3, s4, s5, s6, s7;
+
+    // main loop, AES_PARALLEL_BLOCKS blocks in flight
+    for (; nblocks >= AES_PARALLEL_BLOCKS; nblocks -= AES_PARALLEL_BLOCKS)
+    {
+        s0 = _mm_loadu_si128(in + 0);
+        s1 = _mm_loadu_si128(in + 1);
+        s2 = _mm_loadu_si128(in + 2);
+        s3 = _mm_loadu_si128(in + 3);
+        s4 = _mm_loadu_si128(in + 4);
+        s5 = _mm_loadu_si128(in + 5);
+        s6 = _mm_loadu_si128(in + 6);
+        s7 = _mm_loadu_si128(in + 7);
+
+        AES_AESNI_ROUND8(_mm_xor_si128, ks[rounds]);
+        for (int i = 1; i < rounds; ++i)
+            AES_AESNI_ROUND8(_mm_aesdec_si128, ks[i + rounds]);
+        AES_AESNI_ROUND8(_mm_aesdeclast_si128, ks[0]);
+
+        _mm_storeu_si128(out + 0, s0);
+        _mm_storeu_si128(out + 1, s1);
+        _mm_storeu_si128(out + 2, s2);
+        _mm_storeu_si128(out + 3, s3);
+        _mm_storeu_si128(out + 4, s4);
+        _mm_storeu_si128(out + 5, s5);
+        _mm_storeu_si128(out + 6, s6);
+        _mm_storeu_si128(out + 7, s7);
+        in += AES_PARALLEL_BLOCKS;
+        out += AES_PARALLEL_BLOCKS;
+    }
+
+    // remaining blocks
+    for (; nblocks > 0; nblocks--)
+    {
+        s0 = _mm_loadu_si128(in++);
+        AES_AESNI_DECRYPT(ks, rounds, s0);
+        _mm_storeu_si128(out++, s0);
+    }
+}
+
+
+//////////////////////////////////////////// HARDWARE VAES WIDE IMPLEMENTATION //////////////////////////////////////////
+
+__attribute__((target("avx2,vaes")))
+void aes_vaes256_encrypt_blocks(const __m128i *ks, int rounds, const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks)
+{
+    __m256i rk[15];
+    __m256i s0, s1, s2, s3, s4, s5, s6, s7;
+
+    // round keys broadcasted to both 128 bits lanes
+    for (int i = 0; i <= rounds; i++)
+        rk[i] = _mm256_broadcastsi128_si256(ks[i]);
+
+    for (; nblocks >= AES_VAES_PARALLEL_BLOCKS; nblocks -= AES_VAES_PARALLEL_BLOCKS)
+    {
+        s0 = _mm256_loadu_si256((const __m256i *)plaintext + 0);
+        s1 = _mm256_loadu_si256((const __m256i *)plaintext + 1);
+        s2 = _mm256_loadu_si256((const __m256i *)plaintext + 2);
+        s3 = _mm256_loadu_si256((const __m256i *)plaintext + 3);
+        s4 = _mm256_loadu_si256((const __m256i *)plaintext + 4);
+        s5 = _mm256_loadu_si256((const __m256i *)plaintext + 5);
+        s6 = _mm256_loadu_si256((const __m256i *)plaintext + 6);
+        s7 = _mm256_loadu_si256((const __m256i *)plaintext + 7);
+
+        AES_AESNI_ROUND8(_mm256_xor_si256, rk[0]);
+        for (int i = 1; i < rounds; ++i)
+            AES_AESNI_ROUND8(_mm256_aesenc_epi128, rk[i]);
+        AES_AESNI_ROUND8(_mm256_aesenclast_epi128, rk[rounds]);
+
+        _mm256_storeu_si256((__m256i *)ciphertext + 0, s0);
+        _mm256_storeu_si256((__m256i *)ciphertext + 1, s1);
+        _mm256_storeu_si256((__m256i *)ciphertext + 2, s2);
+        _mm256_storeu_si256((__m256i *)ciphertext + 3, s3);
+        _mm256_storeu_si256((__m256i *)ciphertext + 4, s4);
+        _mm256_storeu_si256((__m256i *)ciphertext + 5, s5);
+        _mm256_storeu_si256((__m256i *)ciphertext + 6, s6);
+        _mm256_storeu_si256((__m256i *)ciphertext + 7, s7);
+        plaintext += AES_VAES_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+        ciphertext += AES_VAES_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+    }
+
+    // remaining blocks
+    aes_aesni_encrypt_blocks(ks, rounds, plaintext, ciphertext, nblocks);
+}
+
+__attribute__((target("avx2,vaes")))
+void aes_vaes256_decrypt_blocks(const __m128i *ks, int rounds, const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks)
+{
+    __m256i rk[15];
+    __m256i s0, s1, s2, s3, s4, s5, s6, s7;
+
+    // decryption round keys in order of use, broadcasted to both 128 bits lanes
+    rk[0] = _mm256_broadcastsi128_si256(ks[rounds]);
+    for (int i = 1; i < rounds; i++)
+        rk[i] = _mm256_broadcastsi128_si256(ks[i + rounds]);
+    rk[rounds] = _mm256_broadcastsi128_si256(ks[0]);
+
+    for (; nblocks >= AES_VAES_PARALLEL_BLOCKS; nblocks -= AES_VAES_PARALLEL_BLOCKS)
+    {
+        s0 = _mm256_loadu_si256((const __m256i *)ciphertext + 0);
+        s1 = _mm256_loadu_si256((const __m256i *)ciphertext + 1);
+        s2 = _mm256_loadu_si256((const __m256i *)ciphertext + 2);
+        s3 = _mm256_loadu_si256((const __m256i *)ciphertext + 3);
+        s4 = _mm256_loadu_si256((const __m256i *)ciphertext + 4);
+        s5 = _mm256_loadu_si256((const __m256i *)ciphertext + 5);
+        s6 = _mm256_loadu_si256((const __m256i *)ciphertext + 6);
+        s7 = _mm256_loadu_si256((const __m256i *)ciphertext + 7);
+
+        AES_AESNI_ROUND8(_mm256_xor_si256, rk[0]);
+        for (int i = 1; i < rounds; ++i)
+            AES_AESNI_ROUND8(_mm256_aesdec_epi128, rk[i]);
+        AES_AESNI_ROUND8(_mm256_aesdeclast_epi128, rk[rounds]);
+
+        _mm256_storeu_si256((__m256i *)plaintext + 0, s0);
+        _mm256_storeu_si256((__m256i *)plaintext + 1, s1);
+        _mm256_storeu_si256((__m256i *)plaintext + 2, s2);
+        _mm256_storeu_si256((__m256i *)plaintext + 3, s3);
+        _mm256_storeu_si256((__m256i *)plaintext + 4, s4);
+        _mm256_storeu_si256((__m256i *)plaintext + 5, s5);
+        _mm256_storeu_si256((__m256i *)plaintext + 6, s6);
+        _mm256_storeu_si256((__m256i *)plaintext + 7, s7);
+        ciphertext += AES_VAES_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+        plaintext += AES_VAES_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+    }
+
+    // remaining blocks
+    aes_aesni_decrypt_blocks(ks, rounds, ciphertext, plaintext, nblocks);
+}
+
+__attribute__((target("avx512f,vaes")))
+void aes_vaes512_encrypt_blocks(const __m128i *ks, int rounds, const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks)
+{
+    __m512i rk[15];
+    __m512i s0, s1, s2, s3;
+
+    // round keys broadcasted to the four 128 bits lanes
+    for (int i = 0; i <= rounds; i++)
+        rk[i] = _mm512_broadcast_i32x4(ks[i]);
+
+    for (; nblocks >= AES_VAES_PARALLEL_BLOCKS; nblocks -= AES_VAES_PARALLEL_BLOCKS)
+    {
+        s0 = _mm512_loadu_si512((const __m512i *)plaintext + 0);
+        s1 = _mm512_loadu_si512((const __m512i *)plaintext + 1);
+        s2 = _mm512_loadu_si512((const __m512i *)plaintext + 2);
+        s3 = _mm512_loadu_si512((const __m512i *)plaintext + 3);
+
+        AES_VAES_ROUND4(_mm512_xor_si512, rk[0]);
+        for (int i = 1; i < rounds; ++i)
+            AES_VAES_ROUND4(_mm512_aesenc_epi128, rk[i]);
+        AES_VAES_ROUND4(_mm512_aesenclast_epi128, rk[rounds]);
+
+        _mm512_storeu_si512((__m512i *)ciphertext + 0, s0);
+        _mm512_storeu_si512((__m512i *)ciphertext + 1, s1);
+        _mm512_storeu_si512((__m512i *)ciphertext + 2, s2);
+        _mm512_storeu_si512((__m512i *)ciphertext + 3, s3);
+        plaintext += AES_VAES_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+        ciphertext += AES_VAES_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+    }
+
+    // remaining blocks
+    aes_aesni_encrypt_blocks(ks, rounds, plaintext, ciphertext, nblocks);
+}
+
+__attribute__((target("avx512f,vaes")))
+void aes_vaes512_decrypt_blocks(const __m128i *ks, int rounds, const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks)
+{
+    __m512i rk[15];
+    __m512i s0, s1, s2, s3;
+
+    // decryption round keys in order of use, broadcasted to the four 128 bits lanes
+    rk[0] = _mm512_broadcast_i32x4(ks[rounds]);
+    for (int i = 1; i < rounds; i++)
+        rk[i] = _mm512_broadcast_i32x4(ks[i + rounds]);
+    rk[rounds] = _mm512_broadcast_i32x4(ks[0]);
+
+    for (; nblocks >= AES_VAES_PARALLEL_BLOCKS; nblocks -= AES_VAES_PARALLEL_BLOCKS)
+    {
+        s0 = _mm512_loadu_si512((const __m512i *)ciphertext + 0);
+        s1 = _mm512_loadu_si512((const __m512i *)ciphertext + 1);
+        s2 = _mm512_loadu_si512((const __m512i *)ciphertext + 2);
+        s3 = _mm512_loadu_si512((const __m512i *)ciphertext + 3);
+
+        AES_VAES_ROUND4(_mm512_xor_si512, rk[0]);
+        for (int i = 1; i < rounds; ++i)
+            AES_VAES_ROUND4(_mm512_aesdec_epi128, rk[i]);
+        AES_VAES_ROUND4(_mm512_aesdeclast_epi128, rk[rounds]);
+
+        _mm512_storeu_si512((__m512i *)plaintext + 0, s0);
+        _mm512_storeu_si512((__m512i *)plaintext + 1, s1);
+        _mm512_storeu_si512((__m512i *)plaintext + 2, s2);
+        _mm512_storeu_si512((__m512i *)plaintext + 3, s3);
+        ciphertext += AES_VAES_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+        plaintext += AES_VAES_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+    }
+
+    // remaining blocks
+    aes_aesni_decrypt_blocks(ks, rounds, ciphertext, plaintext, nblocks);
+}
+
 
 //////////////////////////////////////////// SOFTWARE TABLE-BASED IMPLEMENTATION //////////////////////////////////////////
 
@@ -1154,16 +1440,851 @@ void aes_table_decrypt(AesContext const* Context, uint8_t const Input [AES_BLOCK
     STORE32H( s3, Output + 12 );
 }
 
+/**
+ * @brief One full table-based encryption round of a single lane of the multi-block kernel
+ *
+ * @param d Destination state (4 words)
+ * @param s Source state (4 words)
+ * @param rk Round key
+ */
+#define TE_ROUND(d, s, rk)                                                                                          \
+    do                                                                                                              \
+    {                                                                                                               \
+        d[0] = Te0(BYTE(s[0], 3)) ^ Te1(BYTE(s[1], 2)) ^ Te2(BYTE(s[2], 1)) ^ Te3(BYTE(s[3], 0)) ^ (rk)[0];         \
+        d[1] = Te0(BYTE(s[1], 3)) ^ Te1(BYTE(s[2], 2)) ^ Te2(BYTE(s[3], 1)) ^ Te3(BYTE(s[0], 0)) ^ (rk)[1];         \
+        d[2] = Te0(BYTE(s[2], 3)) ^ Te1(BYTE(s[3], 2)) ^ Te2(BYTE(s[0], 1)) ^ Te3(BYTE(s[1], 0)) ^ (rk)[2];         \
+        d[3] = Te0(BYTE(s[3], 3)) ^ Te1(BYTE(s[0], 2)) ^ Te2(BYTE(s[1], 1)) ^ Te3(BYTE(s[2], 0)) ^ (rk)[3];         \
+    } while (0)
+
+/**
+ * @brief Last table-based encryption round of a single lane, storing the result in the output block
+ *
+ * @param out Output block
+ * @param s Source state (4 words)
+ * @param rk Last round key
+ */
+#define TE_LAST_ROUND(out, s, rk)                                                                                                        \
+    do                                                                                                                                   \
+    {                                                                                                                                    \
+        uint32_t w;                                                                                                                      \
+        w = (Te4_3[BYTE(s[0], 3)]) ^ (Te4_2[BYTE(s[1], 2)]) ^ (Te4_1[BYTE(s[2], 1)]) ^ (Te4_0[BYTE(s[3], 0)]) ^ (rk)[0]; STORE32H(w, (out)); \
+        w = (Te4_3[BYTE(s[1], 3)]) ^ (Te4_2[BYTE(s[2], 2)]) ^ (Te4_1[BYTE(s[3], 1)]) ^ (Te4_0[BYTE(s[0], 0)]) ^ (rk)[1]; STORE32H(w, (out) + 4); \
+        w = (Te4_3[BYTE(s[2], 3)]) ^ (Te4_2[BYTE(s[3], 2)]) ^ (Te4_1[BYTE(s[0], 1)]) ^ (Te4_0[BYTE(s[1], 0)]) ^ (rk)[2]; STORE32H(w, (out) + 8); \
+        w = (Te4_3[BYTE(s[3], 3)]) ^ (Te4_2[BYTE(s[0], 2)]) ^ (Te4_1[BYTE(s[1], 1)]) ^ (Te4_0[BYTE(s[2], 0)]) ^ (rk)[3]; STORE32H(w, (out) + 12); \
+    } while (0)
+
+/**
+ * @brief One full table-based decryption round of a single lane of the multi-block kernel
+ *
+ * @param d Destination state (4 words)
+ * @param s Source state (4 words)
+ * @param rk Round key
+ */
+#define TD_ROUND(d, s, rk)                                                                                          \
+    do                                                                                                              \
+    {                                                                                                               \
+        d[0] = Td0(BYTE(s[0], 3)) ^ Td1(BYTE(s[3], 2)) ^ Td2(BYTE(s[2], 1)) ^ Td3(BYTE(s[1], 0)) ^ (rk)[0];         \
+        d[1] = Td0(BYTE(s[1], 3)) ^ Td1(BYTE(s[0], 2)) ^ Td2(BYTE(s[3], 1)) ^ Td3(BYTE(s[2], 0)) ^ (rk)[1];         \
+        d[2] = Td0(BYTE(s[2], 3)) ^ Td1(BYTE(s[1], 2)) ^ Td2(BYTE(s[0], 1)) ^ Td3(BYTE(s[3], 0)) ^ (rk)[2];         \
+        d[3] = Td0(BYTE(s[3], 3)) ^ Td1(BYTE(s[2], 2)) ^ Td2(BYTE(s[1], 1)) ^ Td3(BYTE(s[0], 0)) ^ (rk)[3];         \
+    } while (0)
+
+/**
+ * @brief Last table-based decryption round of a single lane, storing the result in the output block
+ *
+ * @param out Output block
+ * @param s Source state (4 words)
+ * @param rk Last round key
+ */
+#define TD_LAST_ROUND(out, s, rk)                                                                                     \
+    do                                                                                                                \
+    {                                                                                                                 \
+        uint32_t w;                                                                                                   \
+        w = (Td4[BYTE(s[0], 3)] & 0xff000000) ^ (Td4[BYTE(s[3], 2)] & 0x00ff0000)                                     \
+          ^ (Td4[BYTE(s[2], 1)] & 0x0000ff00) ^ (Td4[BYTE(s[1], 0)] & 0x000000ff) ^ (rk)[0]; STORE32H(w, (out));      \
+        w = (Td4[BYTE(s[1], 3)] & 0xff000000) ^ (Td4[BYTE(s[0], 2)] & 0x00ff0000)                                     \
+          ^ (Td4[BYTE(s[3], 1)] & 0x0000ff00) ^ (Td4[BYTE(s[2], 0)] & 0x000000ff) ^ (rk)[1]; STORE32H(w, (out) + 4);  \
+        w = (Td4[BYTE(s[2], 3)] & 0xff000000) ^ (Td4[BYTE(s[1], 2)] & 0x00ff0000)                                     \
+          ^ (Td4[BYTE(s[0], 1)] & 0x0000ff00) ^ (Td4[BYTE(s[3], 0)] & 0x000000ff) ^ (rk)[2]; STORE32H(w, (out) + 8);  \
+        w = (Td4[BYTE(s[3], 3)] & 0xff000000) ^ (Td4[BYTE(s[2], 2)] & 0x00ff0000)                                     \
+          ^ (Td4[BYTE(s[1], 1)] & 0x0000ff00) ^ (Td4[BYTE(s[0], 0)] & 0x000000ff) ^ (rk)[3]; STORE32H(w, (out) + 12); \
+    } while (0)
+
+/**
+ * @brief Load one block into a lane state and add the first round key
+ */
+#define TABLE_LOAD_LANE(s, in, rk) \
+    do                             \
+    {                              \
+        LOAD32H(s[0], (in));       \
+        LOAD32H(s[1], (in) + 4);   \
+        LOAD32H(s[2], (in) + 8);   \
+        LOAD32H(s[3], (in) + 12);  \
+        s[0] ^= (rk)[0];           \
+        s[1] ^= (rk)[1];           \
+        s[2] ^= (rk)[2];           \
+        s[3] ^= (rk)[3];           \
+    } while (0)
+
+void aes_table_encrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks){
+    uint32_t        a[4], b[4], c[4], d[4];
+    uint32_t        ta[4], tb[4], tc[4], td[4];
+    uint32_t const* rk;
+    uint_fast32_t   r;
+
+    // four independent lanes per iteration so the table lookups of one lane hide the latency of the others
+    for( ; nblocks >= AES_TABLE_PARALLEL_BLOCKS; nblocks -= AES_TABLE_PARALLEL_BLOCKS )
+    {
+        rk = Context->eK;
+        TABLE_LOAD_LANE( a, Input, rk );
+        TABLE_LOAD_LANE( b, Input + 16, rk );
+        TABLE_LOAD_LANE( c, Input + 32, rk );
+        TABLE_LOAD_LANE( d, Input + 48, rk );
+
+        for( r = 1; r < Context->Nr; r++ )
+        {
+            rk += 4;
+            TE_ROUND( ta, a, rk );
+            TE_ROUND( tb, b, rk );
+            TE_ROUND( tc, c, rk );
+            TE_ROUND( td, d, rk );
+            memcpy( a, ta, sizeof(a) );
+            memcpy( b, tb, sizeof(b) );
+            memcpy( c, tc, sizeof(c) );
+            memcpy( d, td, sizeof(d) );
+        }
+
+        rk += 4;
+        TE_LAST_ROUND( Output, a, rk );
+        TE_LAST_ROUND( Output + 16, b, rk );
+        TE_LAST_ROUND( Output + 32, c, rk );
+        TE_LAST_ROUND( Output + 48, d, rk );
+
+        Input  += AES_TABLE_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+        Output += AES_TABLE_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+    }
+
+    // remaining blocks
+    for( ; nblocks > 0; nblocks-- )
+    {
+        aes_table_encrypt( Context, Input, Output );
+        Input  += AES_BLOCK_SIZE;
+        Output += AES_BLOCK_SIZE;
+    }
+}
+
+void aes_table_decrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks){
+    uint32_t        a[4], b[4], c[4], d[4];
+    uint32_t        ta[4], tb[4], tc[4], td[4];
+    uint32_t const* rk;
+    uint_fast32_t   r;
+
+    // four independent lanes per iteration so the table lookups of one lane hide the latency of the others
+    for( ; nblocks >= AES_TABLE_PARALLEL_BLOCKS; nblocks -= AES_TABLE_PARALLEL_BLOCKS )
+    {
+        rk = Context->dK;
+        TABLE_LOAD_LANE( a, Input, rk );
+        TABLE_LOAD_LANE( b, Input + 16, rk );
+        TABLE_LOAD_LANE( c, Input + 32, rk );
+        TABLE_LOAD_LANE( d, Input + 48, rk );
+
+        for( r = 1; r < Context->Nr; r++ )
+        {
+            rk += 4;
+            TD_ROUND( ta, a, rk );
+            TD_ROUND( tb, b, rk );
+            TD_ROUND( tc, c, rk );
+            TD_ROUND( td, d, rk );
+            memcpy( a, ta, sizeof(a) );
+            memcpy( b, tb, sizeof(b) );
+            memcpy( c, tc, sizeof(c) );
+            memcpy( d, td, sizeof(d) );
+        }
+
+        rk += 4;
+        TD_LAST_ROUND( Output, a, rk );
+        TD_LAST_ROUND( Output + 16, b, rk );
+        TD_LAST_ROUND( Output + 32, c, rk );
+        TD_LAST_ROUND( Output + 48, d, rk );
+
+        Input  += AES_TABLE_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+        Output += AES_TABLE_PARALLEL_BLOCKS * AES_BLOCK_SIZE;
+    }
+
+    // remaining blocks
+    for( ; nblocks > 0; nblocks-- )
+    {
+        aes_table_decrypt( Context, Input, Output );
+        Input  += AES_BLOCK_SIZE;
+        Output += AES_BLOCK_SIZE;
+    }
+}
+
+//////////////////////////////////////////// SOFTWARE BITSLICED IMPLEMENTATION //////////////////////////////////////////
+
+// Each 64 bits lane of an aes_bs_word holds one bit plane of four blocks (blocks 4*l..4*l+3 in lane l), so one pass
+// of the circuits below processes AES_BITSLICED_PARALLEL_BLOCKS blocks in SSE2 (2 lanes) or AVX2 (4 lanes) registers.
+// There are no table lookups and no secret dependent branches or addresses.
+#define AES_BS_LANES (AES_BITSLICED_PARALLEL_BLOCKS / 4)
+typedef uint64_t aes_bs_word __attribute__((vector_size(8 * AES_BS_LANES)));
+
+// AES S-box as a boolean circuit (Boyar and Peralta, "A new combinational logic minimization technique with
+// applications to cryptology", 113 gates). q[0] holds the lowest bit of every byte and q[7] the highest one.
+static inline void aes_bs_sbox(aes_bs_word *q)
+{
+    aes_bs_word x0, x1, x2, x3, x4, x5, x6, x7;
+    aes_bs_word y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    aes_bs_word y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    aes_bs_word y20, y21;
+    aes_bs_word z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    aes_bs_word z10, z11, z12, z13, z14, z15, z16, z17;
+    aes_bs_word t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    aes_bs_word t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    aes_bs_word t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    aes_bs_word t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    aes_bs_word t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    aes_bs_word t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    aes_bs_word t60, t61, t62, t63, t64, t65, t66, t67;
+    aes_bs_word s0, s1, s2, s3, s4, s5, s6, s7;
+
+    // the circuit numbers the bits in reverse order (x0 is the highest bit)
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    // top linear transformation
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    // non-linear section (inversion in GF(2^8))
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    // bottom linear transformation
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+// Inverse of the affine transformation of the S-box (x <<< 1 ^ x <<< 3 ^ x <<< 6 ^ 0x05)
+static inline void aes_bs_inv_affine(aes_bs_word *q)
+{
+    aes_bs_word q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3];
+    aes_bs_word q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+// Inverse S-box: S(x) = A(inv(x)), so inv(y) = A^-1(S(A^-1(y)))
+static inline void aes_bs_inv_sbox(aes_bs_word *q)
+{
+    aes_bs_inv_affine(q);
+    aes_bs_sbox(q);
+    aes_bs_inv_affine(q);
+}
+
+// Transposition between the interleaved byte layout and the bitsliced layout (it is its own inverse)
+static inline void aes_bs_ortho(aes_bs_word *q)
+{
+    #define AES_BS_SWAPN(cl, ch, s, x, y)                  \
+        do                                                 \
+        {                                                  \
+            aes_bs_word a = (x), b = (y);                  \
+            (x) = (a & (uint64_t)(cl)) | ((b & (uint64_t)(cl)) << (s)); \
+            (y) = ((a & (uint64_t)(ch)) >> (s)) | (b & (uint64_t)(ch)); \
+        } while (0)
+    #define AES_BS_SWAP2(x, y) AES_BS_SWAPN(0x5555555555555555, 0xAAAAAAAAAAAAAAAA, 1, x, y)
+    #define AES_BS_SWAP4(x, y) AES_BS_SWAPN(0x3333333333333333, 0xCCCCCCCCCCCCCCCC, 2, x, y)
+    #define AES_BS_SWAP8(x, y) AES_BS_SWAPN(0x0F0F0F0F0F0F0F0F, 0xF0F0F0F0F0F0F0F0, 4, x, y)
+
+    AES_BS_SWAP2(q[0], q[1]);
+    AES_BS_SWAP2(q[2], q[3]);
+    AES_BS_SWAP2(q[4], q[5]);
+    AES_BS_SWAP2(q[6], q[7]);
+
+    AES_BS_SWAP4(q[0], q[2]);
+    AES_BS_SWAP4(q[1], q[3]);
+    AES_BS_SWAP4(q[4], q[6]);
+    AES_BS_SWAP4(q[5], q[7]);
+
+    AES_BS_SWAP8(q[0], q[4]);
+    AES_BS_SWAP8(q[1], q[5]);
+    AES_BS_SWAP8(q[2], q[6]);
+    AES_BS_SWAP8(q[3], q[7]);
+
+    #undef AES_BS_SWAP8
+    #undef AES_BS_SWAP4
+    #undef AES_BS_SWAP2
+    #undef AES_BS_SWAPN
+}
+
+// Interleave the four little endian words w0..w3 of one block (per lane) into two words of the byte layout
+static inline void aes_bs_interleave_in(aes_bs_word *q0, aes_bs_word *q1, aes_bs_word x0, aes_bs_word x1, aes_bs_word x2, aes_bs_word x3)
+{
+    x0 |= (x0 << 16);
+    x1 |= (x1 << 16);
+    x2 |= (x2 << 16);
+    x3 |= (x3 << 16);
+    x0 &= (uint64_t)0x0000FFFF0000FFFF;
+    x1 &= (uint64_t)0x0000FFFF0000FFFF;
+    x2 &= (uint64_t)0x0000FFFF0000FFFF;
+    x3 &= (uint64_t)0x0000FFFF0000FFFF;
+    x0 |= (x0 << 8);
+    x1 |= (x1 << 8);
+    x2 |= (x2 << 8);
+    x3 |= (x3 << 8);
+    x0 &= (uint64_t)0x00FF00FF00FF00FF;
+    x1 &= (uint64_t)0x00FF00FF00FF00FF;
+    x2 &= (uint64_t)0x00FF00FF00FF00FF;
+    x3 &= (uint64_t)0x00FF00FF00FF00FF;
+    *q0 = x0 | (x2 << 8);
+    *q1 = x1 | (x3 << 8);
+}
+
+// Inverse of aes_bs_interleave_in, the four words of the block are left in the low 32 bits of x[0..3]
+static inline void aes_bs_interleave_out(aes_bs_word x[4], aes_bs_word q0, aes_bs_word q1)
+{
+    x[0] = q0 & (uint64_t)0x00FF00FF00FF00FF;
+    x[1] = q1 & (uint64_t)0x00FF00FF00FF00FF;
+    x[2] = (q0 >> 8) & (uint64_t)0x00FF00FF00FF00FF;
+    x[3] = (q1 >> 8) & (uint64_t)0x00FF00FF00FF00FF;
+    for (int i = 0; i < 4; i++)
+    {
+        x[i] |= (x[i] >> 8);
+        x[i] &= (uint64_t)0x0000FFFF0000FFFF;
+        x[i] |= (x[i] >> 16);
+    }
+}
+
+static inline void aes_bs_add_round_key(aes_bs_word *q, const uint64_t *sk)
+{
+    for (int i = 0; i < 8; i++)
+        q[i] ^= sk[i];
+}
+
+static inline void aes_bs_shift_rows(aes_bs_word *q)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        aes_bs_word x = q[i];
+        q[i] = (x & (uint64_t)0x000000000000FFFF)
+             | ((x & (uint64_t)0x00000000FFF00000) >> 4)
+             | ((x & (uint64_t)0x00000000000F0000) << 12)
+             | ((x & (uint64_t)0x0000FF0000000000) >> 8)
+             | ((x & (uint64_t)0x000000FF00000000) << 8)
+             | ((x & (uint64_t)0xF000000000000000) >> 12)
+             | ((x & (uint64_t)0x0FFF000000000000) << 4);
+    }
+}
+
+static inline void aes_bs_inv_shift_rows(aes_bs_word *q)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        aes_bs_word x = q[i];
+        q[i] = (x & (uint64_t)0x000000000000FFFF)
+             | ((x & (uint64_t)0x000000000FFF0000) << 4)
+             | ((x & (uint64_t)0x00000000F0000000) >> 12)
+             | ((x & (uint64_t)0x000000FF00000000) << 8)
+             | ((x & (uint64_t)0x0000FF0000000000) >> 8)
+             | ((x & (uint64_t)0x000F000000000000) << 12)
+             | ((x & (uint64_t)0xFFF0000000000000) >> 4);
+    }
+}
+
+#define AES_BS_ROTR16(x) (((x) >> 16) | ((x) << 48))
+#define AES_BS_ROTR32(x) (((x) >> 32) | ((x) << 32))
+
+static inline void aes_bs_mix_columns(aes_bs_word *q)
+{
+    aes_bs_word q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    aes_bs_word r0 = AES_BS_ROTR16(q0), r1 = AES_BS_ROTR16(q1), r2 = AES_BS_ROTR16(q2), r3 = AES_BS_ROTR16(q3);
+    aes_bs_word r4 = AES_BS_ROTR16(q4), r5 = AES_BS_ROTR16(q5), r6 = AES_BS_ROTR16(q6), r7 = AES_BS_ROTR16(q7);
+
+    q[0] = q7 ^ r7 ^ r0 ^ AES_BS_ROTR32(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ AES_BS_ROTR32(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ AES_BS_ROTR32(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ AES_BS_ROTR32(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ AES_BS_ROTR32(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ AES_BS_ROTR32(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ AES_BS_ROTR32(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ AES_BS_ROTR32(q7 ^ r7);
+}
+
+static inline void aes_bs_inv_mix_columns(aes_bs_word *q)
+{
+    aes_bs_word q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3], q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    aes_bs_word r0 = AES_BS_ROTR16(q0), r1 = AES_BS_ROTR16(q1), r2 = AES_BS_ROTR16(q2), r3 = AES_BS_ROTR16(q3);
+    aes_bs_word r4 = AES_BS_ROTR16(q4), r5 = AES_BS_ROTR16(q5), r6 = AES_BS_ROTR16(q6), r7 = AES_BS_ROTR16(q7);
+
+    q[0] = q5 ^ q6 ^ q7 ^ r0 ^ r5 ^ r7 ^ AES_BS_ROTR32(q0 ^ q5 ^ q6 ^ r0 ^ r5);
+    q[1] = q0 ^ q5 ^ r0 ^ r1 ^ r5 ^ r6 ^ r7 ^ AES_BS_ROTR32(q1 ^ q5 ^ q7 ^ r1 ^ r5 ^ r6);
+    q[2] = q0 ^ q1 ^ q6 ^ r1 ^ r2 ^ r6 ^ r7 ^ AES_BS_ROTR32(q0 ^ q2 ^ q6 ^ r2 ^ r6 ^ r7);
+    q[3] = q0 ^ q1 ^ q2 ^ q5 ^ q6 ^ r0 ^ r2 ^ r3 ^ r5 ^ AES_BS_ROTR32(q0 ^ q1 ^ q3 ^ q5 ^ q6 ^ q7 ^ r0 ^ r3 ^ r5 ^ r7);
+    q[4] = q1 ^ q2 ^ q3 ^ q5 ^ r1 ^ r3 ^ r4 ^ r5 ^ r6 ^ r7 ^ AES_BS_ROTR32(q1 ^ q2 ^ q4 ^ q5 ^ q7 ^ r1 ^ r4 ^ r5 ^ r6);
+    q[5] = q2 ^ q3 ^ q4 ^ q6 ^ r2 ^ r4 ^ r5 ^ r6 ^ r7 ^ AES_BS_ROTR32(q2 ^ q3 ^ q5 ^ q6 ^ r2 ^ r5 ^ r6 ^ r7);
+    q[6] = q3 ^ q4 ^ q5 ^ q7 ^ r3 ^ r5 ^ r6 ^ r7 ^ AES_BS_ROTR32(q3 ^ q4 ^ q6 ^ q7 ^ r3 ^ r6 ^ r7);
+    q[7] = q4 ^ q5 ^ q6 ^ r4 ^ r6 ^ r7 ^ AES_BS_ROTR32(q4 ^ q5 ^ q7 ^ r4 ^ r7);
+}
+
+// Load up to AES_BITSLICED_PARALLEL_BLOCKS blocks into the bitsliced state, missing blocks are zero
+static inline void aes_bs_load(aes_bs_word *q, uint8_t const* Input, size_t nblocks)
+{
+    uint32_t w[AES_BITSLICED_PARALLEL_BLOCKS][4] = {{0}};
+    aes_bs_word x[4];
+
+    memcpy(w, Input, nblocks * AES_BLOCK_SIZE); // little endian words as in the interleaved layout
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+            for (int l = 0; l < AES_BS_LANES; l++)
+                x[j][l] = w[4 * l + i][j];
+        aes_bs_interleave_in(&q[i], &q[i + 4], x[0], x[1], x[2], x[3]);
+    }
+    aes_bs_ortho(q);
+}
+
+// Store the first nblocks blocks of the bitsliced state
+static inline void aes_bs_store(aes_bs_word *q, uint8_t* Output, size_t nblocks)
+{
+    uint32_t w[AES_BITSLICED_PARALLEL_BLOCKS][4];
+    aes_bs_word x[4];
+
+    aes_bs_ortho(q);
+    for (int i = 0; i < 4; i++)
+    {
+        aes_bs_interleave_out(x, q[i], q[i + 4]);
+        for (int j = 0; j < 4; j++)
+            for (int l = 0; l < AES_BS_LANES; l++)
+                w[4 * l + i][j] = (uint32_t)x[j][l];
+    }
+    memcpy(Output, w, nblocks * AES_BLOCK_SIZE);
+}
+
+// Key schedule on little endian words with a caller provided SubWord, shared by the constant time implementations
+// (the table-based one looks up Te4 with key dependent indexes). Returns the number of rounds.
+static uint_fast32_t aes_ct_key_schedule(uint32_t skey[60], void const* Key, uint32_t KeySize, uint32_t (*sub_word)(uint32_t))
+{
+    static const uint8_t ct_rcon[10] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36};
+    uint_fast32_t rounds = 10 + ((KeySize/8)-2)*2;
+    int nk = KeySize / 4;
+    int nkf = (rounds + 1) * 4;
+    uint32_t tmp;
+
+    memcpy(skey, Key, nk * 4);
+    tmp = skey[nk - 1];
+    for (int i = nk, j = 0, k = 0; i < nkf; i++)
+    {
+        if (j == 0)
+        {
+            tmp = (tmp << 24) | (tmp >> 8);
+            tmp = sub_word(tmp) ^ ct_rcon[k];
+        }
+        else if (nk > 6 && j == 4)
+        {
+            tmp = sub_word(tmp);
+        }
+        tmp ^= skey[i - nk];
+        skey[i] = tmp;
+        if (++j == nk)
+        {
+            j = 0;
+            k++;
+        }
+    }
+    return rounds;
+}
+
+// SubWord of the key schedule through the bitsliced S-box, so the key expansion is constant time as well
+static uint32_t aes_bs_sub_word(uint32_t x)
+{
+    aes_bs_word q[8] = {{0}};
+
+    q[0][0] = x;
+    aes_bs_ortho(q);
+    aes_bs_sbox(q);
+    aes_bs_ortho(q);
+    return (uint32_t)q[0][0];
+}
+
+void aes_bitsliced_key_expansion(AesContext* Context, void const* Key, uint32_t KeySize){
+    uint32_t skey[60];
+    aes_bs_word q[8];
+    aes_bs_word x[4];
+
+    Context->Nr = aes_ct_key_schedule(skey, Key, KeySize, aes_bs_sub_word);
+
+    // each round key is replicated in the four blocks of a lane and converted to the bitsliced layout
+    for (uint_fast32_t r = 0; r <= Context->Nr; r++)
+    {
+        uint32_t const* w = skey + 4 * r;
+        for (int j = 0; j < 4; j++)
+            for (int l = 0; l < AES_BS_LANES; l++)
+                x[j][l] = w[j];
+        for (int i = 0; i < 4; i++)
+            aes_bs_interleave_in(&q[i], &q[i + 4], x[0], x[1], x[2], x[3]);
+        aes_bs_ortho(q);
+        for (int i = 0; i < 8; i++)
+            Context->BK[8 * r + i] = q[i][0];
+    }
+
+    memset(skey, 0, sizeof(skey));
+    memset(q, 0, sizeof(q));
+    memset(x, 0, sizeof(x));
+}
+
+void aes_bitsliced_encrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks){
+    aes_bs_word q[8];
+    uint_fast32_t rounds = Context->Nr;
+
+    while (nblocks > 0)
+    {
+        size_t n = (nblocks < AES_BITSLICED_PARALLEL_BLOCKS) ? nblocks : AES_BITSLICED_PARALLEL_BLOCKS;
+
+        aes_bs_load(q, Input, n);
+        aes_bs_add_round_key(q, Context->BK);
+        for (uint_fast32_t r = 1; r < rounds; r++)
+        {
+            aes_bs_sbox(q);
+            aes_bs_shift_rows(q);
+            aes_bs_mix_columns(q);
+            aes_bs_add_round_key(q, Context->BK + 8 * r);
+        }
+        aes_bs_sbox(q);
+        aes_bs_shift_rows(q);
+        aes_bs_add_round_key(q, Context->BK + 8 * rounds);
+        aes_bs_store(q, Output, n);
+
+        Input += n * AES_BLOCK_SIZE;
+        Output += n * AES_BLOCK_SIZE;
+        nblocks -= n;
+    }
+}
+
+void aes_bitsliced_decrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks){
+    aes_bs_word q[8];
+    uint_fast32_t rounds = Context->Nr;
+
+    while (nblocks > 0)
+    {
+        size_t n = (nblocks < AES_BITSLICED_PARALLEL_BLOCKS) ? nblocks : AES_BITSLICED_PARALLEL_BLOCKS;
+
+        aes_bs_load(q, Input, n);
+        aes_bs_add_round_key(q, Context->BK + 8 * rounds);
+        for (uint_fast32_t r = rounds - 1; r > 0; r--)
+        {
+            aes_bs_inv_shift_rows(q);
+            aes_bs_inv_sbox(q);
+            aes_bs_add_round_key(q, Context->BK + 8 * r);
+            aes_bs_inv_mix_columns(q);
+        }
+        aes_bs_inv_shift_rows(q);
+        aes_bs_inv_sbox(q);
+        aes_bs_add_round_key(q, Context->BK);
+        aes_bs_store(q, Output, n);
+
+        Input += n * AES_BLOCK_SIZE;
+        Output += n * AES_BLOCK_SIZE;
+        nblocks -= n;
+    }
+}
+
+//////////////////////////////////////////// SOFTWARE SSSE3 VECTOR PERMUTE IMPLEMENTATION //////////////////////////////////////////
+
+// The S-box is computed with 16 entries PSHUFB lookups only. A byte is mapped (GF(2)-linear, two nibble lookups) to
+// GF(16)[t]/(t^2 + 2t + 2) as x = i*t + k (GF(16) modulo z^4 + z + 1), with i and k the high and low nibbles.
+// In that basis x^-1 can be recovered from io = N(x)/(k + 2i) and jo = N(x)/(k + 2j), j = i ^ k, which only need
+// 1/v and 2/v lookups: io = 1/(1/i + 2/k) + j and jo = 1/(1/j + 2/k) + i. Two more nibble lookups map (io, jo)
+// back to the AES basis, including the affine transformation. 1/0 is encoded as 0x80, which PSHUFB turns into 0,
+// so the zero cases need no branches.
+
+#define AES_VPERM_CONSTANTS()                                                                                                                    \
+    const __m128i vp_m0f    = _mm_set1_epi8(0x0F);                                                                                               \
+    const __m128i vp_inv    = _mm_setr_epi8(0x80, 0x01, 0x09, 0x0E, 0x0D, 0x0B, 0x07, 0x06, 0x0F, 0x02, 0x0C, 0x05, 0x0A, 0x04, 0x03, 0x08); \
+    const __m128i vp_2inv   = _mm_setr_epi8(0x80, 0x02, 0x01, 0x0F, 0x09, 0x05, 0x0E, 0x0C, 0x0D, 0x04, 0x0B, 0x0A, 0x07, 0x08, 0x06, 0x03)
+
+// forward S-box: input basis change, output basis change with the affine transformation (0x63 added apart)
+#define AES_VPERM_ENC_CONSTANTS()                                                                                                                \
+    AES_VPERM_CONSTANTS();                                                                                                                       \
+    const __m128i vp_in_lo  = _mm_setr_epi8(0x00, 0x01, 0x1C, 0x1D, 0x2D, 0x2C, 0x31, 0x30, 0x27, 0x26, 0x3B, 0x3A, 0x0A, 0x0B, 0x16, 0x17); \
+    const __m128i vp_in_hi  = _mm_setr_epi8(0x00, 0x86, 0xFD, 0x7B, 0x8E, 0x08, 0x73, 0xF5, 0x77, 0xF1, 0x8A, 0x0C, 0xF9, 0x7F, 0x04, 0x82); \
+    const __m128i vp_out_io = _mm_setr_epi8(0x00, 0xCB, 0xD7, 0xB0, 0x21, 0x8D, 0x67, 0xAC, 0x7B, 0x5A, 0xEA, 0x3D, 0x46, 0xF6, 0x91, 0x1C); \
+    const __m128i vp_out_jo = _mm_setr_epi8(0x00, 0x9F, 0x61, 0x16, 0xC2, 0x2A, 0x77, 0xE8, 0x89, 0x4B, 0x5D, 0x3C, 0xB5, 0xA3, 0xD4, 0xFE); \
+    const __m128i vp_out_c  = _mm_set1_epi8(0x63)
+
+// inverse S-box: the inverse affine transformation is folded in the input basis change
+#define AES_VPERM_DEC_CONSTANTS()                                                                                                                \
+    AES_VPERM_CONSTANTS();                                                                                                                       \
+    const __m128i vp_in_lo  = _mm_setr_epi8(0x2C, 0x99, 0xF0, 0x45, 0xF7, 0x42, 0x2B, 0x9E, 0x38, 0x8D, 0xE4, 0x51, 0xE3, 0x56, 0x3F, 0x8A); \
+    const __m128i vp_in_hi  = _mm_setr_epi8(0x00, 0xA7, 0xA8, 0x0F, 0xED, 0x4A, 0x45, 0xE2, 0xD1, 0x76, 0x79, 0xDE, 0x3C, 0x9B, 0x94, 0x33); \
+    const __m128i vp_out_io = _mm_setr_epi8(0x00, 0x3B, 0xE4, 0xC8, 0x03, 0x14, 0x2C, 0x17, 0xF3, 0xF0, 0x38, 0xDC, 0x2F, 0xE7, 0xCB, 0xDF); \
+    const __m128i vp_out_jo = _mm_setr_epi8(0x00, 0x24, 0x91, 0x19, 0x23, 0x8F, 0x88, 0xAC, 0x3D, 0x1E, 0x07, 0x96, 0xAB, 0xB2, 0x3A, 0xB5); \
+    const __m128i vp_out_c  = _mm_setzero_si128()
+
+// SubBytes (or InvSubBytes) of the 16 bytes of x with the constants declared by AES_VPERM_ENC/DEC_CONSTANTS
+#define AES_VPERM_SUB_BYTES(x)                                                                                         \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        __m128i vp_k, vp_i, vp_j, vp_ak, vp_iak, vp_jak;                                                               \
+        vp_k = _mm_and_si128(x, vp_m0f);                                                                               \
+        vp_i = _mm_and_si128(_mm_srli_epi32(x, 4), vp_m0f);                                                            \
+        x = _mm_xor_si128(_mm_shuffle_epi8(vp_in_lo, vp_k), _mm_shuffle_epi8(vp_in_hi, vp_i));                         \
+        vp_k = _mm_and_si128(x, vp_m0f);                                                                               \
+        vp_i = _mm_and_si128(_mm_srli_epi32(x, 4), vp_m0f);                                                            \
+        vp_j = _mm_xor_si128(vp_i, vp_k);                                                                              \
+        vp_ak = _mm_shuffle_epi8(vp_2inv, vp_k);                                                                       \
+        vp_iak = _mm_xor_si128(_mm_shuffle_epi8(vp_inv, vp_i), vp_ak);                                                 \
+        vp_jak = _mm_xor_si128(_mm_shuffle_epi8(vp_inv, vp_j), vp_ak);                                                 \
+        vp_iak = _mm_xor_si128(_mm_shuffle_epi8(vp_inv, vp_iak), vp_j);                                                \
+        vp_jak = _mm_xor_si128(_mm_shuffle_epi8(vp_inv, vp_jak), vp_i);                                                \
+        x = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(vp_out_io, vp_iak), _mm_shuffle_epi8(vp_out_jo, vp_jak)),     \
+                          vp_out_c);                                                                                   \
+    } while (0)
+
+// multiplication by 2 in GF(2^8) of the 16 bytes
+#define AES_VPERM_XTIME(x) \
+    _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(_mm_cmplt_epi8(x, _mm_setzero_si128()), _mm_set1_epi8(0x1B)))
+
+__attribute__((target("ssse3")))
+static inline __m128i aes_vperm_mix_columns(__m128i x)
+{
+    const __m128i rot1 = _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    const __m128i rot2 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    __m128i r1 = _mm_shuffle_epi8(x, rot1);
+    __m128i t = _mm_xor_si128(x, r1);
+
+    // b[i] = 2(a[i] ^ a[i+1]) ^ a[i+1] ^ a[i+2] ^ a[i+3]
+    return _mm_xor_si128(_mm_xor_si128(AES_VPERM_XTIME(t), r1), _mm_shuffle_epi8(t, rot2));
+}
+
+__attribute__((target("ssse3")))
+static inline __m128i aes_vperm_inv_mix_columns(__m128i x)
+{
+    const __m128i rot2 = _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    __m128i t = _mm_xor_si128(x, _mm_shuffle_epi8(x, rot2));
+
+    // InvMixColumns = MixColumns after multiplying the columns by {05, 00, 04, 00}
+    t = AES_VPERM_XTIME(t);
+    t = AES_VPERM_XTIME(t);
+    return aes_vperm_mix_columns(_mm_xor_si128(x, t));
+}
+
+__attribute__((target("ssse3")))
+static uint32_t aes_vperm_sub_word(uint32_t w)
+{
+    AES_VPERM_ENC_CONSTANTS();
+    __m128i x = _mm_cvtsi32_si128((int)w);
+
+    AES_VPERM_SUB_BYTES(x);
+    return (uint32_t)_mm_cvtsi128_si32(x);
+}
+
+void aes_vperm_key_expansion(AesContext* Context, void const* Key, uint32_t KeySize){
+    uint32_t skey[60];
+
+    Context->Nr = aes_ct_key_schedule(skey, Key, KeySize, aes_vperm_sub_word);
+    for (uint_fast32_t r = 0; r <= Context->Nr; r++)
+        Context->HK[r] = _mm_loadu_si128((const __m128i *)(skey + 4 * r)); // round keys in byte order as with AES-NI
+    memset(skey, 0, sizeof(skey));
+}
+
+__attribute__((target("ssse3")))
+void aes_vperm_encrypt(AesContext const* Context, uint8_t const Input [AES_BLOCK_SIZE], uint8_t Output [AES_BLOCK_SIZE]){
+    AES_VPERM_ENC_CONSTANTS();
+    const __m128i shift_rows = _mm_setr_epi8(0, 5, 10, 15, 4, 9, 14, 3, 8, 13, 2, 7, 12, 1, 6, 11);
+    const __m128i *rk = Context->HK;
+    uint_fast32_t rounds = Context->Nr;
+    __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)Input), rk[0]);
+
+    for (uint_fast32_t r = 1; r < rounds; r++)
+    {
+        AES_VPERM_SUB_BYTES(x);
+        x = aes_vperm_mix_columns(_mm_shuffle_epi8(x, shift_rows));
+        x = _mm_xor_si128(x, rk[r]);
+    }
+    AES_VPERM_SUB_BYTES(x);
+    x = _mm_xor_si128(_mm_shuffle_epi8(x, shift_rows), rk[rounds]);
+    _mm_storeu_si128((__m128i *)Output, x);
+}
+
+__attribute__((target("ssse3")))
+void aes_vperm_decrypt(AesContext const* Context, uint8_t const Input [AES_BLOCK_SIZE], uint8_t Output [AES_BLOCK_SIZE]){
+    AES_VPERM_DEC_CONSTANTS();
+    const __m128i inv_shift_rows = _mm_setr_epi8(0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3);
+    const __m128i *rk = Context->HK;
+    uint_fast32_t rounds = Context->Nr;
+    __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)Input), rk[rounds]);
+
+    for (uint_fast32_t r = rounds - 1; r > 0; r--)
+    {
+        x = _mm_shuffle_epi8(x, inv_shift_rows);
+        AES_VPERM_SUB_BYTES(x);
+        x = aes_vperm_inv_mix_columns(_mm_xor_si128(x, rk[r]));
+    }
+    x = _mm_shuffle_epi8(x, inv_shift_rows);
+    AES_VPERM_SUB_BYTES(x);
+    _mm_storeu_si128((__m128i *)Output, _mm_xor_si128(x, rk[0]));
+}
+
 //////////////////////////////////////////// AES API IMPLEMENTATION //////////////////////////////////////////
 int API_AES_checkHWsupport(){
-    AES_implement = supportsAESNI()? hardware_AES_NI : software_table_based_aes;
+    if(supportsAESNI()){
+        int vaes_width = supportsVAES();
+        AES_implement = (vaes_width == 512) ? hardware_VAES_512 : (vaes_width == 256) ? hardware_VAES_256 : hardware_AES_NI;
+    }
+    else{
+        AES_implement = supportsSSSE3() ? software_vperm_aes : software_bitsliced_aes;
+    }
+    return AES_implement;
+}
+
+AES_implementation API_AES_getImplementation(){
     return AES_implement;
 }
 
 int API_AES_initkey (AesContext* Context, void const* Key, uint32_t KeySize){
-    if(AES_implement == hardware_AES_NI){
+    if(AES_IMPLEMENTATION_IS_AESNI(AES_implement)){
         aes_ni_keyexpansion(Context,Key,KeySize);
     }
+    else if(AES_implement == software_bitsliced_aes){
+        aes_table_key_expansion(Context,Key,KeySize); // single block operations
+        aes_bitsliced_key_expansion(Context,Key,KeySize);
+    }
+    else if(AES_implement == software_vperm_aes){
+        aes_vperm_key_expansion(Context,Key,KeySize);
+        aes_bitsliced_key_expansion(Context,Key,KeySize); // multi-block operations
+    }
     else{
         aes_table_key_expansion(Context,Key,KeySize);
     }
@@ -1172,9 +2293,12 @@ int API_AES_initkey (AesContext* Context, void const* Key, uint32_t KeySize){
 
 
 void API_AES_encrypt_block(AesContext const* Context, uint8_t const Input [AES_BLOCK_SIZE], uint8_t Output [AES_BLOCK_SIZE]) {
-    if(AES_implement == hardware_AES_NI){
+    if(AES_IMPLEMENTATION_IS_AESNI(AES_implement)){
         aes_aesni_encrypt(Context->HK,Context->Nr,Input,Output);
     }
+    else if(AES_implement == software_vperm_aes){
+        aes_vperm_encrypt(Context,Input,Output);
+    }
     else{
         aes_table_encrypt(Context,Input,Output);
     }
@@ -1182,11 +2306,73 @@ void API_AES_encrypt_block(AesContext const* Context, uint8_t const Input [AES_B
 
 
 void API_AES_decrypt_block(AesContext const* Context, uint8_t const Input [AES_BLOCK_SIZE], uint8_t Output [AES_BLOCK_SIZE]) {
-    if(AES_implement == hardware_AES_NI){
+    if(AES_IMPLEMENTATION_IS_AESNI(AES_implement)){
         aes_aesni_decrypt(Context->HK,Context->Nr,Input,Output);
     }
+    else if(AES_implement == software_vperm_aes){
+        aes_vperm_decrypt(Context,Input,Output);
+    }
     else{
         aes_table_decrypt(Context,Input,Output);
     }
 }
 
+
+void API_AES_encrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks) {
+    if(AES_implement == hardware_VAES_512){
+        aes_vaes512_encrypt_blocks(Context->HK,Context->Nr,Input,Output,nblocks);
+    }
+    else if(AES_implement == hardware_VAES_256){
+        aes_vaes256_encrypt_blocks(Context->HK,Context->Nr,Input,Output,nblocks);
+    }
+    else if(AES_IMPLEMENTATION_IS_AESNI(AES_implement)){
+        aes_aesni_encrypt_blocks(Context->HK,Context->Nr,Input,Output,nblocks);
+    }
+    else if(AES_implement == software_vperm_aes){
+        // complete bitsliced batches, a short tail is cheaper block by block than a padded batch
+        size_t tail = nblocks % AES_BITSLICED_PARALLEL_BLOCKS;
+        if(tail > AES_BITSLICED_PARALLEL_BLOCKS / 2){
+            tail = 0;
+        }
+        aes_bitsliced_encrypt_blocks(Context,Input,Output,nblocks - tail);
+        for(size_t i = nblocks - tail; i < nblocks; i++){
+            aes_vperm_encrypt(Context,Input + i * AES_BLOCK_SIZE,Output + i * AES_BLOCK_SIZE);
+        }
+    }
+    else if(AES_implement == software_bitsliced_aes){
+        aes_bitsliced_encrypt_blocks(Context,Input,Output,nblocks);
+    }
+    else{
+        aes_table_encrypt_blocks(Context,Input,Output,nblocks);
+    }
+}
+
+
+void API_AES_decrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks) {
+    if(AES_implement == hardware_VAES_512){
+        aes_vaes512_decrypt_blocks(Context->HK,Context->Nr,Input,Output,nblocks);
+    }
+    else if(AES_implement == hardware_VAES_256){
+        aes_vaes256_decrypt_blocks(Context->HK,Context->Nr,Input,Output,nblocks);
+    }
+    else if(AES_IMPLEMENTATION_IS_AESNI(AES_implement)){
+        aes_aesni_decrypt_blocks(Context->HK,Context->Nr,Input,Output,nblocks);
+    }
+    else if(AES_implement == software_vperm_aes){
+        // complete bitsliced batches, a short tail is cheaper block by block than a padded batch
+        size_t tail = nblocks % AES_BITSLICED_PARALLEL_BLOCKS;
+        if(tail > AES_BITSLICED_PARALLEL_BLOCKS / 2){
+            tail = 0;
+        }
+        aes_bitsliced_decrypt_blocks(Context,Input,Output,nblocks - tail);
+        for(size_t i = nblocks - tail; i < nblocks; i++){
+            aes_vperm_decrypt(Context,Input + i * AES_BLOCK_SIZE,Output + i * AES_BLOCK_SIZE);
+        }
+    }
+    else if(AES_implement == software_bitsliced_aes){
+        aes_bitsliced_decrypt_blocks(Context,Input,Output,nblocks);
+    }
+    else{
+        aes_table_decrypt_blocks(Context,Input,Output,nblocks);
+    }
+}
@@ -13,6 +13,7 @@
 #include <stdint.h>
 #include <memory.h>
 #include <wmmintrin.h> // for use of hardware AES core in x86 implementations
+#include <immintrin.h> // for the VAES (AVX2 / AVX-512) wide implementations
 #include <cpuid.h>     // for checking the support of AES-NI
 
 /****************************************************************************************************************
@@ -43,6 +44,35 @@
  */
 #define AES_BLOCK_SIZE 16
 
+/**
+ * @brief Number of blocks kept in flight by the AES-NI multi-block kernels
+ *
+ */
+#define AES_PARALLEL_BLOCKS 8
+
+/**
+ * @brief Number of blocks kept in flight by the table-based multi-block kernels
+ *
+ */
+#define AES_TABLE_PARALLEL_BLOCKS 4
+
+/**
+ * @brief Number of blocks kept in flight by the VAES multi-block kernels (8 ymm or 4 zmm registers)
+ *
+ */
+#define AES_VAES_PARALLEL_BLOCKS 16
+
+/**
+ * @brief Number of blocks processed together by the bitsliced software implementation
+ *
+ * Each 64 bits lane of a register holds 4 blocks: two lanes (8 blocks) with SSE2, four lanes (16 blocks) with AVX2.
+ */
+#ifdef __AVX2__
+#define AES_BITSLICED_PARALLEL_BLOCKS 16
+#else
+#define AES_BITSLICED_PARALLEL_BLOCKS 8
+#endif
+
 /**
  * @brief AES context that must be initialized using API_AES_initkey
  *
@@ -52,13 +82,16 @@
  */
 typedef struct AesContext
 {
-    __m128i HK[27];   /**< Expanded cipher and decipher keys for hardware AES-NI implementations.
+    __m128i HK[28];   /**< Expanded cipher and decipher keys for hardware AES-NI implementations (15 cipher + 13 decipher keys for AES-256).
                            The __m128i type is used for 128-bit SSE instructions. The array size
                            is sufficient to hold keys for the maximum number of rounds. */
     uint32_t eK[60];  /**< Expanded cipher keys for software table-based implementations.
                            The array size accommodates the maximum key schedule length for AES-256. */
     uint32_t dK[60];  /**< Expanded decipher keys for software table-based implementations.
                            Like eK, this array size is designed for the AES-256 key schedule. */
+    uint64_t BK[120]; /**< Round keys in bitsliced layout for the software bitsliced implementation,
+                           8 words per round key (15 round keys for AES-256). */
+                      /**< The SSSE3 vector permute implementation keeps its round keys in HK[0..Nr]. */
     uint_fast32_t Nr; /**< Number of rounds for the AES algorithm.
                            The value of Nr depends on the key size: 10 rounds for AES-128,
                            12 rounds for AES-192, and 14 rounds for AES-256. */
@@ -74,9 +107,20 @@ typedef enum AES_implementation
 {
     still_to_check,           /**< Initial state, yet to be checked */
     software_table_based_aes, /**< Use the software table-based AES implementation */
-    hardware_AES_NI           /**< Use the hardware-based AES-NI implementation */
+    software_bitsliced_aes,   /**< Constant time bitsliced software implementation for multi-block operations,
+                                   single blocks still use the table-based implementation */
+    software_vperm_aes,       /**< Constant time SSSE3 vector permute implementation for single blocks,
+                                   bitsliced implementation for multi-block operations */
+    hardware_AES_NI,          /**< Use the hardware-based AES-NI implementation */
+    hardware_VAES_256,        /**< AES-NI plus VAES on 256 bits registers (AVX2), two blocks per instruction */
+    hardware_VAES_512         /**< AES-NI plus VAES on 512 bits registers (AVX-512), four blocks per instruction */
 } AES_implementation;
 
+/**
+ * @brief True if the implementation uses the AES-NI key schedule and single block routines (AES-NI and VAES tiers)
+ */
+#define AES_IMPLEMENTATION_IS_AESNI(impl) ((impl) == hardware_AES_NI || (impl) == hardware_VAES_256 || (impl) == hardware_VAES_512)
+
 /* Macros............................................................ */
 #define Te0(x) TE0[x]
 #define Te1(x) TE1[x]
@@ -108,6 +152,43 @@ typedef enum AES_implementation
 #define ROLc(x, y) ((((uint32_t)(x) << (uint32_t)((y) & 31)) | (((uint32_t)(x) & 0xFFFFFFFFUL) >> (uint32_t)((32 - ((y) & 31)) & 31))) & 0xFFFFFFFFUL)
 #define RORc(x, y) (((((uint32_t)(x) & 0xFFFFFFFFUL) >> (uint32_t)((y) & 31)) | ((uint32_t)(x) << (uint32_t)((32 - ((y) & 31)) & 31))) & 0xFFFFFFFFUL)
 
+/**
+ * @brief Apply one AES-NI instruction to the eight interleaved states of the multi-block kernels (s0..s7 must be in scope)
+ *
+ * The eight states are independent, so the processor can keep its AES pipeline full instead
+ * of waiting for the latency of each round of a single block. It is also used with the 256 bits VAES intrinsics.
+ *
+ * @param op AES-NI intrinsic to apply (_mm_aesenc_si128, _mm_aesdec_si128, ...)
+ * @param rk Round key
+ */
+#define AES_AESNI_ROUND8(op, rk)   \
+    do                             \
+    {                              \
+        s0 = op(s0, rk);           \
+        s1 = op(s1, rk);           \
+        s2 = op(s2, rk);           \
+        s3 = op(s3, rk);           \
+        s4 = op(s4, rk);           \
+        s5 = op(s5, rk);           \
+        s6 = op(s6, rk);           \
+        s7 = op(s7, rk);           \
+    } while (0)
+
+/**
+ * @brief Apply one VAES-512 instruction to the four interleaved 512 bits states (s0..s3 must be in scope)
+ *
+ * @param op VAES intrinsic to apply (_mm512_aesenc_epi128, _mm512_aesdec_epi128, ...)
+ * @param rk Round key broadcasted to the four lanes
+ */
+#define AES_VAES_ROUND4(op, rk)    \
+    do                             \
+    {                              \
+        s0 = op(s0, rk);           \
+        s1 = op(s1, rk);           \
+        s2 = op(s2, rk);           \
+        s3 = op(s3, rk);           \
+    } while (0)
+
 /****************************************************************************************************************
  * Function definition zone
  ****************************************************************************************************************/
@@ -123,6 +204,34 @@ typedef enum AES_implementation
  */
 int supportsAESNI();
 
+/**
+ * @brief Function to check if the SSSE3 instructions (PSHUFB) are supported in this machine core.
+ *
+ * SSSE3 support is indicated by bit 9 of ECX with CPUID leaf 1.
+ *
+ * @return Returns 1 if SSSE3 is supported, 0 otherwise.
+ */
+int supportsSSSE3();
+
+/**
+ * @brief Function to check if the carry-less multiplication instruction (PCLMULQDQ) is supported in this machine core.
+ *
+ * PCLMULQDQ support is indicated by bit 1 of ECX with CPUID leaf 1, it is used by the GHASH of AES-GCM.
+ *
+ * @return Returns 1 if PCLMULQDQ is supported, 0 otherwise.
+ */
+int supportsPCLMULQDQ();
+
+/**
+ * @brief Function to check if the VAES instructions are supported in this machine core and enabled by the OS.
+ *
+ * VAES is indicated by bit 9 of ECX with CPUID leaf 7. The 256 bits version needs AVX2 and the YMM state
+ * enabled in XCR0, the 512 bits version needs AVX-512F and the opmask/ZMM states enabled in XCR0.
+ *
+ * @return Returns 512 if VAES can be used on 512 bits registers, 256 if only on 256 bits registers, 0 otherwise.
+ */
+int supportsVAES();
+
 /**
  * @brief AES-128 key expansion using AES-NI instructions
  *
@@ -197,6 +306,90 @@ void aes_aesni_encrypt(const __m128i *ks, int rounds, const uint8_t *plaintext,
  */
 void aes_aesni_decrypt(const __m128i *ks, int rounds, const uint8_t *ciphertext, uint8_t *plaintext);
 
+/**
+ * @brief Encrypt several independent blocks using AES-NI instructions
+ *
+ * The blocks are processed AES_PARALLEL_BLOCKS at a time with the rounds of every block
+ * interleaved, hiding the latency of the AESENC instruction. Remaining blocks are processed one by one.
+ *
+ * @param ks Key schedule array
+ * @param rounds Number of encryption rounds
+ * @param plaintext Pointer to the nblocks plaintext blocks to be encrypted
+ * @param ciphertext Pointer to the buffer where the nblocks ciphertext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_aesni_encrypt_blocks(const __m128i *ks, int rounds, const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks);
+
+/**
+ * @brief Decrypt several independent blocks using AES-NI instructions
+ *
+ * The blocks are processed AES_PARALLEL_BLOCKS at a time with the rounds of every block
+ * interleaved, hiding the latency of the AESDEC instruction. Remaining blocks are processed one by one.
+ *
+ * @param ks Key schedule array
+ * @param rounds Number of decryption rounds
+ * @param ciphertext Pointer to the nblocks ciphertext blocks to be decrypted
+ * @param plaintext Pointer to the buffer where the nblocks plaintext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_aesni_decrypt_blocks(const __m128i *ks, int rounds, const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks);
+
+/**
+ * @brief Encrypt several independent blocks using VAES on 256 bits registers
+ *
+ * Two blocks per instruction and AES_VAES_PARALLEL_BLOCKS blocks in flight, the tail is handled by
+ * aes_aesni_encrypt_blocks. Only to be called if supportsVAES() reports at least 256.
+ *
+ * @param ks AES-NI key schedule array
+ * @param rounds Number of encryption rounds
+ * @param plaintext Pointer to the nblocks plaintext blocks to be encrypted
+ * @param ciphertext Pointer to the buffer where the nblocks ciphertext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_vaes256_encrypt_blocks(const __m128i *ks, int rounds, const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks);
+
+/**
+ * @brief Decrypt several independent blocks using VAES on 256 bits registers
+ *
+ * Two blocks per instruction and AES_VAES_PARALLEL_BLOCKS blocks in flight, the tail is handled by
+ * aes_aesni_decrypt_blocks. Only to be called if supportsVAES() reports at least 256.
+ *
+ * @param ks AES-NI key schedule array
+ * @param rounds Number of decryption rounds
+ * @param ciphertext Pointer to the nblocks ciphertext blocks to be decrypted
+ * @param plaintext Pointer to the buffer where the nblocks plaintext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_vaes256_decrypt_blocks(const __m128i *ks, int rounds, const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks);
+
+/**
+ * @brief Encrypt several independent blocks using VAES on 512 bits registers
+ *
+ * Four blocks per instruction and AES_VAES_PARALLEL_BLOCKS blocks in flight, the tail is handled by
+ * aes_aesni_encrypt_blocks. Only to be called if supportsVAES() reports 512.
+ *
+ * @param ks AES-NI key schedule array
+ * @param rounds Number of encryption rounds
+ * @param plaintext Pointer to the nblocks plaintext blocks to be encrypted
+ * @param ciphertext Pointer to the buffer where the nblocks ciphertext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_vaes512_encrypt_blocks(const __m128i *ks, int rounds, const uint8_t *plaintext, uint8_t *ciphertext, size_t nblocks);
+
+/**
+ * @brief Decrypt several independent blocks using VAES on 512 bits registers
+ *
+ * Four blocks per instruction and AES_VAES_PARALLEL_BLOCKS blocks in flight, the tail is handled by
+ * aes_aesni_decrypt_blocks. Only to be called if supportsVAES() reports 512.
+ *
+ * @param ks AES-NI key schedule array
+ * @param rounds Number of decryption rounds
+ * @param ciphertext Pointer to the nblocks ciphertext blocks to be decrypted
+ * @param plaintext Pointer to the buffer where the nblocks plaintext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_vaes512_decrypt_blocks(const __m128i *ks, int rounds, const uint8_t *ciphertext, uint8_t *plaintext, size_t nblocks);
+
 /**
  * @brief Key expansion for AES using table-based implementation
  *
@@ -236,17 +429,125 @@ void aes_table_encrypt(AesContext const* Context, uint8_t const Input [AES_BLOCK
  */
 void aes_table_decrypt(AesContext const* Context, uint8_t const Input [AES_BLOCK_SIZE], uint8_t Output [AES_BLOCK_SIZE]);
 
+/**
+ * @brief Encrypt several independent blocks using table-based AES implementation
+ *
+ * The blocks are processed AES_TABLE_PARALLEL_BLOCKS at a time with their rounds interleaved,
+ * so the table lookups of the different blocks overlap. Remaining blocks are processed one by one.
+ *
+ * @param Context Pointer to the AES context containing the expanded keys
+ * @param Input Pointer to the nblocks plaintext blocks to be encrypted
+ * @param Output Pointer to the buffer where the nblocks ciphertext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_table_encrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks);
+
+/**
+ * @brief Decrypt several independent blocks using table-based AES implementation
+ *
+ * The blocks are processed AES_TABLE_PARALLEL_BLOCKS at a time with their rounds interleaved,
+ * so the table lookups of the different blocks overlap. Remaining blocks are processed one by one.
+ *
+ * @param Context Pointer to the AES context containing the expanded keys
+ * @param Input Pointer to the nblocks ciphertext blocks to be decrypted
+ * @param Output Pointer to the buffer where the nblocks plaintext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_table_decrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks);
+
+/**
+ * @brief Key expansion for the bitsliced software implementation
+ *
+ * The key schedule uses the bitsliced S-box, so it does not access memory at key dependent addresses.
+ * The round keys are stored in Context->BK and the number of rounds in Context->Nr.
+ *
+ * @param Context Pointer to the AES context to be initialized
+ * @param Key Pointer to the original AES key
+ * @param KeySize Size of the AES key in bits (128, 192, or 256)
+ */
+void aes_bitsliced_key_expansion(AesContext* Context, void const* Key, uint32_t KeySize);
+
+/**
+ * @brief Encrypt several independent blocks using the constant time bitsliced implementation
+ *
+ * The blocks are processed AES_BITSLICED_PARALLEL_BLOCKS at a time with only boolean operations on SSE2/AVX2
+ * registers, without lookup tables. A last incomplete batch costs the same as a complete one.
+ *
+ * @param Context Pointer to the AES context initialized with aes_bitsliced_key_expansion
+ * @param Input Pointer to the nblocks plaintext blocks to be encrypted
+ * @param Output Pointer to the buffer where the nblocks ciphertext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_bitsliced_encrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks);
+
+/**
+ * @brief Decrypt several independent blocks using the constant time bitsliced implementation
+ *
+ * The blocks are processed AES_BITSLICED_PARALLEL_BLOCKS at a time with only boolean operations on SSE2/AVX2
+ * registers, without lookup tables. A last incomplete batch costs the same as a complete one.
+ *
+ * @param Context Pointer to the AES context initialized with aes_bitsliced_key_expansion
+ * @param Input Pointer to the nblocks ciphertext blocks to be decrypted
+ * @param Output Pointer to the buffer where the nblocks plaintext blocks will be stored
+ * @param nblocks Number of 16 bytes blocks
+ */
+void aes_bitsliced_decrypt_blocks(AesContext const* Context, uint8_t const* Input, uint8_t* Output, size_t nblocks);
+
+/**
+ * @brief Key expansion for the SSSE3 vector permute implementation
+ *
+ * The SubWord steps use the vector permute S-box, so the expansion does not access memory at key dependent
+ * addresses. The encryption round keys are stored in byte order in Context->HK[0..Nr], decryption uses them
+ * in reverse order with the straightforward inverse cipher.
+ *
+ * @param Context Pointer to the AES context to be initialized
+ * @param Key Pointer to the original AES key
+ * @param KeySize Size of the AES key in bits (128, 192, or 256)
+ */
+void aes_vperm_key_expansion(AesContext* Context, void const* Key, uint32_t KeySize);
+
+/**
+ * @brief Encrypt a block using the constant time SSSE3 vector permute implementation
+ *
+ * SubBytes is computed with PSHUFB lookups of 16 entries tables held in registers (inversion in a GF(16)
+ * tower field), so the latency does not depend on the data nor on the cache state.
+ *
+ * @param Context Pointer to the AES context initialized with aes_vperm_key_expansion
+ * @param Input Pointer to the plaintext block to be encrypted
+ * @param Output Pointer to the buffer where the encrypted ciphertext block will be stored
+ */
+void aes_vperm_encrypt(AesContext const* Context, uint8_t const Input [AES_BLOCK_SIZE], uint8_t Output [AES_BLOCK_SIZE]);
+
+/**
+ * @brief Decrypt a block using the constant time SSSE3 vector permute implementation
+ *
+ * @param Context Pointer to the AES context initialized with aes_vperm_key_expansion
+ * @param Input Pointer to the ciphertext block to be decrypted
+ * @param Output Pointer to the buffer where the decrypted plaintext block will be stored
+ */
+void aes_vperm_decrypt(AesContext const* Context, uint8_t const Input [AES_BLOCK_SIZE], uint8_t Output [AES_BLOCK_SIZE]);
+
 /**
  * @brief Function to check hardware support for AES-NI and set the appropriate AES implementation
  *
  * This function checks if the processor supports AES-NI (Advanced Encryption Standard New Instructions)
- * using the `supportsAESNI` function. It sets the global variable `AES_implement` to either
- * `hardware_AES_NI` if AES-NI is supported or `software_table_based_aes` if it is not.
+ * using the `supportsAESNI` function, and then the wide VAES instructions using `supportsVAES`. It sets the
+ * global variable `AES_implement` to the widest tier available: `hardware_VAES_512`, `hardware_VAES_256`,
+ * `hardware_AES_NI`, or if AES-NI is not supported `software_vperm_aes` (SSSE3) or `software_bitsliced_aes`.
  *
- * @return The AES implementation being used (hardware_AES_NI or software_table_based_aes)
+ * @return The AES implementation being used
  */
 int API_AES_checkHWsupport();
 
+/**
+ * @brief Returns the AES implementation selected by API_AES_checkHWsupport
+ *
+ * Used by the modes of operation to pick their own dedicated kernels.
+ *
+ * @return The AES implementation being used (still_to_check if API_AES_checkHWsupport was not called yet)
+ */
+AES_implementation API_AES_getImplementation();
+
 /**
  * @brief Initializes an AES context with an AES Key.
  *
@@ -281,4 +582,32 @@ void API_AES_encrypt_block(AesContext const *Context, uint8_t const Input[AES_BL
  */
 void API_AES_decrypt_block(AesContext const *Context, uint8_t const Input[AES_BLOCK_SIZE], uint8_t Output[AES_BLOCK_SIZE]);
 
+/**
+ * @brief Performs an AES encryption of nblocks independent blocks (ECB) with an AES context
+ *
+ * The blocks are pipelined through the selected implementation, so callers with several
+ * independent blocks (parallel modes, several packets) should prefer it over API_AES_encrypt_block.
+ * Input and Output may be the same buffer.
+ *
+ * @param Context AES context
+ * @param Input Input blocks to be encrypted (nblocks * AES_BLOCK_SIZE bytes)
+ * @param Output AES output encrypted (nblocks * AES_BLOCK_SIZE bytes)
+ * @param nblocks Number of blocks
+ */
+void API_AES_encrypt_blocks(AesContext const *Context, uint8_t const *Input, uint8_t *Output, size_t nblocks);
+
+/**
+ * @brief Performs an AES decryption of nblocks independent blocks (ECB) with an AES context
+ *
+ * The blocks are pipelined through the selected implementation, so callers with several
+ * independent blocks (CBC decryption, several packets) should prefer it over API_AES_decrypt_block.
+ * Input and Output may be the same buffer.
+ *
+ * @param Context AES context
+ * @param Input Input blocks to be decrypted (nblocks * AES_BLOCK_SIZE bytes)
+ * @param Output AES output decrypted (nblocks * AES_BLOCK_SIZE bytes)
+ * @param nblocks Number of blocks
+ */
+void API_AES_decrypt_blocks(AesContext const *Context, uint8_t const *Input, uint8_t *Output, size_t nblocks);
+
 #endif
\ No newline at end of file
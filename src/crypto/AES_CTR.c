@@ -0,0 +1,254 @@
+/**
+ * @file AES_CTR.c
+ * @brief File containing the implementation of AES_CTR
+ */
+
+/****************************************************************************************************************
+ * Private include files
+ ****************************************************************************************************************/
+#include "AES_CTR.h"
+
+AesContext AESCTR_CTX; // AES AESCTR_CTX to store the round keys of AES-256 CTR
+
+// One block aligned piece of a payload, with the counter value of its first block
+typedef struct AesCtrSlice
+{
+  AesContext const *ctx;
+  const uint8_t *input;
+  uint8_t *output;
+  size_t length;
+  uint8_t counter[AES_BLOCK_SIZE];
+} AesCtrSlice;
+
+// Worker pool used by API_AES_CTR_EncryptDecrypt_parallel, worker i processes slices[i] of every job
+static struct
+{
+  pthread_mutex_t call_mutex; // held by the caller that owns the pool during a whole job
+  pthread_mutex_t mutex;      // protects the fields below
+  pthread_cond_t job_cond;
+  pthread_cond_t done_cond;
+  pthread_t threads[AES_CTR_MAX_WORKERS];
+  unsigned long start_generation[AES_CTR_MAX_WORKERS]; // last job posted before each worker was created
+  int nworkers;
+  int forced_workers; // set by API_AES_CTR_set_workers, 0 for one per online core besides the caller
+  int njob_workers; // workers that have a slice in the current job
+  int pending;
+  int stop;
+  unsigned long generation;
+  AesCtrSlice slices[AES_CTR_MAX_WORKERS];
+} AESCTR_pool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+/****************************************************************************************************************
+ * Function definition zone
+ ****************************************************************************************************************/
+
+static uint64_t CP_AESCTR_load_be64(const uint8_t *p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return __builtin_bswap64(v);
+}
+
+static void CP_AESCTR_store_be64(uint8_t *p, uint64_t v)
+{
+  v = __builtin_bswap64(v);
+  memcpy(p, &v, sizeof(v));
+}
+
+// out = in + n, with in and out 128-bit big-endian counter blocks
+static void CP_AESCTR_add_counter(const uint8_t in[AES_BLOCK_SIZE], uint64_t n, uint8_t out[AES_BLOCK_SIZE])
+{
+  uint64_t hi = CP_AESCTR_load_be64(in);
+  uint64_t lo = CP_AESCTR_load_be64(in + 8);
+
+  lo += n;
+  if (lo < n)
+    hi++;
+  CP_AESCTR_store_be64(out, hi);
+  CP_AESCTR_store_be64(out + 8, lo);
+}
+
+void API_AES_CTR_EncryptDecrypt(const uint8_t *input, size_t length, const uint8_t *key, size_t keySize, uint8_t *counter, uint8_t *output)
+{
+  // Initialize the AES context with the provided key
+  API_AES_initkey(&AESCTR_CTX, key, keySize);
+
+  API_AES_CTR_EncryptDecrypt_ctx(&AESCTR_CTX, input, length, counter, output);
+}
+
+void API_AES_CTR_EncryptDecrypt_ctx(AesContext const *ctx, const uint8_t *input, size_t length, uint8_t *counter, uint8_t *output)
+{
+  uint8_t counter_blocks[AES_CTR_CHUNK_BLOCKS * AES_BLOCK_SIZE] __attribute__((aligned(16)));
+  uint8_t keystream[AES_CTR_CHUNK_BLOCKS * AES_BLOCK_SIZE] __attribute__((aligned(16))); // CSP
+  uint64_t hi = CP_AESCTR_load_be64(counter);
+  uint64_t lo = CP_AESCTR_load_be64(counter + 8);
+
+  while (length > 0)
+  {
+    size_t chunk = (length < sizeof(keystream)) ? length : sizeof(keystream);
+    size_t nblocks = (chunk + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+    size_t i;
+
+    // Lay out the counter values of the chunk and encrypt them all in one kernel call
+    for (i = 0; i < nblocks; i++)
+    {
+      CP_AESCTR_store_be64(counter_blocks + i * AES_BLOCK_SIZE, hi);
+      CP_AESCTR_store_be64(counter_blocks + i * AES_BLOCK_SIZE + 8, lo);
+      if (++lo == 0)
+        hi++;
+    }
+    API_AES_encrypt_blocks(ctx, counter_blocks, keystream, nblocks);
+
+    // XOR the keystream with the input, a full block per 128 bits operation and the tail byte by byte
+    for (i = 0; i + AES_BLOCK_SIZE <= chunk; i += AES_BLOCK_SIZE)
+    {
+      __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(input + i)), _mm_load_si128((const __m128i *)(keystream + i)));
+      _mm_storeu_si128((__m128i *)(output + i), x);
+    }
+    for (; i < chunk; i++)
+      output[i] = input[i] ^ keystream[i];
+
+    input += chunk;
+    output += chunk;
+    length -= chunk;
+  }
+
+  CP_AESCTR_store_be64(counter, hi);
+  CP_AESCTR_store_be64(counter + 8, lo);
+  memset(keystream, 0, sizeof(keystream));
+}
+
+static void CP_AESCTR_process_slice(AesCtrSlice *slice)
+{
+  API_AES_CTR_EncryptDecrypt_ctx(slice->ctx, slice->input, slice->length, slice->counter, slice->output);
+}
+
+// Worker thread main loop, waits for a new job generation and processes its own slice
+static void *CP_AESCTR_worker(void *arg)
+{
+  int index = (int)(intptr_t)arg;
+  unsigned long seen;
+
+  pthread_mutex_lock(&AESCTR_pool.mutex);
+  seen = AESCTR_pool.start_generation[index]; // only jobs posted after the thread creation are its own
+  for (;;)
+  {
+    while (!AESCTR_pool.stop && AESCTR_pool.generation == seen)
+      pthread_cond_wait(&AESCTR_pool.job_cond, &AESCTR_pool.mutex);
+    if (AESCTR_pool.stop)
+      break;
+    seen = AESCTR_pool.generation;
+    if (index >= AESCTR_pool.njob_workers)
+      continue; // this job has fewer slices than workers
+    pthread_mutex_unlock(&AESCTR_pool.mutex);
+
+    CP_AESCTR_process_slice(&AESCTR_pool.slices[index]);
+
+    pthread_mutex_lock(&AESCTR_pool.mutex);
+    if (--AESCTR_pool.pending == 0)
+      pthread_cond_signal(&AESCTR_pool.done_cond);
+  }
+  pthread_mutex_unlock(&AESCTR_pool.mutex);
+  return NULL;
+}
+
+// Starts the worker threads, one per online core besides the calling one unless forced. Must hold call_mutex
+static void CP_AESCTR_start_workers()
+{
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  int wanted = (cores > 1) ? (int)(cores - 1) : 0;
+  unsigned long generation;
+
+  if (AESCTR_pool.forced_workers > 0)
+    wanted = AESCTR_pool.forced_workers;
+  if (wanted > AES_CTR_MAX_WORKERS)
+    wanted = AES_CTR_MAX_WORKERS;
+
+  pthread_mutex_lock(&AESCTR_pool.mutex);
+  AESCTR_pool.stop = 0;
+  generation = AESCTR_pool.generation;
+  pthread_mutex_unlock(&AESCTR_pool.mutex);
+
+  while (AESCTR_pool.nworkers < wanted)
+  {
+    // Set before the thread exists, so a worker scheduled after the next job is posted still takes it
+    AESCTR_pool.start_generation[AESCTR_pool.nworkers] = generation;
+    if (pthread_create(&AESCTR_pool.threads[AESCTR_pool.nworkers], NULL, CP_AESCTR_worker, (void *)(intptr_t)AESCTR_pool.nworkers) != 0)
+      break; // keep the workers already created
+    AESCTR_pool.nworkers++;
+  }
+}
+
+void API_AES_CTR_EncryptDecrypt_parallel(AesContext const *ctx, const uint8_t *input, size_t length, uint8_t *counter, uint8_t *output)
+{
+  if (length < AES_CTR_PARALLEL_THRESHOLD || pthread_mutex_trylock(&AESCTR_pool.call_mutex) != 0)
+  {
+    API_AES_CTR_EncryptDecrypt_ctx(ctx, input, length, counter, output);
+    return;
+  }
+
+  if (AESCTR_pool.nworkers == 0)
+    CP_AESCTR_start_workers();
+
+  size_t total_blocks = (length + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+  size_t nslices = AESCTR_pool.nworkers + 1;
+  size_t slice_blocks = (total_blocks + nslices - 1) / nslices;
+  AesCtrSlice own_slice;
+  int njob_workers = 0;
+
+  // Split the payload in block aligned slices, the last one is kept for the calling thread
+  for (size_t first_block = 0; first_block < total_blocks; first_block += slice_blocks)
+  {
+    size_t offset = first_block * AES_BLOCK_SIZE;
+    AesCtrSlice *slice = (first_block + slice_blocks >= total_blocks) ? &own_slice : &AESCTR_pool.slices[njob_workers++];
+
+    slice->ctx = ctx;
+    slice->input = input + offset;
+    slice->output = output + offset;
+    slice->length = (length - offset < slice_blocks * AES_BLOCK_SIZE) ? length - offset : slice_blocks * AES_BLOCK_SIZE;
+    CP_AESCTR_add_counter(counter, first_block, slice->counter);
+  }
+
+  pthread_mutex_lock(&AESCTR_pool.mutex);
+  AESCTR_pool.njob_workers = njob_workers;
+  AESCTR_pool.pending = njob_workers;
+  AESCTR_pool.generation++;
+  pthread_cond_broadcast(&AESCTR_pool.job_cond);
+  pthread_mutex_unlock(&AESCTR_pool.mutex);
+
+  CP_AESCTR_process_slice(&own_slice);
+
+  pthread_mutex_lock(&AESCTR_pool.mutex);
+  while (AESCTR_pool.pending > 0)
+    pthread_cond_wait(&AESCTR_pool.done_cond, &AESCTR_pool.mutex);
+  pthread_mutex_unlock(&AESCTR_pool.mutex);
+
+  // The last slice ends where the whole payload ends, so its counter is the next unused one
+  memcpy(counter, own_slice.counter, AES_BLOCK_SIZE);
+  pthread_mutex_unlock(&AESCTR_pool.call_mutex);
+}
+
+void API_AES_CTR_stop_workers()
+{
+  pthread_mutex_lock(&AESCTR_pool.call_mutex);
+
+  pthread_mutex_lock(&AESCTR_pool.mutex);
+  AESCTR_pool.stop = 1;
+  pthread_cond_broadcast(&AESCTR_pool.job_cond);
+  pthread_mutex_unlock(&AESCTR_pool.mutex);
+
+  for (int i = 0; i < AESCTR_pool.nworkers; i++)
+    pthread_join(AESCTR_pool.threads[i], NULL);
+  AESCTR_pool.nworkers = 0;
+
+  pthread_mutex_unlock(&AESCTR_pool.call_mutex);
+}
+
+void API_AES_CTR_set_workers(int nworkers)
+{
+  API_AES_CTR_stop_workers();
+
+  pthread_mutex_lock(&AESCTR_pool.call_mutex);
+  AESCTR_pool.forced_workers = (nworkers > 0) ? nworkers : 0;
+  pthread_mutex_unlock(&AESCTR_pool.call_mutex);
+}
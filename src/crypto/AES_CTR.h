@@ -0,0 +1,123 @@
+/**
+ * @file AES_CTR.h
+ * @brief File containing all the function headers of the AES_CTR.
+ */
+
+#ifndef AESCTR_H
+#define AESCTR_H
+
+/****************************************************************************************************************
+ * Compiler include files
+ ****************************************************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/****************************************************************************************************************
+ * Private include files
+ ****************************************************************************************************************/
+
+#include "AES_CORE.h"
+
+/****************************************************************************************************************
+ * Global variables/constants definition
+ ****************************************************************************************************************/
+
+/**
+ * @brief Number of counter blocks encrypted per call to the multi-block AES kernel
+ *
+ * The keystream is generated in chunks of this many blocks (1 KB), big enough to keep the widest
+ * kernel busy and small enough to stay in L1 together with the data being XORed.
+ */
+#define AES_CTR_CHUNK_BLOCKS 64
+
+/**
+ * @brief Payload size from which API_AES_CTR_EncryptDecrypt_parallel splits the work between threads
+ *
+ * Below this size the cost of waking up the workers is higher than the time saved, so the payload is
+ * processed by the calling thread.
+ */
+#define AES_CTR_PARALLEL_THRESHOLD (256 * 1024)
+
+/**
+ * @brief Maximum number of worker threads of the CTR pool (the calling thread takes one more slice)
+ */
+#define AES_CTR_MAX_WORKERS 7
+
+extern AesContext AESCTR_CTX; // AES AESCTR_CTX to store the derived AES-256 key CSP
+
+/****************************************************************************************************************
+ * Function definition zone
+ ****************************************************************************************************************/
+
+/**
+ * @brief AES-CTR (Counter) encryption/decryption function.
+ *
+ * This function performs encryption or decryption using AES in CTR mode (NIST SP 800-38A). The keystream is the
+ * encryption of consecutive values of a 128-bit big-endian counter, so every block is independent and the counter
+ * blocks are encrypted with the multi-block AES kernel. As in OFB, the same function is used to encrypt and decrypt.
+ *
+ * @param[in] input       Pointer to the input data to be encrypted or decrypted.
+ * @param[in] length      Length of the input data in bytes, does not need to be a multiple of the block size.
+ * @param[in] key         Pointer to the AES key.
+ * @param[in] keySize     Size of the AES key in bytes (typically 16, 24, or 32).
+ * @param[in, out] counter Initial counter block, on return it holds the next unused counter block
+ *                        (a trailing partial block counts as used).
+ * @param[out] output     Pointer to the output buffer, same size as the input buffer (may be the input buffer).
+ *
+ * @warning A counter value must never be reused with the same key.
+ */
+void API_AES_CTR_EncryptDecrypt(const uint8_t *input, size_t length, const uint8_t *key, size_t keySize, uint8_t *counter, uint8_t *output);
+
+/**
+ * @brief AES-CTR (Counter) encryption/decryption function with an already expanded key.
+ *
+ * Same as API_AES_CTR_EncryptDecrypt, but the key schedule is passed by handle. The function only uses stack
+ * buffers, so it can be called concurrently from several threads with the same context.
+ *
+ * @param[in] ctx         AES context initialized with API_AES_initkey.
+ * @param[in] input       Pointer to the input data to be encrypted or decrypted.
+ * @param[in] length      Length of the input data in bytes.
+ * @param[in, out] counter Initial counter block, on return the next unused counter block.
+ * @param[out] output     Pointer to the output buffer, same size as the input buffer (may be the input buffer).
+ */
+void API_AES_CTR_EncryptDecrypt_ctx(AesContext const *ctx, const uint8_t *input, size_t length, uint8_t *counter, uint8_t *output);
+
+/**
+ * @brief Multithreaded AES-CTR encryption/decryption for bulk payloads.
+ *
+ * Produces exactly the same output and final counter as API_AES_CTR_EncryptDecrypt_ctx. Payloads of at least
+ * AES_CTR_PARALLEL_THRESHOLD bytes are split in block aligned slices, each slice starting at its own counter
+ * value, and the slices are processed by a pool of worker threads plus the calling thread. The pool is started
+ * on the first bulk call. If the pool is being used by another caller, or the threads cannot be created,
+ * the payload is processed by the calling thread.
+ *
+ * @param[in] ctx         AES context initialized with API_AES_initkey.
+ * @param[in] input       Pointer to the input data to be encrypted or decrypted.
+ * @param[in] length      Length of the input data in bytes.
+ * @param[in, out] counter Initial counter block, on return the next unused counter block.
+ * @param[out] output     Pointer to the output buffer, same size as the input buffer (may be the input buffer).
+ */
+void API_AES_CTR_EncryptDecrypt_parallel(AesContext const *ctx, const uint8_t *input, size_t length, uint8_t *counter, uint8_t *output);
+
+/**
+ * @brief Stops and joins the AES-CTR worker threads.
+ *
+ * Called on module shutdown, a later call to API_AES_CTR_EncryptDecrypt_parallel starts the pool again.
+ */
+void API_AES_CTR_stop_workers();
+
+/**
+ * @brief Sets the number of worker threads of API_AES_CTR_EncryptDecrypt_parallel.
+ *
+ * The current workers are stopped, the new number is used when the pool starts again. Used by the self-tests to
+ * run the split path with several workers whatever the number of cores.
+ *
+ * @param[in] nworkers Number of workers (up to AES_CTR_MAX_WORKERS), 0 for one per online core besides the caller.
+ */
+void API_AES_CTR_set_workers(int nworkers);
+
+#endif
@@ -0,0 +1,384 @@
+/**
+ * @file AES_GCM.c
+ * @brief File containing the implementation of AES_GCM
+ */
+
+/****************************************************************************************************************
+ * Private include files
+ ****************************************************************************************************************/
+#include "AES_GCM.h"
+
+AesContext AESGCM_CTX; // AES AESGCM_CTX to store the round keys of AES-256 GCM
+
+// Target of the carry-less multiplication GHASH functions, PSHUFB is used to reflect the bytes of the blocks
+#define AES_GCM_CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+
+// GHASH state, the hash key and the accumulator are kept byte reflected for the PCLMULQDQ version
+// and as two big-endian 64 bits halves for the software version
+typedef struct CP_AESGCM_ghash
+{
+  __m128i H[AES_GCM_GHASH_BLOCKS]; // H^1..H^4, CSP
+  __m128i Y;
+  uint64_t Hs[2]; // CSP
+  uint64_t Ys[2];
+  int clmul;
+} CP_AESGCM_ghash;
+
+static int GHASH_implement = -1; // 1 PCLMULQDQ, 0 software, -1 still to check
+
+/****************************************************************************************************************
+ * Function definition zone
+ ****************************************************************************************************************/
+
+static uint64_t CP_AESGCM_load_be64(const uint8_t *p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return __builtin_bswap64(v);
+}
+
+static void CP_AESGCM_store_be64(uint8_t *p, uint64_t v)
+{
+  v = __builtin_bswap64(v);
+  memcpy(p, &v, sizeof(v));
+}
+
+////////////////////////////////////////////// GHASH CARRY-LESS MULTIPLICATION //////////////////////////////////////////////
+
+// Accumulates the 256 bits carry-less product of a and b in lo/mid/hi (mid holds the two cross products)
+#define AES_GCM_CLMUL_ACC(a, b, lo, mid, hi)                                                           \
+  do                                                                                                 \
+  {                                                                                                  \
+    lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00));                                        \
+    hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11));                                        \
+    mid = _mm_xor_si128(mid, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01))); \
+  } while (0)
+
+// Reduces an accumulated product modulo x^128 + x^7 + x^2 + x + 1. The operands are byte reflected, so the
+// product is shifted one bit to the left before the reduction (Gueron and Kounavis, Intel CLMUL white paper)
+AES_GCM_CLMUL_TARGET static __m128i CP_AESGCM_clmul_reduce(__m128i lo, __m128i mid, __m128i hi)
+{
+  __m128i t7, t8, t9, t2, t4, t5;
+
+  lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+  hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+  // 256 bits shift left by one
+  t7 = _mm_srli_epi32(lo, 31);
+  t8 = _mm_srli_epi32(hi, 31);
+  lo = _mm_slli_epi32(lo, 1);
+  hi = _mm_slli_epi32(hi, 1);
+  t9 = _mm_srli_si128(t7, 12);
+  t8 = _mm_slli_si128(t8, 4);
+  t7 = _mm_slli_si128(t7, 4);
+  lo = _mm_or_si128(lo, t7);
+  hi = _mm_or_si128(hi, t8);
+  hi = _mm_or_si128(hi, t9);
+
+  // first phase of the reduction
+  t7 = _mm_slli_epi32(lo, 31);
+  t8 = _mm_slli_epi32(lo, 30);
+  t9 = _mm_slli_epi32(lo, 25);
+  t7 = _mm_xor_si128(t7, _mm_xor_si128(t8, t9));
+  t8 = _mm_srli_si128(t7, 4);
+  t7 = _mm_slli_si128(t7, 12);
+  lo = _mm_xor_si128(lo, t7);
+
+  // second phase of the reduction
+  t2 = _mm_srli_epi32(lo, 1);
+  t4 = _mm_srli_epi32(lo, 2);
+  t5 = _mm_srli_epi32(lo, 7);
+  t2 = _mm_xor_si128(t2, _mm_xor_si128(t4, t5));
+  t2 = _mm_xor_si128(t2, t8);
+  lo = _mm_xor_si128(lo, t2);
+  return _mm_xor_si128(hi, lo);
+}
+
+AES_GCM_CLMUL_TARGET static __m128i CP_AESGCM_clmul_mul(__m128i a, __m128i b)
+{
+  __m128i lo = _mm_setzero_si128(), mid = _mm_setzero_si128(), hi = _mm_setzero_si128();
+
+  AES_GCM_CLMUL_ACC(a, b, lo, mid, hi);
+  return CP_AESGCM_clmul_reduce(lo, mid, hi);
+}
+
+AES_GCM_CLMUL_TARGET static void CP_AESGCM_clmul_init(CP_AESGCM_ghash *g, const uint8_t H[AES_BLOCK_SIZE])
+{
+  const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+  g->H[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)H), bswap);
+  for (int i = 1; i < AES_GCM_GHASH_BLOCKS; i++)
+    g->H[i] = CP_AESGCM_clmul_mul(g->H[i - 1], g->H[0]);
+  g->Y = _mm_setzero_si128();
+}
+
+// GHASH of nblocks full blocks, AES_GCM_GHASH_BLOCKS blocks per reduction:
+// Y = (Y + X0)*H^4 + X1*H^3 + X2*H^2 + X3*H
+AES_GCM_CLMUL_TARGET static void CP_AESGCM_clmul_blocks(CP_AESGCM_ghash *g, const uint8_t *data, size_t nblocks)
+{
+  const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m128i *in = (const __m128i *)data;
+  __m128i Y = g->Y;
+  __m128i x0, x1, x2, x3, lo, mid, hi;
+
+  for (; nblocks >= AES_GCM_GHASH_BLOCKS; nblocks -= AES_GCM_GHASH_BLOCKS, in += AES_GCM_GHASH_BLOCKS)
+  {
+    x0 = _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128(in + 0), bswap), Y);
+    x1 = _mm_shuffle_epi8(_mm_loadu_si128(in + 1), bswap);
+    x2 = _mm_shuffle_epi8(_mm_loadu_si128(in + 2), bswap);
+    x3 = _mm_shuffle_epi8(_mm_loadu_si128(in + 3), bswap);
+    lo = mid = hi = _mm_setzero_si128();
+    AES_GCM_CLMUL_ACC(x0, g->H[3], lo, mid, hi);
+    AES_GCM_CLMUL_ACC(x1, g->H[2], lo, mid, hi);
+    AES_GCM_CLMUL_ACC(x2, g->H[1], lo, mid, hi);
+    AES_GCM_CLMUL_ACC(x3, g->H[0], lo, mid, hi);
+    Y = CP_AESGCM_clmul_reduce(lo, mid, hi);
+  }
+  for (; nblocks > 0; nblocks--, in++)
+  {
+    x0 = _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128(in), bswap), Y);
+    Y = CP_AESGCM_clmul_mul(x0, g->H[0]);
+  }
+  g->Y = Y;
+}
+
+AES_GCM_CLMUL_TARGET static void CP_AESGCM_clmul_final(CP_AESGCM_ghash *g, uint8_t S[AES_BLOCK_SIZE])
+{
+  const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+  _mm_storeu_si128((__m128i *)S, _mm_shuffle_epi8(g->Y, bswap));
+}
+
+////////////////////////////////////////////// GHASH SOFTWARE CONSTANT TIME //////////////////////////////////////////////
+
+// x = x * h in GF(2^128), bit by bit with masks instead of branches (NIST SP 800-38D algorithm 1)
+static void CP_AESGCM_soft_mul(uint64_t x[2], const uint64_t h[2])
+{
+  uint64_t zh = 0, zl = 0, vh = h[0], vl = h[1];
+
+  for (int i = 0; i < 128; i++)
+  {
+    uint64_t mask = 0 - ((x[i >> 6] >> (63 - (i & 63))) & 1);
+    uint64_t reduce = 0 - (vl & 1);
+    zh ^= vh & mask;
+    zl ^= vl & mask;
+    vl = (vl >> 1) | (vh << 63);
+    vh = (vh >> 1) ^ (0xe100000000000000ULL & reduce);
+  }
+  x[0] = zh;
+  x[1] = zl;
+}
+
+static void CP_AESGCM_soft_blocks(CP_AESGCM_ghash *g, const uint8_t *data, size_t nblocks)
+{
+  for (; nblocks > 0; nblocks--, data += AES_BLOCK_SIZE)
+  {
+    g->Ys[0] ^= CP_AESGCM_load_be64(data);
+    g->Ys[1] ^= CP_AESGCM_load_be64(data + 8);
+    CP_AESGCM_soft_mul(g->Ys, g->Hs);
+  }
+}
+
+////////////////////////////////////////////// GHASH //////////////////////////////////////////////
+
+static void CP_AESGCM_ghash_init(CP_AESGCM_ghash *g, AesContext const *ctx)
+{
+  uint8_t H[AES_BLOCK_SIZE] = {0};
+
+  if (GHASH_implement < 0)
+    GHASH_implement = supportsPCLMULQDQ();
+
+  // The hash key is the encryption of the zero block
+  API_AES_encrypt_block(ctx, H, H);
+  g->clmul = GHASH_implement;
+  if (g->clmul)
+  {
+    CP_AESGCM_clmul_init(g, H);
+  }
+  else
+  {
+    g->Hs[0] = CP_AESGCM_load_be64(H);
+    g->Hs[1] = CP_AESGCM_load_be64(H + 8);
+    g->Ys[0] = g->Ys[1] = 0;
+  }
+  memset(H, 0, sizeof(H));
+}
+
+// Hashes len bytes, a partial last block is padded with zeros (only allowed at the end of the AAD or the ciphertext)
+static void CP_AESGCM_ghash_update(CP_AESGCM_ghash *g, const uint8_t *data, size_t len)
+{
+  size_t nblocks = len / AES_BLOCK_SIZE;
+  size_t rest = len % AES_BLOCK_SIZE;
+
+  if (nblocks > 0)
+  {
+    if (g->clmul)
+      CP_AESGCM_clmul_blocks(g, data, nblocks);
+    else
+      CP_AESGCM_soft_blocks(g, data, nblocks);
+  }
+  if (rest > 0)
+  {
+    uint8_t last[AES_BLOCK_SIZE] = {0};
+    memcpy(last, data + nblocks * AES_BLOCK_SIZE, rest);
+    CP_AESGCM_ghash_update(g, last, AES_BLOCK_SIZE);
+  }
+}
+
+// Hashes the length block of the two hashed strings (in bits) and returns the GHASH value
+static void CP_AESGCM_ghash_final(CP_AESGCM_ghash *g, uint64_t len_a, uint64_t len_c, uint8_t S[AES_BLOCK_SIZE])
+{
+  uint8_t lengths[AES_BLOCK_SIZE];
+
+  CP_AESGCM_store_be64(lengths, len_a * 8);
+  CP_AESGCM_store_be64(lengths + 8, len_c * 8);
+  CP_AESGCM_ghash_update(g, lengths, AES_BLOCK_SIZE);
+  if (g->clmul)
+  {
+    CP_AESGCM_clmul_final(g, S);
+  }
+  else
+  {
+    CP_AESGCM_store_be64(S, g->Ys[0]);
+    CP_AESGCM_store_be64(S + 8, g->Ys[1]);
+  }
+}
+
+////////////////////////////////////////////// GCM //////////////////////////////////////////////
+
+// Pre-counter block J0, the IV followed by a 32-bit 1 for 96 bits IVs, the GHASH of the IV otherwise
+static void CP_AESGCM_pre_counter(CP_AESGCM_ghash const *g, const uint8_t *iv, size_t iv_len, uint8_t J0[AES_BLOCK_SIZE])
+{
+  if (iv_len == AES_GCM_IV_SIZE)
+  {
+    memcpy(J0, iv, AES_GCM_IV_SIZE);
+    J0[12] = J0[13] = J0[14] = 0;
+    J0[15] = 1;
+  }
+  else
+  {
+    CP_AESGCM_ghash g_iv = *g;
+    g_iv.Y = _mm_setzero_si128();
+    g_iv.Ys[0] = g_iv.Ys[1] = 0;
+    CP_AESGCM_ghash_update(&g_iv, iv, iv_len);
+    CP_AESGCM_ghash_final(&g_iv, 0, iv_len, J0);
+    memset(&g_iv, 0, sizeof(g_iv));
+  }
+}
+
+// CTR encryption with the 32-bit counter of GCM (inc32) starting at J0 + 1. If hash_input is set the GHASH
+// of every chunk is computed before it is XORed (decryption), otherwise after (encryption), so in place works
+static void CP_AESGCM_ctr_ghash(AesContext const *ctx, CP_AESGCM_ghash *g, const uint8_t J0[AES_BLOCK_SIZE], const uint8_t *input, size_t length, uint8_t *output, int hash_input)
+{
+  uint8_t counter_blocks[AES_GCM_CHUNK_BLOCKS * AES_BLOCK_SIZE] __attribute__((aligned(16)));
+  uint8_t keystream[AES_GCM_CHUNK_BLOCKS * AES_BLOCK_SIZE] __attribute__((aligned(16))); // CSP
+  uint32_t counter = ((uint32_t)J0[12] << 24) | ((uint32_t)J0[13] << 16) | ((uint32_t)J0[14] << 8) | J0[15];
+
+  while (length > 0)
+  {
+    size_t chunk = (length < sizeof(keystream)) ? length : sizeof(keystream);
+    size_t nblocks = (chunk + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+    size_t i;
+
+    for (i = 0; i < nblocks; i++)
+    {
+      uint8_t *block = counter_blocks + i * AES_BLOCK_SIZE;
+      counter++;
+      memcpy(block, J0, 12);
+      block[12] = (uint8_t)(counter >> 24);
+      block[13] = (uint8_t)(counter >> 16);
+      block[14] = (uint8_t)(counter >> 8);
+      block[15] = (uint8_t)counter;
+    }
+    API_AES_encrypt_blocks(ctx, counter_blocks, keystream, nblocks);
+
+    if (hash_input)
+      CP_AESGCM_ghash_update(g, input, chunk);
+
+    for (i = 0; i + AES_BLOCK_SIZE <= chunk; i += AES_BLOCK_SIZE)
+    {
+      __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(input + i)), _mm_load_si128((const __m128i *)(keystream + i)));
+      _mm_storeu_si128((__m128i *)(output + i), x);
+    }
+    for (; i < chunk; i++)
+      output[i] = input[i] ^ keystream[i];
+
+    if (!hash_input)
+      CP_AESGCM_ghash_update(g, output, chunk);
+
+    input += chunk;
+    output += chunk;
+    length -= chunk;
+  }
+  memset(keystream, 0, sizeof(keystream));
+}
+
+// Computes the tag of a message, encrypting or decrypting it in the same pass
+static void CP_AESGCM_crypt(AesContext const *ctx, const uint8_t *input, size_t length, const uint8_t *iv, size_t iv_len, const uint8_t *aad, size_t aad_len, uint8_t *output, int decrypt, uint8_t tag[AES_GCM_TAG_SIZE])
+{
+  CP_AESGCM_ghash g;
+  uint8_t J0[AES_BLOCK_SIZE];
+  uint8_t S[AES_BLOCK_SIZE];
+
+  CP_AESGCM_ghash_init(&g, ctx);
+  CP_AESGCM_pre_counter(&g, iv, iv_len, J0);
+
+  if (aad_len > 0)
+    CP_AESGCM_ghash_update(&g, aad, aad_len);
+  CP_AESGCM_ctr_ghash(ctx, &g, J0, input, length, output, decrypt);
+  CP_AESGCM_ghash_final(&g, aad_len, length, S);
+
+  // T = E(K, J0) xor S
+  API_AES_encrypt_block(ctx, J0, J0);
+  for (int i = 0; i < AES_GCM_TAG_SIZE; i++)
+    tag[i] = J0[i] ^ S[i];
+
+  memset(&g, 0, sizeof(g));
+  memset(J0, 0, sizeof(J0));
+}
+
+void API_AES_GCM_encrypt(const uint8_t *input, size_t length, const uint8_t *key, size_t keySize, const uint8_t *iv, size_t iv_len, const uint8_t *aad, size_t aad_len, uint8_t *output, uint8_t tag[AES_GCM_TAG_SIZE])
+{
+  // Initialize the AES context with the provided key
+  API_AES_initkey(&AESGCM_CTX, key, keySize);
+
+  API_AES_GCM_encrypt_ctx(&AESGCM_CTX, input, length, iv, iv_len, aad, aad_len, output, tag);
+}
+
+int API_AES_GCM_decrypt(const uint8_t *input, size_t length, const uint8_t *key, size_t keySize, const uint8_t *iv, size_t iv_len, const uint8_t *aad, size_t aad_len, const uint8_t *tag, size_t tag_len, uint8_t *output)
+{
+  // Initialize the AES context with the provided key
+  API_AES_initkey(&AESGCM_CTX, key, keySize);
+
+  return API_AES_GCM_decrypt_ctx(&AESGCM_CTX, input, length, iv, iv_len, aad, aad_len, tag, tag_len, output);
+}
+
+void API_AES_GCM_encrypt_ctx(AesContext const *ctx, const uint8_t *input, size_t length, const uint8_t *iv, size_t iv_len, const uint8_t *aad, size_t aad_len, uint8_t *output, uint8_t tag[AES_GCM_TAG_SIZE])
+{
+  CP_AESGCM_crypt(ctx, input, length, iv, iv_len, aad, aad_len, output, 0, tag);
+}
+
+int API_AES_GCM_decrypt_ctx(AesContext const *ctx, const uint8_t *input, size_t length, const uint8_t *iv, size_t iv_len, const uint8_t *aad, size_t aad_len, const uint8_t *tag, size_t tag_len, uint8_t *output)
+{
+  uint8_t computed_tag[AES_GCM_TAG_SIZE];
+  uint8_t diff = 0;
+
+  if (tag_len < AES_GCM_MIN_TAG_SIZE || tag_len > AES_GCM_TAG_SIZE)
+  {
+    memset(output, 0, length);
+    return AES_GCM_TAG_NOT_VERIFIED;
+  }
+
+  CP_AESGCM_crypt(ctx, input, length, iv, iv_len, aad, aad_len, output, 1, computed_tag);
+
+  // Constant time comparison of the tags
+  for (size_t i = 0; i < tag_len; i++)
+    diff |= computed_tag[i] ^ tag[i];
+
+  if (diff != 0)
+  {
+    memset(output, 0, length); // do not release unauthenticated plaintext
+    return AES_GCM_TAG_NOT_VERIFIED;
+  }
+  return AES_GCM_TAG_OK;
+}
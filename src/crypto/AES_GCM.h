@@ -0,0 +1,120 @@
+/**
+ * @file AES_GCM.h
+ * @brief File containing all the function headers of the AES_GCM.
+ */
+
+#ifndef AESGCM_H
+#define AESGCM_H
+
+/****************************************************************************************************************
+ * Compiler include files
+ ****************************************************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/****************************************************************************************************************
+ * Private include files
+ ****************************************************************************************************************/
+
+#include "AES_CORE.h"
+
+/****************************************************************************************************************
+ * Global variables/constants definition
+ ****************************************************************************************************************/
+
+#define AES_GCM_IV_SIZE 12 // recommended IV size, the IV is used directly as the first 96 bits of the counter
+
+#define AES_GCM_TAG_SIZE 16
+
+#define AES_GCM_MIN_TAG_SIZE 12 // shortest tag accepted by the decryption, SP 800-38D allows 12 to 16 bytes
+
+#define AES_GCM_TAG_OK 1
+
+#define AES_GCM_TAG_NOT_VERIFIED 0
+
+/**
+ * @brief Number of blocks hashed per GHASH reduction
+ *
+ * The products of AES_GCM_GHASH_BLOCKS blocks by the powers H^4..H^1 of the hash key are added before doing
+ * a single modular reduction (aggregated reduction).
+ */
+#define AES_GCM_GHASH_BLOCKS 4
+
+/**
+ * @brief Number of counter blocks encrypted per call to the multi-block AES kernel
+ *
+ * The payload is processed in chunks of this many blocks, the GHASH of a chunk is computed while the chunk
+ * is still in L1, so the payload is read only once.
+ */
+#define AES_GCM_CHUNK_BLOCKS 64
+
+extern AesContext AESGCM_CTX; // AES AESGCM_CTX to store the derived AES-256 key CSP
+
+/****************************************************************************************************************
+ * Function definition zone
+ ****************************************************************************************************************/
+
+/**
+ * @brief AES-GCM (Galois/Counter Mode) authenticated encryption, NIST SP 800-38D.
+ *
+ * Encrypts the input with AES in counter mode (32-bit counter) and computes the authentication tag over
+ * the additional authenticated data and the ciphertext with GHASH. GHASH uses the carry-less multiplication
+ * instruction with aggregated reduction when supportsPCLMULQDQ() reports it, and a constant time software
+ * multiplication otherwise.
+ *
+ * @param[in] input    Pointer to the plaintext.
+ * @param[in] length   Length of the plaintext in bytes.
+ * @param[in] key      Pointer to the AES key.
+ * @param[in] keySize  Size of the AES key in bytes (typically 16, 24, or 32).
+ * @param[in] iv       Pointer to the IV, should be AES_GCM_IV_SIZE bytes. An IV must never be reused with the same key.
+ * @param[in] iv_len   Length of the IV in bytes (greater than 0).
+ * @param[in] aad      Pointer to the additional authenticated data (may be NULL if aad_len is 0).
+ * @param[in] aad_len  Length of the additional authenticated data in bytes.
+ * @param[out] output  Pointer to the ciphertext buffer, same size as the input buffer (may be the input buffer).
+ * @param[out] tag     Buffer of AES_GCM_TAG_SIZE bytes where the authentication tag is stored.
+ */
+void API_AES_GCM_encrypt(const uint8_t *input, size_t length, const uint8_t *key, size_t keySize, const uint8_t *iv, size_t iv_len, const uint8_t *aad, size_t aad_len, uint8_t *output, uint8_t tag[AES_GCM_TAG_SIZE]);
+
+/**
+ * @brief AES-GCM (Galois/Counter Mode) authenticated decryption, NIST SP 800-38D.
+ *
+ * Decrypts the input and checks the authentication tag in the same pass over the ciphertext. If the tag does not
+ * match, the output buffer is zeroized, so unauthenticated plaintext is never released.
+ *
+ * @param[in] input    Pointer to the ciphertext.
+ * @param[in] length   Length of the ciphertext in bytes.
+ * @param[in] key      Pointer to the AES key.
+ * @param[in] keySize  Size of the AES key in bytes (typically 16, 24, or 32).
+ * @param[in] iv       Pointer to the IV used to encrypt.
+ * @param[in] iv_len   Length of the IV in bytes (greater than 0).
+ * @param[in] aad      Pointer to the additional authenticated data (may be NULL if aad_len is 0).
+ * @param[in] aad_len  Length of the additional authenticated data in bytes.
+ * @param[in] tag      Authentication tag to verify.
+ * @param[in] tag_len  Length of the tag in bytes (AES_GCM_MIN_TAG_SIZE to AES_GCM_TAG_SIZE, the leftmost bytes
+ *                     are compared, shorter tags are rejected).
+ * @param[out] output  Pointer to the plaintext buffer, same size as the input buffer (may be the input buffer).
+ *
+ * @return AES_GCM_TAG_OK if the tag is verified, AES_GCM_TAG_NOT_VERIFIED otherwise.
+ */
+int API_AES_GCM_decrypt(const uint8_t *input, size_t length, const uint8_t *key, size_t keySize, const uint8_t *iv, size_t iv_len, const uint8_t *aad, size_t aad_len, const uint8_t *tag, size_t tag_len, uint8_t *output);
+
+/**
+ * @brief AES-GCM authenticated encryption with an already expanded key.
+ *
+ * Same as API_AES_GCM_encrypt, but the key schedule is passed by handle (see API_KM_loadkey). Only stack buffers
+ * are used, so it can be called concurrently with the same context.
+ */
+void API_AES_GCM_encrypt_ctx(AesContext const *ctx, const uint8_t *input, size_t length, const uint8_t *iv, size_t iv_len, const uint8_t *aad, size_t aad_len, uint8_t *output, uint8_t tag[AES_GCM_TAG_SIZE]);
+
+/**
+ * @brief AES-GCM authenticated decryption with an already expanded key.
+ *
+ * Same as API_AES_GCM_decrypt, but the key schedule is passed by handle.
+ *
+ * @return AES_GCM_TAG_OK if the tag is verified, AES_GCM_TAG_NOT_VERIFIED otherwise (the output is zeroized).
+ */
+int API_AES_GCM_decrypt_ctx(AesContext const *ctx, const uint8_t *input, size_t length, const uint8_t *iv, size_t iv_len, const uint8_t *aad, size_t aad_len, const uint8_t *tag, size_t tag_len, uint8_t *output);
+
+#endif
@@ -57,4 +57,18 @@ extern AesContext AESOFB_CTX;                      // AES AESOFB_CTX to store th
  */
 void API_AES_OFB_EncryptDecrypt(const uint8_t *input, size_t length, const uint8_t *key, size_t keySize, uint8_t *iv, uint8_t *output);
 
+/**
+ * @brief AES-OFB (Output Feedback) encryption/decryption function with an already expanded key.
+ *
+ * Same as API_AES_OFB_EncryptDecrypt, but the key schedule is passed by handle, so keys that are used
+ * for many messages (like the file system key, see API_FS_setup_cipher) are expanded only once.
+ *
+ * @param[in] ctx     AES context initialized with API_AES_initkey.
+ * @param[in] input   Pointer to the input data to be encrypted or decrypted.
+ * @param[in] length  Length of the input data in bytes.
+ * @param[in, out] iv Pointer to the initialization vector (IV).
+ * @param[out] output Pointer to the output buffer, same size as the input buffer.
+ */
+void API_AES_OFB_EncryptDecrypt_ctx(AesContext const *ctx, const uint8_t *input, size_t length, uint8_t *iv, uint8_t *output);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,483 @@
+/**
+ * @file CHACHA20_POLY1305.c
+ * @brief File containing the implementation of the ChaCha20-Poly1305 AEAD (RFC 8439).
+ */
+
+/****************************************************************************************************************
+ * Private include files
+ ****************************************************************************************************************/
+#include "CHACHA20_POLY1305.h"
+
+static CHACHA20_implementation CHACHA20_implement = chacha20_still_to_check;
+
+// Poly1305 accumulator and key, 44/44/42 bits limbs so the products fit in 128 bits
+typedef struct CP_POLY1305_state
+{
+  uint64_t r[3];   // CSP
+  uint64_t h[3];
+  uint64_t pad[2]; // CSP, s part of the key
+} CP_POLY1305_state;
+
+/****************************************************************************************************************
+ * Function definition zone
+ ****************************************************************************************************************/
+
+static uint32_t CP_CHACHA20_load_le32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t CP_CHACHA20_load_le64(const uint8_t *p)
+{
+  return (uint64_t)CP_CHACHA20_load_le32(p) | ((uint64_t)CP_CHACHA20_load_le32(p + 4) << 32);
+}
+
+static void CP_CHACHA20_store_le64(uint8_t *p, uint64_t v)
+{
+  for (int i = 0; i < 8; i++)
+    p[i] = (uint8_t)(v >> (8 * i));
+}
+
+// function to check if AVX2 instructions are supported and the YMM state is enabled by the OS
+static int CP_CHACHA20_supportsAVX2()
+{
+  unsigned int eax, ebx, ecx, edx;
+  unsigned int xcr0_lo, xcr0_hi;
+
+  __cpuid(1, eax, ebx, ecx, edx);
+  if ((ecx & (1 << 27)) == 0 || __get_cpuid_max(0, NULL) < 7) // no OSXSAVE (XGETBV) or no leaf 7
+    return 0;
+  __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  if ((xcr0_lo & 0x6) != 0x6) // XMM and YMM states saved by the OS
+    return 0;
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  return (ebx & (1 << 5)) != 0;
+}
+
+CHACHA20_implementation API_CHACHA20_getImplementation()
+{
+  if (CHACHA20_implement == chacha20_still_to_check)
+    CHACHA20_implement = CP_CHACHA20_supportsAVX2() ? chacha20_AVX2 : chacha20_SSE2;
+  return CHACHA20_implement;
+}
+
+// ChaCha20 initial state: constants "expand 32-byte k", key, block counter and nonce
+static void CP_CHACHA20_init_state(uint32_t state[16], const uint8_t key[CHACHA20_KEY_SIZE], uint32_t counter, const uint8_t nonce[CHACHA20_NONCE_SIZE])
+{
+  state[0] = 0x61707865;
+  state[1] = 0x3320646e;
+  state[2] = 0x79622d32;
+  state[3] = 0x6b206574;
+  for (int i = 0; i < 8; i++)
+    state[4 + i] = CP_CHACHA20_load_le32(key + 4 * i);
+  state[12] = counter;
+  for (int i = 0; i < 3; i++)
+    state[13 + i] = CP_CHACHA20_load_le32(nonce + 4 * i);
+}
+
+//////////////////////////////////////////// SCALAR CHACHA20 //////////////////////////////////////////
+
+#define CHACHA20_ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define CHACHA20_QUARTER_ROUND(x, a, b, c, d)                       \
+  do                                                              \
+  {                                                               \
+    x[a] += x[b]; x[d] ^= x[a]; x[d] = CHACHA20_ROTL32(x[d], 16); \
+    x[c] += x[d]; x[b] ^= x[c]; x[b] = CHACHA20_ROTL32(x[b], 12); \
+    x[a] += x[b]; x[d] ^= x[a]; x[d] = CHACHA20_ROTL32(x[d], 8);  \
+    x[c] += x[d]; x[b] ^= x[c]; x[b] = CHACHA20_ROTL32(x[b], 7);  \
+  } while (0)
+
+// One ChaCha20 block (20 rounds) of keystream, serialized in little-endian
+static void CP_CHACHA20_block(const uint32_t state[16], uint8_t keystream[CHACHA20_BLOCK_SIZE])
+{
+  uint32_t x[16];
+
+  memcpy(x, state, sizeof(x));
+  for (int i = 0; i < 10; i++)
+  {
+    CHACHA20_QUARTER_ROUND(x, 0, 4, 8, 12);
+    CHACHA20_QUARTER_ROUND(x, 1, 5, 9, 13);
+    CHACHA20_QUARTER_ROUND(x, 2, 6, 10, 14);
+    CHACHA20_QUARTER_ROUND(x, 3, 7, 11, 15);
+    CHACHA20_QUARTER_ROUND(x, 0, 5, 10, 15);
+    CHACHA20_QUARTER_ROUND(x, 1, 6, 11, 12);
+    CHACHA20_QUARTER_ROUND(x, 2, 7, 8, 13);
+    CHACHA20_QUARTER_ROUND(x, 3, 4, 9, 14);
+  }
+  for (int i = 0; i < 16; i++)
+  {
+    uint32_t v = x[i] + state[i];
+    keystream[4 * i + 0] = (uint8_t)v;
+    keystream[4 * i + 1] = (uint8_t)(v >> 8);
+    keystream[4 * i + 2] = (uint8_t)(v >> 16);
+    keystream[4 * i + 3] = (uint8_t)(v >> 24);
+  }
+  memset(x, 0, sizeof(x));
+}
+
+//////////////////////////////////////////// SSE2 CHACHA20, 4 BLOCKS //////////////////////////////////////////
+
+// Every register holds the same state word of 4 consecutive blocks
+#define CHACHA20_SSE2_ROTL(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+
+#define CHACHA20_SSE2_QUARTER_ROUND(x, a, b, c, d)                                                                          \
+  do                                                                                                                      \
+  {                                                                                                                       \
+    x[a] = _mm_add_epi32(x[a], x[b]); x[d] = _mm_xor_si128(x[d], x[a]); x[d] = CHACHA20_SSE2_ROTL(x[d], 16); \
+    x[c] = _mm_add_epi32(x[c], x[d]); x[b] = _mm_xor_si128(x[b], x[c]); x[b] = CHACHA20_SSE2_ROTL(x[b], 12); \
+    x[a] = _mm_add_epi32(x[a], x[b]); x[d] = _mm_xor_si128(x[d], x[a]); x[d] = CHACHA20_SSE2_ROTL(x[d], 8);  \
+    x[c] = _mm_add_epi32(x[c], x[d]); x[b] = _mm_xor_si128(x[b], x[c]); x[b] = CHACHA20_SSE2_ROTL(x[b], 7);  \
+  } while (0)
+
+// Encrypts 4 blocks (256 bytes) and advances the block counter
+static void CP_CHACHA20_sse2_4blocks(uint32_t state[16], const uint8_t *in, uint8_t *out)
+{
+  __m128i x[16], s[16];
+
+  for (int i = 0; i < 16; i++)
+    s[i] = _mm_set1_epi32((int)state[i]);
+  s[12] = _mm_add_epi32(s[12], _mm_set_epi32(3, 2, 1, 0));
+  memcpy(x, s, sizeof(x));
+
+  for (int i = 0; i < 10; i++)
+  {
+    CHACHA20_SSE2_QUARTER_ROUND(x, 0, 4, 8, 12);
+    CHACHA20_SSE2_QUARTER_ROUND(x, 1, 5, 9, 13);
+    CHACHA20_SSE2_QUARTER_ROUND(x, 2, 6, 10, 14);
+    CHACHA20_SSE2_QUARTER_ROUND(x, 3, 7, 11, 15);
+    CHACHA20_SSE2_QUARTER_ROUND(x, 0, 5, 10, 15);
+    CHACHA20_SSE2_QUARTER_ROUND(x, 1, 6, 11, 12);
+    CHACHA20_SSE2_QUARTER_ROUND(x, 2, 7, 8, 13);
+    CHACHA20_SSE2_QUARTER_ROUND(x, 3, 4, 9, 14);
+  }
+
+  // Transpose every group of 4 words back to block order and XOR it with the input
+  for (int g = 0; g < 4; g++)
+  {
+    __m128i a = _mm_add_epi32(x[4 * g + 0], s[4 * g + 0]);
+    __m128i b = _mm_add_epi32(x[4 * g + 1], s[4 * g + 1]);
+    __m128i c = _mm_add_epi32(x[4 * g + 2], s[4 * g + 2]);
+    __m128i d = _mm_add_epi32(x[4 * g + 3], s[4 * g + 3]);
+    __m128i t0 = _mm_unpacklo_epi32(a, b);
+    __m128i t1 = _mm_unpacklo_epi32(c, d);
+    __m128i t2 = _mm_unpackhi_epi32(a, b);
+    __m128i t3 = _mm_unpackhi_epi32(c, d);
+    __m128i blocks[4] = {_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1), _mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3)};
+
+    for (int j = 0; j < 4; j++)
+    {
+      const __m128i *src = (const __m128i *)(in + j * CHACHA20_BLOCK_SIZE + 16 * g);
+      _mm_storeu_si128((__m128i *)(out + j * CHACHA20_BLOCK_SIZE + 16 * g), _mm_xor_si128(_mm_loadu_si128(src), blocks[j]));
+    }
+  }
+  state[12] += 4;
+}
+
+//////////////////////////////////////////// AVX2 CHACHA20, 8 BLOCKS //////////////////////////////////////////
+
+#define CHACHA20_AVX2_ROTL(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+
+// Rotations by 16 and 8 bits are byte permutations
+#define CHACHA20_AVX2_QUARTER_ROUND(x, a, b, c, d, rot16, rot8)                                                                        \
+  do                                                                                                                                 \
+  {                                                                                                                                  \
+    x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = _mm256_xor_si256(x[d], x[a]); x[d] = _mm256_shuffle_epi8(x[d], rot16);  \
+    x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = _mm256_xor_si256(x[b], x[c]); x[b] = CHACHA20_AVX2_ROTL(x[b], 12);      \
+    x[a] = _mm256_add_epi32(x[a], x[b]); x[d] = _mm256_xor_si256(x[d], x[a]); x[d] = _mm256_shuffle_epi8(x[d], rot8);   \
+    x[c] = _mm256_add_epi32(x[c], x[d]); x[b] = _mm256_xor_si256(x[b], x[c]); x[b] = CHACHA20_AVX2_ROTL(x[b], 7);       \
+  } while (0)
+
+// Encrypts 8 blocks (512 bytes) and advances the block counter. Lane 0 of every register holds blocks 0-3 and lane 1 blocks 4-7
+__attribute__((target("avx2"))) static void CP_CHACHA20_avx2_8blocks(uint32_t state[16], const uint8_t *in, uint8_t *out)
+{
+  const __m256i rot16 = _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                          13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+  const __m256i rot8 = _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+                                         14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+  __m256i x[16], s[16];
+  __m256i rows[4][4]; // rows[g][j]: words 4g..4g+3 of blocks j (lane 0) and j + 4 (lane 1)
+
+  for (int i = 0; i < 16; i++)
+    s[i] = _mm256_set1_epi32((int)state[i]);
+  s[12] = _mm256_add_epi32(s[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+  memcpy(x, s, sizeof(x));
+
+  for (int i = 0; i < 10; i++)
+  {
+    CHACHA20_AVX2_QUARTER_ROUND(x, 0, 4, 8, 12, rot16, rot8);
+    CHACHA20_AVX2_QUARTER_ROUND(x, 1, 5, 9, 13, rot16, rot8);
+    CHACHA20_AVX2_QUARTER_ROUND(x, 2, 6, 10, 14, rot16, rot8);
+    CHACHA20_AVX2_QUARTER_ROUND(x, 3, 7, 11, 15, rot16, rot8);
+    CHACHA20_AVX2_QUARTER_ROUND(x, 0, 5, 10, 15, rot16, rot8);
+    CHACHA20_AVX2_QUARTER_ROUND(x, 1, 6, 11, 12, rot16, rot8);
+    CHACHA20_AVX2_QUARTER_ROUND(x, 2, 7, 8, 13, rot16, rot8);
+    CHACHA20_AVX2_QUARTER_ROUND(x, 3, 4, 9, 14, rot16, rot8);
+  }
+
+  // 4x4 transposition inside every 128 bits lane
+  for (int g = 0; g < 4; g++)
+  {
+    __m256i a = _mm256_add_epi32(x[4 * g + 0], s[4 * g + 0]);
+    __m256i b = _mm256_add_epi32(x[4 * g + 1], s[4 * g + 1]);
+    __m256i c = _mm256_add_epi32(x[4 * g + 2], s[4 * g + 2]);
+    __m256i d = _mm256_add_epi32(x[4 * g + 3], s[4 * g + 3]);
+    __m256i t0 = _mm256_unpacklo_epi32(a, b);
+    __m256i t1 = _mm256_unpacklo_epi32(c, d);
+    __m256i t2 = _mm256_unpackhi_epi32(a, b);
+    __m256i t3 = _mm256_unpackhi_epi32(c, d);
+    rows[g][0] = _mm256_unpacklo_epi64(t0, t1);
+    rows[g][1] = _mm256_unpackhi_epi64(t0, t1);
+    rows[g][2] = _mm256_unpacklo_epi64(t2, t3);
+    rows[g][3] = _mm256_unpackhi_epi64(t2, t3);
+  }
+
+  // Join the lanes of the same block and XOR it with the input
+  for (int j = 0; j < 4; j++)
+  {
+    const __m256i *src_lo = (const __m256i *)(in + j * CHACHA20_BLOCK_SIZE);
+    const __m256i *src_hi = (const __m256i *)(in + (j + 4) * CHACHA20_BLOCK_SIZE);
+    __m256i *dst_lo = (__m256i *)(out + j * CHACHA20_BLOCK_SIZE);
+    __m256i *dst_hi = (__m256i *)(out + (j + 4) * CHACHA20_BLOCK_SIZE);
+
+    _mm256_storeu_si256(dst_lo, _mm256_xor_si256(_mm256_loadu_si256(src_lo), _mm256_permute2x128_si256(rows[0][j], rows[1][j], 0x20)));
+    _mm256_storeu_si256(dst_lo + 1, _mm256_xor_si256(_mm256_loadu_si256(src_lo + 1), _mm256_permute2x128_si256(rows[2][j], rows[3][j], 0x20)));
+    _mm256_storeu_si256(dst_hi, _mm256_xor_si256(_mm256_loadu_si256(src_hi), _mm256_permute2x128_si256(rows[0][j], rows[1][j], 0x31)));
+    _mm256_storeu_si256(dst_hi + 1, _mm256_xor_si256(_mm256_loadu_si256(src_hi + 1), _mm256_permute2x128_si256(rows[2][j], rows[3][j], 0x31)));
+  }
+  state[12] += 8;
+}
+
+// XORs the keystream starting at the block counter of the state with the input, widest kernel first
+static void CP_CHACHA20_xor(uint32_t state[16], const uint8_t *in, uint8_t *out, size_t length)
+{
+  uint8_t keystream[CHACHA20_BLOCK_SIZE]; // CSP
+
+  if (API_CHACHA20_getImplementation() == chacha20_AVX2)
+  {
+    for (; length >= 8 * CHACHA20_BLOCK_SIZE; length -= 8 * CHACHA20_BLOCK_SIZE)
+    {
+      CP_CHACHA20_avx2_8blocks(state, in, out);
+      in += 8 * CHACHA20_BLOCK_SIZE;
+      out += 8 * CHACHA20_BLOCK_SIZE;
+    }
+  }
+  for (; length >= 4 * CHACHA20_BLOCK_SIZE; length -= 4 * CHACHA20_BLOCK_SIZE)
+  {
+    CP_CHACHA20_sse2_4blocks(state, in, out);
+    in += 4 * CHACHA20_BLOCK_SIZE;
+    out += 4 * CHACHA20_BLOCK_SIZE;
+  }
+  while (length > 0)
+  {
+    size_t n = (length < CHACHA20_BLOCK_SIZE) ? length : CHACHA20_BLOCK_SIZE;
+    CP_CHACHA20_block(state, keystream);
+    for (size_t i = 0; i < n; i++)
+      out[i] = in[i] ^ keystream[i];
+    state[12]++;
+    in += n;
+    out += n;
+    length -= n;
+  }
+  memset(keystream, 0, sizeof(keystream));
+}
+
+void API_CHACHA20_encrypt(const uint8_t key[CHACHA20_KEY_SIZE], uint32_t counter, const uint8_t nonce[CHACHA20_NONCE_SIZE], const uint8_t *input, size_t length, uint8_t *output)
+{
+  uint32_t state[16]; // CSP
+
+  CP_CHACHA20_init_state(state, key, counter, nonce);
+  CP_CHACHA20_xor(state, input, output, length);
+  memset(state, 0, sizeof(state));
+}
+
+//////////////////////////////////////////// POLY1305 //////////////////////////////////////////
+
+static void CP_POLY1305_init(CP_POLY1305_state *st, const uint8_t key[POLY1305_KEY_SIZE])
+{
+  uint64_t t0 = CP_CHACHA20_load_le64(key);
+  uint64_t t1 = CP_CHACHA20_load_le64(key + 8);
+
+  // r is clamped as required by the specification
+  st->r[0] = t0 & 0xffc0fffffffULL;
+  st->r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffffULL;
+  st->r[2] = (t1 >> 24) & 0x00ffffffc0fULL;
+  st->h[0] = st->h[1] = st->h[2] = 0;
+  st->pad[0] = CP_CHACHA20_load_le64(key + 16);
+  st->pad[1] = CP_CHACHA20_load_le64(key + 24);
+}
+
+// h = (h + block) * r mod 2^130 - 5 for every 16 bytes block, hibit is 2^128 (1 << 40 on the top limb) for full blocks
+static void CP_POLY1305_blocks(CP_POLY1305_state *st, const uint8_t *data, size_t nblocks, uint64_t hibit)
+{
+  const uint64_t mask44 = 0xfffffffffffULL, mask42 = 0x3ffffffffffULL;
+  uint64_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2];
+  uint64_t s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+  uint64_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2];
+
+  for (; nblocks > 0; nblocks--, data += 16)
+  {
+    uint64_t t0 = CP_CHACHA20_load_le64(data);
+    uint64_t t1 = CP_CHACHA20_load_le64(data + 8);
+    unsigned __int128 d0, d1, d2;
+    uint64_t c;
+
+    h0 += t0 & mask44;
+    h1 += ((t0 >> 44) | (t1 << 20)) & mask44;
+    h2 += ((t1 >> 24) & mask42) | hibit;
+
+    d0 = (unsigned __int128)h0 * r0 + (unsigned __int128)h1 * s2 + (unsigned __int128)h2 * s1;
+    d1 = (unsigned __int128)h0 * r1 + (unsigned __int128)h1 * r0 + (unsigned __int128)h2 * s2;
+    d2 = (unsigned __int128)h0 * r2 + (unsigned __int128)h1 * r1 + (unsigned __int128)h2 * r0;
+
+    c = (uint64_t)(d0 >> 44);
+    h0 = (uint64_t)d0 & mask44;
+    d1 += c;
+    c = (uint64_t)(d1 >> 44);
+    h1 = (uint64_t)d1 & mask44;
+    d2 += c;
+    c = (uint64_t)(d2 >> 42);
+    h2 = (uint64_t)d2 & mask42;
+    h0 += c * 5;
+    c = h0 >> 44;
+    h0 &= mask44;
+    h1 += c;
+  }
+  st->h[0] = h0;
+  st->h[1] = h1;
+  st->h[2] = h2;
+}
+
+// Hashes len bytes padded with zeros to a multiple of 16 (the padding of the AEAD construction)
+static void CP_POLY1305_update_padded(CP_POLY1305_state *st, const uint8_t *data, size_t length)
+{
+  size_t nblocks = length / 16;
+  size_t rest = length % 16;
+
+  CP_POLY1305_blocks(st, data, nblocks, (uint64_t)1 << 40);
+  if (rest > 0)
+  {
+    uint8_t last[16] = {0};
+    memcpy(last, data + nblocks * 16, rest);
+    CP_POLY1305_blocks(st, last, 1, (uint64_t)1 << 40);
+  }
+}
+
+// Full reduction of h, tag = h + s mod 2^128
+static void CP_POLY1305_finish(CP_POLY1305_state *st, uint8_t tag[POLY1305_TAG_SIZE])
+{
+  const uint64_t mask44 = 0xfffffffffffULL, mask42 = 0x3ffffffffffULL;
+  uint64_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2];
+  uint64_t g0, g1, g2, c, t0, t1;
+
+  c = h1 >> 44; h1 &= mask44;
+  h2 += c; c = h2 >> 42; h2 &= mask42;
+  h0 += c * 5; c = h0 >> 44; h0 &= mask44;
+  h1 += c; c = h1 >> 44; h1 &= mask44;
+  h2 += c; c = h2 >> 42; h2 &= mask42;
+  h0 += c * 5; c = h0 >> 44; h0 &= mask44;
+  h1 += c;
+
+  // g = h - p = h + 5 - 2^130, selected without branches if h >= p
+  g0 = h0 + 5; c = g0 >> 44; g0 &= mask44;
+  g1 = h1 + c; c = g1 >> 44; g1 &= mask44;
+  g2 = h2 + c - ((uint64_t)1 << 42);
+  c = (g2 >> 63) - 1; // all ones if there was no borrow
+  g0 &= c; g1 &= c; g2 &= c;
+  c = ~c;
+  h0 = (h0 & c) | g0;
+  h1 = (h1 & c) | g1;
+  h2 = (h2 & c) | g2;
+
+  // h + s
+  t0 = st->pad[0];
+  t1 = st->pad[1];
+  h0 += t0 & mask44; c = h0 >> 44; h0 &= mask44;
+  h1 += (((t0 >> 44) | (t1 << 20)) & mask44) + c; c = h1 >> 44; h1 &= mask44;
+  h2 += ((t1 >> 24) & mask42) + c; h2 &= mask42;
+
+  CP_CHACHA20_store_le64(tag, h0 | (h1 << 44));
+  CP_CHACHA20_store_le64(tag + 8, (h1 >> 20) | (h2 << 24));
+  memset(st, 0, sizeof(*st));
+}
+
+void API_POLY1305_mac(const uint8_t key[POLY1305_KEY_SIZE], const uint8_t *msg, size_t length, uint8_t tag[POLY1305_TAG_SIZE])
+{
+  CP_POLY1305_state st;
+  size_t nblocks = length / 16;
+  size_t rest = length % 16;
+
+  CP_POLY1305_init(&st, key);
+  CP_POLY1305_blocks(&st, msg, nblocks, (uint64_t)1 << 40);
+  if (rest > 0)
+  {
+    // the last partial block is ended with a 1 byte instead of the 2^128 bit
+    uint8_t last[16] = {0};
+    memcpy(last, msg + nblocks * 16, rest);
+    last[rest] = 1;
+    CP_POLY1305_blocks(&st, last, 1, 0);
+  }
+  CP_POLY1305_finish(&st, tag);
+}
+
+//////////////////////////////////////////// CHACHA20-POLY1305 AEAD //////////////////////////////////////////
+
+// Encrypts or decrypts chunk by chunk, the Poly1305 of the ciphertext of each chunk is computed while it is in L1
+static void CP_CHACHA20_POLY1305_crypt(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE], const uint8_t *aad, size_t aad_len, const uint8_t *input, size_t length, uint8_t *output, int decrypt, uint8_t tag[POLY1305_TAG_SIZE])
+{
+  uint32_t state[16];                    // CSP
+  uint8_t poly_key[CHACHA20_BLOCK_SIZE]; // CSP, only the first 32 bytes are used
+  uint8_t lengths[16];
+  CP_POLY1305_state st;
+
+  // The one-time Poly1305 key is the first block of keystream (counter 0), the payload uses the next ones
+  CP_CHACHA20_init_state(state, key, 0, nonce);
+  CP_CHACHA20_block(state, poly_key);
+  state[12] = 1;
+  CP_POLY1305_init(&st, poly_key);
+
+  if (aad_len > 0)
+    CP_POLY1305_update_padded(&st, aad, aad_len);
+
+  for (size_t done = 0; done < length; done += CHACHA20_POLY1305_CHUNK_SIZE)
+  {
+    size_t chunk = (length - done < CHACHA20_POLY1305_CHUNK_SIZE) ? length - done : CHACHA20_POLY1305_CHUNK_SIZE;
+    if (decrypt)
+      CP_POLY1305_update_padded(&st, input + done, chunk);
+    CP_CHACHA20_xor(state, input + done, output + done, chunk);
+    if (!decrypt)
+      CP_POLY1305_update_padded(&st, output + done, chunk);
+  }
+
+  CP_CHACHA20_store_le64(lengths, aad_len);
+  CP_CHACHA20_store_le64(lengths + 8, length);
+  CP_POLY1305_blocks(&st, lengths, 1, (uint64_t)1 << 40);
+  CP_POLY1305_finish(&st, tag);
+
+  memset(state, 0, sizeof(state));
+  memset(poly_key, 0, sizeof(poly_key));
+}
+
+void API_CHACHA20_POLY1305_encrypt(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE], const uint8_t *aad, size_t aad_len, const uint8_t *input, size_t length, uint8_t *output, uint8_t tag[POLY1305_TAG_SIZE])
+{
+  CP_CHACHA20_POLY1305_crypt(key, nonce, aad, aad_len, input, length, output, 0, tag);
+}
+
+int API_CHACHA20_POLY1305_decrypt(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE], const uint8_t *aad, size_t aad_len, const uint8_t *input, size_t length, const uint8_t tag[POLY1305_TAG_SIZE], uint8_t *output)
+{
+  uint8_t computed_tag[POLY1305_TAG_SIZE];
+  uint8_t diff = 0;
+
+  CP_CHACHA20_POLY1305_crypt(key, nonce, aad, aad_len, input, length, output, 1, computed_tag);
+
+  // Constant time comparison of the tags
+  for (int i = 0; i < POLY1305_TAG_SIZE; i++)
+    diff |= computed_tag[i] ^ tag[i];
+
+  if (diff != 0)
+  {
+    memset(output, 0, length); // do not release unauthenticated plaintext
+    return CHACHA20_POLY1305_TAG_NOT_VERIFIED;
+  }
+  return CHACHA20_POLY1305_TAG_OK;
+}
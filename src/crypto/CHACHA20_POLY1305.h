@@ -0,0 +1,121 @@
+/**
+ * @file CHACHA20_POLY1305.h
+ * @brief File containing all the function headers of the ChaCha20-Poly1305 AEAD (RFC 8439).
+ */
+
+#ifndef CHACHA20_POLY1305_H
+#define CHACHA20_POLY1305_H
+
+/****************************************************************************************************************
+ * Compiler include files
+ ****************************************************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <cpuid.h>
+#include <immintrin.h>
+
+/****************************************************************************************************************
+ * Global variables/constants definition
+ ****************************************************************************************************************/
+
+#define CHACHA20_KEY_SIZE 32
+
+#define CHACHA20_NONCE_SIZE 12
+
+#define CHACHA20_BLOCK_SIZE 64
+
+#define POLY1305_KEY_SIZE 32
+
+#define POLY1305_TAG_SIZE 16
+
+#define CHACHA20_POLY1305_TAG_OK 1
+
+#define CHACHA20_POLY1305_TAG_NOT_VERIFIED 0
+
+/**
+ * @brief Number of bytes encrypted before they are authenticated in the AEAD functions
+ *
+ * The payload is processed in chunks of this size (a multiple of the 8 blocks of the AVX2 kernel), the Poly1305
+ * of a chunk is computed while it is still in L1, so the payload is read only once.
+ */
+#define CHACHA20_POLY1305_CHUNK_SIZE 1024
+
+/**
+ * @brief ChaCha20 implementations, selected once with CPUID
+ */
+typedef enum CHACHA20_implementation
+{
+    chacha20_still_to_check,
+    chacha20_scalar,
+    chacha20_SSE2, // 4 blocks per pass
+    chacha20_AVX2, // 8 blocks per pass
+} CHACHA20_implementation;
+
+/****************************************************************************************************************
+ * Function definition zone
+ ****************************************************************************************************************/
+
+/**
+ * @brief Returns the ChaCha20 implementation used in this machine, checking it with CPUID the first time.
+ *
+ * @return chacha20_AVX2 if AVX2 is supported and enabled by the OS, chacha20_SSE2 otherwise (x86-64 always has SSE2).
+ */
+CHACHA20_implementation API_CHACHA20_getImplementation();
+
+/**
+ * @brief ChaCha20 stream cipher (RFC 8439, section 2.4), XORs the keystream with the input.
+ *
+ * @param[in] key     32 bytes key.
+ * @param[in] counter Initial block counter.
+ * @param[in] nonce   12 bytes nonce.
+ * @param[in] input   Pointer to the input data.
+ * @param[in] length  Length of the input data in bytes.
+ * @param[out] output Pointer to the output buffer, same size as the input buffer (may be the input buffer).
+ */
+void API_CHACHA20_encrypt(const uint8_t key[CHACHA20_KEY_SIZE], uint32_t counter, const uint8_t nonce[CHACHA20_NONCE_SIZE], const uint8_t *input, size_t length, uint8_t *output);
+
+/**
+ * @brief Poly1305 one-time authenticator (RFC 8439, section 2.5).
+ *
+ * @param[in] key     32 bytes one-time key (r and s), must never be used for two messages.
+ * @param[in] msg     Pointer to the message.
+ * @param[in] length  Length of the message in bytes.
+ * @param[out] tag    16 bytes tag.
+ */
+void API_POLY1305_mac(const uint8_t key[POLY1305_KEY_SIZE], const uint8_t *msg, size_t length, uint8_t tag[POLY1305_TAG_SIZE]);
+
+/**
+ * @brief ChaCha20-Poly1305 authenticated encryption (RFC 8439, section 2.8).
+ *
+ * @param[in] key      32 bytes key.
+ * @param[in] nonce    12 bytes nonce, must never be reused with the same key.
+ * @param[in] aad      Pointer to the additional authenticated data (may be NULL if aad_len is 0).
+ * @param[in] aad_len  Length of the additional authenticated data in bytes.
+ * @param[in] input    Pointer to the plaintext.
+ * @param[in] length   Length of the plaintext in bytes.
+ * @param[out] output  Pointer to the ciphertext buffer, same size as the input buffer (may be the input buffer).
+ * @param[out] tag     Buffer of POLY1305_TAG_SIZE bytes where the tag is stored.
+ */
+void API_CHACHA20_POLY1305_encrypt(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE], const uint8_t *aad, size_t aad_len, const uint8_t *input, size_t length, uint8_t *output, uint8_t tag[POLY1305_TAG_SIZE]);
+
+/**
+ * @brief ChaCha20-Poly1305 authenticated decryption (RFC 8439, section 2.8).
+ *
+ * Decrypts and authenticates in a single pass, if the tag does not match the output buffer is zeroized.
+ *
+ * @param[in] key      32 bytes key.
+ * @param[in] nonce    12 bytes nonce used to encrypt.
+ * @param[in] aad      Pointer to the additional authenticated data (may be NULL if aad_len is 0).
+ * @param[in] aad_len  Length of the additional authenticated data in bytes.
+ * @param[in] input    Pointer to the ciphertext.
+ * @param[in] length   Length of the ciphertext in bytes.
+ * @param[in] tag      16 bytes tag to verify.
+ * @param[out] output  Pointer to the plaintext buffer, same size as the input buffer (may be the input buffer).
+ *
+ * @return CHACHA20_POLY1305_TAG_OK if the tag is verified, CHACHA20_POLY1305_TAG_NOT_VERIFIED otherwise.
+ */
+int API_CHACHA20_POLY1305_decrypt(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE], const uint8_t *aad, size_t aad_len, const uint8_t *input, size_t length, const uint8_t tag[POLY1305_TAG_SIZE], uint8_t *output);
+
+#endif
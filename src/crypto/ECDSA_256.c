@@ -29,6 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ECDSA_256.h"
 
 #include <string.h>
+#include <pthread.h>
+#include <cpuid.h>
 
 typedef unsigned int uint;
 
@@ -48,13 +50,26 @@ typedef struct
 } uint128_t;
 #endif
 
+/* P-256 field elements are kept in Montgomery form (a * 2^256 mod p) between the byte conversions */
+#if ECC_CURVE == secp256r1 && SUPPORTS_INT128
+    #define ECDSA_P256_MONTGOMERY 1
+#else
+    #define ECDSA_P256_MONTGOMERY 0
+#endif
+
 uint64_t ECDSA_curve_p[NUM_ECC_DIGITS] = CONCAT(Curve_P_, ECC_CURVE);
 uint64_t ECDSA_curve_b[NUM_ECC_DIGITS] = CONCAT(Curve_B_, ECC_CURVE);
 EccPoint ECDSA_curve_G = CONCAT(Curve_G_, ECC_CURVE);
 uint64_t ECDSA_curve_n[NUM_ECC_DIGITS] = CONCAT(Curve_N_, ECC_CURVE);
-uint64_t ECDSA_k[NUM_ECC_DIGITS];
-uint64_t ECDSA_l_tmp[NUM_ECC_DIGITS];
-uint64_t ECDSA_l_s[NUM_ECC_DIGITS];
+EccPoint ECDSA_G_table[ECDSA_G_TABLE_WINDOWS][ECDSA_G_TABLE_POINTS];
+ECDSA_DECOMPRESSED_KEY ECDSA_decompress_cache[ECDSA_DECOMPRESS_CACHE_SIZE];
+ECDSA_NONCE_POOL ECDSA_nonce_pool;
+ECDSA_CTX ECDSA_sign_ctx;
+
+static pthread_once_t ECDSA_G_table_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t ECDSA_decompress_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t ECDSA_sign_lock = PTHREAD_MUTEX_INITIALIZER; // serializes the signatures made with ECDSA_sign_ctx
+static uint ECDSA_decompress_next = 0;
 
 /* Assume that we are using a POSIX-like system with /dev/urandom or /dev/random. */
 #include <sys/types.h>
@@ -65,17 +80,36 @@ uint64_t ECDSA_l_s[NUM_ECC_DIGITS];
     #define O_CLOEXEC 0
 #endif
 
-static int getRandomNumber(uint64_t *p_vli)
+/* Descriptor of the random device, shared by all the threads and kept open once it is opened, so every random
+   number is one read. Opening it again is tried on the next call if it failed. */
+static pthread_mutex_t ECDSA_random_lock = PTHREAD_MUTEX_INITIALIZER;
+static int ECDSA_random_fd = -1;
+
+static int getRandomFd()
 {
-    int l_fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
-    if(l_fd == -1)
+    int l_fd;
+
+    pthread_mutex_lock(&ECDSA_random_lock);
+    if(ECDSA_random_fd == -1)
     {
-        l_fd = open("/dev/random", O_RDONLY | O_CLOEXEC);
-        if(l_fd == -1)
+        ECDSA_random_fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+        if(ECDSA_random_fd == -1)
         {
-            return 0;
+            ECDSA_random_fd = open("/dev/random", O_RDONLY | O_CLOEXEC);
         }
     }
+    l_fd = ECDSA_random_fd;
+    pthread_mutex_unlock(&ECDSA_random_lock);
+    return l_fd;
+}
+
+static int getRandomNumber(uint64_t *p_vli)
+{
+    int l_fd = getRandomFd();
+    if(l_fd == -1)
+    {
+        return 0;
+    }
     
     char *l_ptr = (char *)p_vli;
     size_t l_left = ECC_BYTES;
@@ -84,14 +118,12 @@ static int getRandomNumber(uint64_t *p_vli)
         int l_read = read(l_fd, l_ptr, l_left);
         if(l_read <= 0)
         { // read failed
-            close(l_fd);
             return 0;
         }
         l_left -= l_read;
         l_ptr += l_read;
     }
     
-    close(l_fd);
     return 1;
 }
 
@@ -251,6 +283,16 @@ static uint64_t vli_sub(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
     return l_borrow;
 }
 
+/* p_dest = p_mask ? p_src : p_dest, without branches. */
+static void vli_select(uint64_t *p_dest, const uint64_t *p_src, uint64_t p_mask)
+{
+    uint i;
+    for(i = 0; i < NUM_ECC_DIGITS; ++i)
+    {
+        p_dest[i] = (p_dest[i] & ~p_mask) | (p_src[i] & p_mask);
+    }
+}
+
 #if SUPPORTS_INT128
 
 /* Computes p_result = p_left * p_right. */
@@ -279,6 +321,8 @@ static void vli_mult(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
     p_result[NUM_ECC_DIGITS*2 - 1] = (uint64_t)r01;
 }
 
+#if !ECDSA_P256_MONTGOMERY /* the Montgomery field squares with vli_montMult */
+
 /* Computes p_result = p_left^2. */
 static void vli_square(uint64_t *p_result, uint64_t *p_left)
 {
@@ -308,6 +352,8 @@ static void vli_square(uint64_t *p_result, uint64_t *p_left)
     p_result[NUM_ECC_DIGITS*2 - 1] = (uint64_t)r01;
 }
 
+#endif /* !ECDSA_P256_MONTGOMERY */
+
 #else /* #if SUPPORTS_INT128 */
 
 static uint128_t mul_64_64(uint64_t p_left, uint64_t p_right)
@@ -497,7 +543,7 @@ static void vli_mmod_fast(uint64_t *p_result, uint64_t *p_product)
     }
 }
 
-#elif ECC_CURVE == secp256r1
+#elif ECC_CURVE == secp256r1 && !ECDSA_P256_MONTGOMERY
 
 /* Computes p_result = p_product % ECDSA_curve_p
    from http://www.nsa.gov/ia/_files/nist-routines.pdf */
@@ -649,6 +695,203 @@ static void vli_mmod_fast(uint64_t *p_result, uint64_t *p_product)
 
 #endif
 
+#if ECDSA_P256_MONTGOMERY
+
+/* Montgomery constants of P-256, R = 2^256 mod p and R^2 mod p */
+static uint64_t ECDSA_mont_one[NUM_ECC_DIGITS] = {0x0000000000000001ull, 0xFFFFFFFF00000000ull, 0xFFFFFFFFFFFFFFFFull, 0x00000000FFFFFFFEull};
+static uint64_t ECDSA_mont_R2[NUM_ECC_DIGITS] = {0x0000000000000003ull, 0xFFFFFFFBFFFFFFFFull, 0xFFFFFFFFFFFFFFFEull, 0x00000004FFFFFFFDull};
+
+static ECDSA_implementation ECDSA_implement = ecdsa_still_to_check;
+
+ECDSA_implementation API_ECDSA_getImplementation()
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if(ECDSA_implement == ecdsa_still_to_check)
+    {
+        ECDSA_implement = ecdsa_p256_portable;
+        if(__get_cpuid_max(0, NULL) >= 7)
+        {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            if((ebx & (1 << 8)) && (ebx & (1 << 19))) /* BMI2 (MULX) and ADX (ADCX, ADOX) */
+            {
+                ECDSA_implement = ecdsa_p256_MULX_ADX;
+            }
+        }
+    }
+    return ECDSA_implement;
+}
+
+/* Final step of the Montgomery multiplications, p_result = t - p_mod if t >= p_mod, t otherwise, for t < 2*p_mod
+   in five words. The borrow chain and the choice have no branches, like the cmovc of the MULX kernels, so the
+   Fermat inversions of secret values do not leak on hosts without BMI2/ADX. */
+static void vli_montReduceOnce(uint64_t *p_result, uint64_t *t, const uint64_t *p_mod)
+{
+    uint64_t l_sub[NUM_ECC_DIGITS];
+    uint64_t l_diff, l_borrow = 0;
+    uint i;
+
+    for(i = 0; i < NUM_ECC_DIGITS; ++i)
+    {
+        l_diff = t[i] - p_mod[i] - l_borrow;
+        l_borrow = ((~t[i] & p_mod[i]) | (~(t[i] ^ p_mod[i]) & l_diff)) >> 63;
+        l_sub[i] = l_diff;
+    }
+    /* keep t if the subtraction borrows past t[4], which is 0 or 1 */
+    vli_set(p_result, l_sub);
+    vli_select(p_result, t, (uint64_t)0 - (l_borrow & ~t[4] & 1));
+}
+
+/* Montgomery multiplication p_result = p_left * p_right / 2^256 mod p, operand scanning with one reduction per
+   word of p_right. -1/p mod 2^64 is 1, so the multiple of p to add is the low word m itself, and
+   (t + m*p) / 2^64 = t / 2^64 + m*2^32 + m*(2^128 - 2^160 + 2^192) as p = 2^256 - 2^224 + 2^192 + 2^96 - 1. */
+static void vli_montMult_portable(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
+{
+    uint64_t t[NUM_ECC_DIGITS + 2] = {0};
+    uint64_t m;
+    uint128_t c;
+    uint i, j;
+
+    for(i = 0; i < NUM_ECC_DIGITS; ++i)
+    {
+        c = 0;
+        for(j = 0; j < NUM_ECC_DIGITS; ++j)
+        {
+            c += (uint128_t)p_left[j] * p_right[i] + t[j];
+            t[j] = (uint64_t)c;
+            c >>= 64;
+        }
+        c += t[4];
+        t[4] = (uint64_t)c;
+        t[5] = (uint64_t)(c >> 64);
+
+        m = t[0];
+        c = (uint128_t)t[1] + (m << 32);
+        t[0] = (uint64_t)c;
+        c = (c >> 64) + t[2] + (m >> 32);
+        t[1] = (uint64_t)c;
+        c = (c >> 64) + t[3] + (uint128_t)m * ECDSA_curve_p[3];
+        t[2] = (uint64_t)c;
+        c = (c >> 64) + t[4];
+        t[3] = (uint64_t)c;
+        t[4] = t[5] + (uint64_t)(c >> 64);
+    }
+
+    /* t < 2p, subtract p once if needed */
+    vli_montReduceOnce(p_result, t, ECDSA_curve_p);
+}
+
+/* One word of vli_montMult_mulx: (A0..A5) += a * b[i] with the CF (ADCX) and OF (ADOX) carry chains for the
+   low and high halves of the products, then the P-256 reduction of A0. The sum is left in A1..A5. */
+#define ECDSA_MULX_ROUND(bi, A0, A1, A2, A3, A4, A5) \
+    "movq " bi ", %%rdx\n\t" \
+    "xorl %%r14d, %%r14d\n\t" \
+    "movq $0, " A5 "\n\t" \
+    "mulxq 0(%[a]), %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A0 "\n\t" \
+    "adoxq %%rbx, " A1 "\n\t" \
+    "mulxq 8(%[a]), %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A1 "\n\t" \
+    "adoxq %%rbx, " A2 "\n\t" \
+    "mulxq 16(%[a]), %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A2 "\n\t" \
+    "adoxq %%rbx, " A3 "\n\t" \
+    "mulxq 24(%[a]), %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A3 "\n\t" \
+    "adoxq %%rbx, " A4 "\n\t" \
+    "adcxq %%r14, " A4 "\n\t" \
+    "adoxq %%r14, " A5 "\n\t" \
+    "adcxq %%r14, " A5 "\n\t" \
+    "movq " A0 ", %%rdx\n\t" \
+    "mulxq %[p3], %%rax, %%rbx\n\t" \
+    "movq " A0 ", %%rcx\n\t" \
+    "shlq $32, %%rcx\n\t" \
+    "shrq $32, " A0 "\n\t" \
+    "addq %%rcx, " A1 "\n\t" \
+    "adcq " A0 ", " A2 "\n\t" \
+    "adcq %%rax, " A3 "\n\t" \
+    "adcq %%rbx, " A4 "\n\t" \
+    "adcq $0, " A5 "\n\t"
+
+/* Same as vli_montMult_portable, fully unrolled with MULX/ADCX/ADOX. The accumulator registers rotate one
+   position per word instead of being shifted. */
+__attribute__((target("bmi2,adx")))
+static void vli_montMult_mulx(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
+{
+    __asm__ volatile(
+        "xorl %%r8d, %%r8d\n\t"
+        "xorl %%r9d, %%r9d\n\t"
+        "xorl %%r10d, %%r10d\n\t"
+        "xorl %%r11d, %%r11d\n\t"
+        "xorl %%r12d, %%r12d\n\t"
+        ECDSA_MULX_ROUND("0(%[b])", "%%r8", "%%r9", "%%r10", "%%r11", "%%r12", "%%r13")
+        ECDSA_MULX_ROUND("8(%[b])", "%%r9", "%%r10", "%%r11", "%%r12", "%%r13", "%%r8")
+        ECDSA_MULX_ROUND("16(%[b])", "%%r10", "%%r11", "%%r12", "%%r13", "%%r8", "%%r9")
+        ECDSA_MULX_ROUND("24(%[b])", "%%r11", "%%r12", "%%r13", "%%r8", "%%r9", "%%r10")
+        /* (r12, r13, r8, r9, r10) < 2p, subtract p and keep the difference if there is no borrow */
+        "movq %%r12, %%rax\n\t"
+        "movq %%r13, %%rbx\n\t"
+        "movq %%r8, %%rcx\n\t"
+        "movq %%r9, %%rdx\n\t"
+        "subq $-1, %%rax\n\t"
+        "sbbq %[p1], %%rbx\n\t"
+        "sbbq $0, %%rcx\n\t"
+        "sbbq %[p3], %%rdx\n\t"
+        "sbbq $0, %%r10\n\t"
+        "cmovcq %%r12, %%rax\n\t"
+        "cmovcq %%r13, %%rbx\n\t"
+        "cmovcq %%r8, %%rcx\n\t"
+        "cmovcq %%r9, %%rdx\n\t"
+        "movq %%rax, 0(%[r])\n\t"
+        "movq %%rbx, 8(%[r])\n\t"
+        "movq %%rcx, 16(%[r])\n\t"
+        "movq %%rdx, 24(%[r])\n\t"
+        :
+        : [r] "r" (p_result), [a] "r" (p_left), [b] "r" (p_right), [p1] "m" (ECDSA_curve_p[1]), [p3] "m" (ECDSA_curve_p[3])
+        : "rax", "rbx", "rcx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "cc", "memory");
+}
+
+/* Computes p_result = p_left * p_right / 2^256 % ECDSA_curve_p, the product of two field elements in Montgomery form. */
+static void vli_modMult_fast(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
+{
+    if(API_ECDSA_getImplementation() == ecdsa_p256_MULX_ADX)
+    {
+        vli_montMult_mulx(p_result, p_left, p_right);
+    }
+    else
+    {
+        vli_montMult_portable(p_result, p_left, p_right);
+    }
+}
+
+/* Computes p_result = p_left^2 / 2^256 % ECDSA_curve_p. */
+static void vli_modSquare_fast(uint64_t *p_result, uint64_t *p_left)
+{
+    vli_modMult_fast(p_result, p_left, p_left);
+}
+
+/* p_result = p_in in Montgomery form. */
+static void vli_toMont(uint64_t *p_result, uint64_t *p_in)
+{
+    vli_modMult_fast(p_result, p_in, ECDSA_mont_R2);
+}
+
+/* p_result = p_in back from Montgomery form. */
+static void vli_fromMont(uint64_t *p_result, uint64_t *p_in)
+{
+    uint64_t l_one[NUM_ECC_DIGITS] = {1};
+    vli_modMult_fast(p_result, p_in, l_one);
+}
+
+#else
+
+static uint64_t ECDSA_mont_one[NUM_ECC_DIGITS] = {1};
+
+ECDSA_implementation API_ECDSA_getImplementation()
+{
+    return ecdsa_generic;
+}
+
 /* Computes p_result = (p_left * p_right) % ECDSA_curve_p. */
 static void vli_modMult_fast(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
 {
@@ -665,6 +908,19 @@ static void vli_modSquare_fast(uint64_t *p_result, uint64_t *p_left)
     vli_mmod_fast(p_result, l_product);
 }
 
+/* Field elements are not converted without the Montgomery layer */
+static void vli_toMont(uint64_t *p_result, uint64_t *p_in)
+{
+    vli_set(p_result, p_in);
+}
+
+static void vli_fromMont(uint64_t *p_result, uint64_t *p_in)
+{
+    vli_set(p_result, p_in);
+}
+
+#endif /* ECDSA_P256_MONTGOMERY */
+
 #define EVEN(vli) (!(vli[0] & 1))
 /* Computes p_result = (1 / p_input) % p_mod. All VLIs are the same size.
    See "From Euclid's GCD to Montgomery Multiplication to the Great Divide"
@@ -758,6 +1014,300 @@ static void vli_modInv(uint64_t *p_result, uint64_t *p_input, uint64_t *p_mod)
     vli_set(p_result, u);
 }
 
+#if ECDSA_P256_MONTGOMERY
+
+/* p_result = p_in^(2^p_count) */
+static void vli_modSquare_n(uint64_t *p_result, uint64_t *p_in, uint p_count)
+{
+    uint i;
+    vli_set(p_result, p_in);
+    for(i = 0; i < p_count; ++i)
+    {
+        vli_modSquare_fast(p_result, p_result);
+    }
+}
+
+/* Start of the P-256 addition chains, x_k = p_input^(2^k - 1) for k = 2, 4, 8, 16, 32 (31 squares, 5 multiplications). */
+static void vli_modPow_ones(uint64_t *x2, uint64_t *x4, uint64_t *x8, uint64_t *x16, uint64_t *x32, uint64_t *p_input)
+{
+    vli_modSquare_fast(x2, p_input);
+    vli_modMult_fast(x2, x2, p_input);
+    vli_modSquare_n(x4, x2, 2);
+    vli_modMult_fast(x4, x4, x2);
+    vli_modSquare_n(x8, x4, 4);
+    vli_modMult_fast(x8, x8, x4);
+    vli_modSquare_n(x16, x8, 8);
+    vli_modMult_fast(x16, x16, x8);
+    vli_modSquare_n(x32, x16, 16);
+    vli_modMult_fast(x32, x32, x16);
+}
+
+/* Computes p_result = 1 / p_input in the field (0 for 0), Montgomery form in and out. Fermat's little theorem,
+   p_input^(p-2) with a fixed addition chain: 255 squares and 12 multiplications for every input.
+   p - 2 = 1^32 0^31 1 0^96 1^94 0 1 (bits from the top). */
+static void vli_modInv_fast(uint64_t *p_result, uint64_t *p_input)
+{
+    uint64_t x2[NUM_ECC_DIGITS], x4[NUM_ECC_DIGITS], x8[NUM_ECC_DIGITS], x16[NUM_ECC_DIGITS], x32[NUM_ECC_DIGITS];
+    uint64_t t[NUM_ECC_DIGITS];
+
+    vli_modPow_ones(x2, x4, x8, x16, x32, p_input);
+    vli_modSquare_n(t, x32, 32);
+    vli_modMult_fast(t, t, p_input);  /* 1^32 0^31 1 */
+    vli_modSquare_n(t, t, 96);        /* 0^96 */
+    vli_modSquare_n(t, t, 32);
+    vli_modMult_fast(t, t, x32);
+    vli_modSquare_n(t, t, 32);
+    vli_modMult_fast(t, t, x32);
+    vli_modSquare_n(t, t, 16);
+    vli_modMult_fast(t, t, x16);
+    vli_modSquare_n(t, t, 8);
+    vli_modMult_fast(t, t, x8);
+    vli_modSquare_n(t, t, 4);
+    vli_modMult_fast(t, t, x4);
+    vli_modSquare_n(t, t, 2);
+    vli_modMult_fast(t, t, x2);       /* 1^94 */
+    vli_modSquare_n(t, t, 2);
+    vli_modMult_fast(p_result, t, p_input); /* 0 1 */
+
+    memset(x2, 0, sizeof(x2));
+    memset(x4, 0, sizeof(x4));
+    memset(x8, 0, sizeof(x8));
+    memset(x16, 0, sizeof(x16));
+    memset(x32, 0, sizeof(x32));
+    memset(t, 0, sizeof(t));
+}
+
+/* Montgomery constants of the group order, R^2 mod n and -1/n mod 2^64 */
+static uint64_t ECDSA_n_R2[NUM_ECC_DIGITS] = {0x83244C95BE79EEA2ull, 0x4699799C49BD6FA6ull, 0x2845B2392B6BEC59ull, 0x66E12D94F3D95620ull};
+static uint64_t ECDSA_n_n0 = 0xCCD1C8AAEE00BC4Full;
+
+/* Montgomery multiplication modulo the group order p_result = p_left * p_right / 2^256 mod n, the multiple of n
+   to add for each word of p_right is m = t0 * (-1/n) mod 2^64. */
+static void vli_montMultN_portable(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
+{
+    uint64_t t[NUM_ECC_DIGITS + 2] = {0};
+    uint64_t m;
+    uint128_t c;
+    uint i, j;
+
+    for(i = 0; i < NUM_ECC_DIGITS; ++i)
+    {
+        c = 0;
+        for(j = 0; j < NUM_ECC_DIGITS; ++j)
+        {
+            c += (uint128_t)p_left[j] * p_right[i] + t[j];
+            t[j] = (uint64_t)c;
+            c >>= 64;
+        }
+        c += t[4];
+        t[4] = (uint64_t)c;
+        t[5] = (uint64_t)(c >> 64);
+
+        m = t[0] * ECDSA_n_n0;
+        c = (uint128_t)m * ECDSA_curve_n[0] + t[0];
+        for(j = 1; j < NUM_ECC_DIGITS; ++j)
+        {
+            c = (c >> 64) + (uint128_t)m * ECDSA_curve_n[j] + t[j];
+            t[j-1] = (uint64_t)c;
+        }
+        c = (c >> 64) + t[4];
+        t[3] = (uint64_t)c;
+        t[4] = t[5] + (uint64_t)(c >> 64);
+    }
+
+    /* t < 2n, subtract n once if needed */
+    vli_montReduceOnce(p_result, t, ECDSA_curve_n);
+}
+
+/* One word of vli_montMultN_mulx: (A0..A5) += a * b[i], then (A0..A5) += m * n with m = A0 * (-1/n), A0 is 0
+   afterwards and the sum is left in A1..A5. */
+#define ECDSA_MULX_ROUND_N(bi, A0, A1, A2, A3, A4, A5) \
+    "movq " bi ", %%rdx\n\t" \
+    "xorl %%r14d, %%r14d\n\t" \
+    "movq $0, " A5 "\n\t" \
+    "mulxq 0(%[a]), %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A0 "\n\t" \
+    "adoxq %%rbx, " A1 "\n\t" \
+    "mulxq 8(%[a]), %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A1 "\n\t" \
+    "adoxq %%rbx, " A2 "\n\t" \
+    "mulxq 16(%[a]), %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A2 "\n\t" \
+    "adoxq %%rbx, " A3 "\n\t" \
+    "mulxq 24(%[a]), %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A3 "\n\t" \
+    "adoxq %%rbx, " A4 "\n\t" \
+    "adcxq %%r14, " A4 "\n\t" \
+    "adoxq %%r14, " A5 "\n\t" \
+    "adcxq %%r14, " A5 "\n\t" \
+    "movq " A0 ", %%rdx\n\t" \
+    "imulq %[n0], %%rdx\n\t" \
+    "xorl %%r14d, %%r14d\n\t" \
+    "mulxq %[n_0], %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A0 "\n\t" \
+    "adoxq %%rbx, " A1 "\n\t" \
+    "mulxq %[n_1], %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A1 "\n\t" \
+    "adoxq %%rbx, " A2 "\n\t" \
+    "mulxq %[n_2], %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A2 "\n\t" \
+    "adoxq %%rbx, " A3 "\n\t" \
+    "mulxq %[n_3], %%rax, %%rbx\n\t" \
+    "adcxq %%rax, " A3 "\n\t" \
+    "adoxq %%rbx, " A4 "\n\t" \
+    "adcxq %%r14, " A4 "\n\t" \
+    "adoxq %%r14, " A5 "\n\t" \
+    "adcxq %%r14, " A5 "\n\t"
+
+/* Same as vli_montMultN_portable, fully unrolled with MULX/ADCX/ADOX like vli_montMult_mulx. */
+__attribute__((target("bmi2,adx")))
+static void vli_montMultN_mulx(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
+{
+    __asm__ volatile(
+        "xorl %%r8d, %%r8d\n\t"
+        "xorl %%r9d, %%r9d\n\t"
+        "xorl %%r10d, %%r10d\n\t"
+        "xorl %%r11d, %%r11d\n\t"
+        "xorl %%r12d, %%r12d\n\t"
+        ECDSA_MULX_ROUND_N("0(%[b])", "%%r8", "%%r9", "%%r10", "%%r11", "%%r12", "%%r13")
+        ECDSA_MULX_ROUND_N("8(%[b])", "%%r9", "%%r10", "%%r11", "%%r12", "%%r13", "%%r8")
+        ECDSA_MULX_ROUND_N("16(%[b])", "%%r10", "%%r11", "%%r12", "%%r13", "%%r8", "%%r9")
+        ECDSA_MULX_ROUND_N("24(%[b])", "%%r11", "%%r12", "%%r13", "%%r8", "%%r9", "%%r10")
+        /* (r12, r13, r8, r9, r10) < 2n, subtract n and keep the difference if there is no borrow */
+        "movq %%r12, %%rax\n\t"
+        "movq %%r13, %%rbx\n\t"
+        "movq %%r8, %%r14\n\t"
+        "movq %%r9, %%rdx\n\t"
+        "subq %[n_0], %%rax\n\t"
+        "sbbq %[n_1], %%rbx\n\t"
+        "sbbq %[n_2], %%r14\n\t"
+        "sbbq %[n_3], %%rdx\n\t"
+        "sbbq $0, %%r10\n\t"
+        "cmovcq %%r12, %%rax\n\t"
+        "cmovcq %%r13, %%rbx\n\t"
+        "cmovcq %%r8, %%r14\n\t"
+        "cmovcq %%r9, %%rdx\n\t"
+        "movq %%rax, 0(%[r])\n\t"
+        "movq %%rbx, 8(%[r])\n\t"
+        "movq %%r14, 16(%[r])\n\t"
+        "movq %%rdx, 24(%[r])\n\t"
+        :
+        : [r] "r" (p_result), [a] "r" (p_left), [b] "r" (p_right), [n0] "m" (ECDSA_n_n0),
+          [n_0] "m" (ECDSA_curve_n[0]), [n_1] "m" (ECDSA_curve_n[1]), [n_2] "m" (ECDSA_curve_n[2]), [n_3] "m" (ECDSA_curve_n[3])
+        : "rax", "rbx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "cc", "memory");
+}
+
+static void vli_montMultN(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
+{
+    if(API_ECDSA_getImplementation() == ecdsa_p256_MULX_ADX)
+    {
+        vli_montMultN_mulx(p_result, p_left, p_right);
+    }
+    else
+    {
+        vli_montMultN_portable(p_result, p_left, p_right);
+    }
+}
+
+/* Computes p_result = 1 / p_input mod n (0 for 0), p_input < n. Fermat's little theorem, p_input^(n-2) in
+   Montgomery form with 4-bit fixed windows: the sequence of operations only depends on n, not on p_input. */
+static void vli_modInv_n(uint64_t *p_result, uint64_t *p_input)
+{
+    uint64_t l_pow[16][NUM_ECC_DIGITS]; /* p_input^i in Montgomery form */
+    uint64_t l_exp[NUM_ECC_DIGITS] = {2};
+    uint64_t l_one[NUM_ECC_DIGITS] = {1};
+    uint64_t t[NUM_ECC_DIGITS];
+    int i, j;
+
+    vli_sub(l_exp, ECDSA_curve_n, l_exp); /* n - 2 */
+    vli_montMultN(l_pow[1], p_input, ECDSA_n_R2);
+    vli_montMultN(l_pow[0], l_one, ECDSA_n_R2);
+    for(i = 2; i < 16; ++i)
+    {
+        vli_montMultN(l_pow[i], l_pow[i-1], l_pow[1]);
+    }
+
+    vli_set(t, l_pow[0]);
+    for(i = ECC_BYTES * 2 - 1; i >= 0; --i)
+    {
+        for(j = 0; j < 4; ++j)
+        {
+            vli_montMultN(t, t, t);
+        }
+        vli_montMultN(t, t, l_pow[(l_exp[i / 16] >> (4 * (i % 16))) & 0xF]);
+    }
+    vli_montMultN(p_result, t, l_one); /* out of the Montgomery form */
+
+    memset(l_pow, 0, sizeof(l_pow));
+    memset(t, 0, sizeof(t));
+}
+
+#else
+
+/* Computes p_result = 1 / p_input in the field. */
+static void vli_modInv_fast(uint64_t *p_result, uint64_t *p_input)
+{
+    vli_modInv(p_result, p_input, ECDSA_curve_p);
+}
+
+/* Computes p_result = 1 / p_input mod n. */
+static void vli_modInv_n(uint64_t *p_result, uint64_t *p_input)
+{
+    vli_modInv(p_result, p_input, ECDSA_curve_n);
+}
+
+#endif /* ECDSA_P256_MONTGOMERY */
+
+int API_ECDSA_inverse_selftest()
+{
+    uint64_t l_inputs[12][NUM_ECC_DIGITS] = {{0}, {1}, {2}, {3}};
+    uint64_t *l_mods[2] = {ECDSA_curve_p, ECDSA_curve_n};
+    uint64_t l_ref[NUM_ECC_DIGITS], l_inv[NUM_ECC_DIGITS], l_tmp[NUM_ECC_DIGITS];
+    uint i, j, m;
+
+    /* Edge inputs: 0 to 3, mod - 1 and mod - 2 of both moduli, 2^(bits-1), one bit per limb and alternating bits */
+    for(m = 0; m < 2; ++m)
+    {
+        vli_sub(l_inputs[4 + 2*m], l_mods[m], l_inputs[1]);
+        vli_sub(l_inputs[5 + 2*m], l_mods[m], l_inputs[2]);
+    }
+    for(j = 0; j < NUM_ECC_DIGITS; ++j)
+    {
+        l_inputs[8][j] = 0;
+        l_inputs[9][j] = 1;
+        l_inputs[10][j] = 0x5555555555555555ull;
+        l_inputs[11][j] = 0xAAAAAAAAAAAAAAAAull >> 1;
+    }
+    l_inputs[8][NUM_ECC_DIGITS - 1] = 0x8000000000000000ull;
+
+    for(i = 0; i < sizeof(l_inputs) / sizeof(l_inputs[0]); ++i)
+    {
+        for(m = 0; m < 2; ++m)
+        {
+            if(vli_cmp(l_mods[m], l_inputs[i]) != 1)
+            {
+                continue; /* not reduced */
+            }
+            vli_modInv(l_ref, l_inputs[i], l_mods[m]);
+            if(m == 0)
+            {
+                vli_toMont(l_tmp, l_inputs[i]);
+                vli_modInv_fast(l_inv, l_tmp);
+                vli_fromMont(l_inv, l_inv);
+            }
+            else
+            {
+                vli_modInv_n(l_inv, l_inputs[i]);
+            }
+            if(vli_cmp(l_ref, l_inv) != 0)
+            {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
 /* ------ Point operations ------ */
 
 /* Returns 1 if p_point is the point at infinity, 0 otherwise. */
@@ -838,8 +1388,7 @@ static void XYcZ_initial_double(uint64_t *X1, uint64_t *Y1, uint64_t *X2, uint64
     vli_set(X2, X1);
     vli_set(Y2, Y1);
     
-    vli_clear(z);
-    z[0] = 1;
+    vli_set(z, ECDSA_mont_one);
     if(p_initialZ)
     {
         vli_set(z, p_initialZ);
@@ -944,7 +1493,7 @@ static void EccPoint_mult(EccPoint *p_result, EccPoint *p_point, uint64_t *p_sca
     vli_modSub(z, Rx[1], Rx[0], ECDSA_curve_p); /* X1 - X0 */
     vli_modMult_fast(z, z, Ry[1-nb]);     /* Yb * (X1 - X0) */
     vli_modMult_fast(z, z, p_point->x);   /* xP * Yb * (X1 - X0) */
-    vli_modInv(z, z, ECDSA_curve_p);            /* 1 / (xP * Yb * (X1 - X0)) */
+    vli_modInv_fast(z, z);                /* 1 / (xP * Yb * (X1 - X0)) */
     vli_modMult_fast(z, z, p_point->y);   /* yP / (xP * Yb * (X1 - X0)) */
     vli_modMult_fast(z, z, Rx[1-nb]);     /* Xb * yP / (xP * Yb * (X1 - X0)) */
     /* End 1/Z calculation */
@@ -957,6 +1506,236 @@ static void EccPoint_mult(EccPoint *p_result, EccPoint *p_point, uint64_t *p_sca
     vli_set(p_result->y, Ry[0]);
 }
 
+/* ------ Fixed-base multiplication of the generator ------ */
+
+/* Affine P3 = P1 + P2, with x1 != x2. p_result may be p_left. */
+static void EccPoint_add_affine(EccPoint *p_result, EccPoint *p_left, EccPoint *p_right)
+{
+    uint64_t l_lambda[NUM_ECC_DIGITS];
+    uint64_t t[NUM_ECC_DIGITS];
+    uint64_t x3[NUM_ECC_DIGITS];
+
+    vli_modSub(t, p_right->x, p_left->x, ECDSA_curve_p);
+    vli_modInv_fast(t, t);
+    vli_modSub(l_lambda, p_right->y, p_left->y, ECDSA_curve_p);
+    vli_modMult_fast(l_lambda, l_lambda, t); /* lambda = (y2 - y1) / (x2 - x1) */
+
+    vli_modSquare_fast(x3, l_lambda);
+    vli_modSub(x3, x3, p_left->x, ECDSA_curve_p);
+    vli_modSub(x3, x3, p_right->x, ECDSA_curve_p); /* x3 = lambda^2 - x1 - x2 */
+
+    vli_modSub(t, p_left->x, x3, ECDSA_curve_p);
+    vli_modMult_fast(t, t, l_lambda);
+    vli_modSub(p_result->y, t, p_left->y, ECDSA_curve_p); /* y3 = lambda * (x1 - x3) - y1 */
+    vli_set(p_result->x, x3);
+}
+
+/* Affine P3 = 2 * P1. p_result may be p_point. */
+static void EccPoint_double_affine(EccPoint *p_result, EccPoint *p_point)
+{
+    uint64_t *_1 = ECDSA_mont_one;
+    uint64_t l_lambda[NUM_ECC_DIGITS];
+    uint64_t t[NUM_ECC_DIGITS];
+    uint64_t x3[NUM_ECC_DIGITS];
+
+    vli_modSub(l_lambda, p_point->x, _1, ECDSA_curve_p);
+    vli_modAdd(t, p_point->x, _1, ECDSA_curve_p);
+    vli_modMult_fast(l_lambda, l_lambda, t); /* x^2 - 1 */
+    vli_modAdd(t, l_lambda, l_lambda, ECDSA_curve_p);
+    vli_modAdd(l_lambda, t, l_lambda, ECDSA_curve_p); /* 3x^2 - 3 (a = -3) */
+    vli_modAdd(t, p_point->y, p_point->y, ECDSA_curve_p);
+    vli_modInv_fast(t, t);
+    vli_modMult_fast(l_lambda, l_lambda, t); /* lambda = (3x^2 - 3) / 2y */
+
+    vli_modSquare_fast(x3, l_lambda);
+    vli_modSub(x3, x3, p_point->x, ECDSA_curve_p);
+    vli_modSub(x3, x3, p_point->x, ECDSA_curve_p); /* x3 = lambda^2 - 2x */
+
+    vli_modSub(t, p_point->x, x3, ECDSA_curve_p);
+    vli_modMult_fast(t, t, l_lambda);
+    vli_modSub(p_result->y, t, p_point->y, ECDSA_curve_p); /* y3 = lambda * (x - x3) - y */
+    vli_set(p_result->x, x3);
+}
+
+static void ECDSA_build_G_table()
+{
+    EccPoint l_base; /* 16^i * G */
+    uint i, j;
+
+    vli_toMont(l_base.x, ECDSA_curve_G.x);
+    vli_toMont(l_base.y, ECDSA_curve_G.y);
+
+    for(i = 0; i < ECDSA_G_TABLE_WINDOWS; ++i)
+    {
+        ECDSA_G_table[i][0] = l_base;
+        EccPoint_double_affine(&ECDSA_G_table[i][1], &l_base);
+        for(j = 2; j < ECDSA_G_TABLE_POINTS; ++j)
+        {
+            EccPoint_add_affine(&ECDSA_G_table[i][j], &ECDSA_G_table[i][j-1], &l_base);
+        }
+        EccPoint_double_affine(&l_base, &ECDSA_G_table[i][7]); /* 16 * base = 2 * (8 * base) */
+    }
+}
+
+void API_ECDSA_precompute_G_table()
+{
+    pthread_once(&ECDSA_G_table_once, ECDSA_build_G_table);
+}
+
+/* (U2, S2) = (x2*z1^2, y2*z1^3), the affine point (x2, y2) with the Z of the Jacobian one. */
+static void EccPoint_mixed_prepare(uint64_t *U2, uint64_t *S2, uint64_t *Z1, uint64_t *x2, uint64_t *y2)
+{
+    vli_modSquare_fast(U2, Z1);           /* z1^2 */
+    vli_modMult_fast(S2, U2, Z1);         /* z1^3 */
+    vli_modMult_fast(U2, U2, x2);         /* x2*z1^2 */
+    vli_modMult_fast(S2, S2, y2);         /* y2*z1^3 */
+}
+
+/* Jacobian (X1, Y1, Z1) += affine (x2, y2), given (t1, t2) = (U2, S2) from EccPoint_mixed_prepare.
+   The points must be different and not opposite. t1 and t2 are overwritten. */
+static void EccPoint_add_mixed_prepared(uint64_t *X1, uint64_t *Y1, uint64_t *Z1, uint64_t *t1, uint64_t *t2)
+{
+    uint64_t h[NUM_ECC_DIGITS];
+    uint64_t r[NUM_ECC_DIGITS];
+
+    vli_modSub(h, t1, X1, ECDSA_curve_p); /* h = U2 - x1 */
+    vli_modSub(r, t2, Y1, ECDSA_curve_p); /* r = S2 - y1 */
+
+    vli_modMult_fast(Z1, Z1, h);          /* z3 = z1*h */
+    vli_modSquare_fast(t1, h);            /* t1 = h^2 */
+    vli_modMult_fast(t2, t1, h);          /* t2 = h^3 */
+    vli_modMult_fast(t1, t1, X1);         /* t1 = x1*h^2 = V */
+
+    vli_modSquare_fast(X1, r);
+    vli_modSub(X1, X1, t2, ECDSA_curve_p);
+    vli_modSub(X1, X1, t1, ECDSA_curve_p);
+    vli_modSub(X1, X1, t1, ECDSA_curve_p); /* x3 = r^2 - h^3 - 2V */
+
+    vli_modMult_fast(t2, t2, Y1);          /* t2 = y1*h^3 */
+    vli_modSub(t1, t1, X1, ECDSA_curve_p);
+    vli_modMult_fast(t1, t1, r);
+    vli_modSub(Y1, t1, t2, ECDSA_curve_p); /* y3 = r*(V - x3) - y1*h^3 */
+}
+
+/* Jacobian (X1, Y1, Z1) += affine (x2, y2), the points must be different and not opposite. */
+static void EccPoint_add_mixed(uint64_t *X1, uint64_t *Y1, uint64_t *Z1, uint64_t *x2, uint64_t *y2)
+{
+    uint64_t t1[NUM_ECC_DIGITS];
+    uint64_t t2[NUM_ECC_DIGITS];
+
+    EccPoint_mixed_prepare(t1, t2, Z1, x2, y2);
+    EccPoint_add_mixed_prepared(X1, Y1, Z1, t1, t2);
+}
+
+/* Same as EccPoint_add_mixed for public data only, any two points: the point at infinity (z1 = 0),
+   equal or opposite points are handled with branches. */
+static void EccPoint_add_mixed_vartime(uint64_t *X1, uint64_t *Y1, uint64_t *Z1, uint64_t *x2, uint64_t *y2)
+{
+    uint64_t t1[NUM_ECC_DIGITS];
+    uint64_t t2[NUM_ECC_DIGITS];
+
+    if(vli_isZero(Z1))
+    {
+        vli_set(X1, x2);
+        vli_set(Y1, y2);
+        vli_set(Z1, ECDSA_mont_one);
+        return;
+    }
+    EccPoint_mixed_prepare(t1, t2, Z1, x2, y2);
+    if(vli_cmp(t1, X1) == 0)
+    {
+        if(vli_cmp(t2, Y1) == 0)
+        { /* same point */
+            EccPoint_double_jacobian(X1, Y1, Z1);
+        }
+        else
+        { /* opposite points, the sum is the point at infinity */
+            vli_clear(Z1);
+        }
+        return;
+    }
+    EccPoint_add_mixed_prepared(X1, Y1, Z1, t1, t2);
+}
+
+/* Returns an all ones mask if a == b, 0 otherwise, without branches. */
+static uint64_t ct_eq_mask(uint64_t a, uint64_t b)
+{
+    uint64_t l_diff = a ^ b;
+    return ((l_diff | (0 - l_diff)) >> 63) - 1;
+}
+
+/* p_point = ECDSA_G_table[p_window][p_digit - 1], or (0, 0) if p_digit is 0. Every entry of the row is read. */
+static void ECDSA_G_table_lookup(EccPoint *p_point, uint p_window, uint64_t p_digit)
+{
+    uint j;
+    vli_clear(p_point->x);
+    vli_clear(p_point->y);
+    for(j = 0; j < ECDSA_G_TABLE_POINTS; ++j)
+    {
+        uint64_t l_mask = ct_eq_mask(p_digit, j + 1);
+        vli_select(p_point->x, ECDSA_G_table[p_window][j].x, l_mask);
+        vli_select(p_point->y, ECDSA_G_table[p_window][j].y, l_mask);
+    }
+}
+
+/* p_result = p_scalar * G with the fixed-base table, p_scalar in [1, n-1].
+   Every partial sum is a multiple of G smaller than p_scalar, so the mixed addition never meets the doubling
+   or the opposite point cases. The same operations are done for every scalar. */
+static void EccPoint_mult_G(EccPoint *p_result, uint64_t *p_scalar)
+{
+    uint64_t X[NUM_ECC_DIGITS], Y[NUM_ECC_DIGITS], Z[NUM_ECC_DIGITS];
+    uint64_t sX[NUM_ECC_DIGITS], sY[NUM_ECC_DIGITS], sZ[NUM_ECC_DIGITS];
+    uint64_t l_isInfinity = (uint64_t)-1; /* all ones while the accumulator is the point at infinity */
+    EccPoint l_point;
+    uint i;
+
+    API_ECDSA_precompute_G_table();
+
+    vli_clear(X);
+    vli_clear(Y);
+    vli_clear(Z);
+    for(i = 0; i < ECDSA_G_TABLE_WINDOWS; ++i)
+    {
+        uint64_t l_digit = (p_scalar[i / 16] >> (4 * (i % 16))) & 0xF;
+        uint64_t l_isZeroDigit = ct_eq_mask(l_digit, 0);
+
+        ECDSA_G_table_lookup(&l_point, i, l_digit);
+
+        vli_set(sX, X);
+        vli_set(sY, Y);
+        vli_set(sZ, Z);
+        EccPoint_add_mixed(sX, sY, sZ, l_point.x, l_point.y);
+
+        /* accumulator at infinity: the sum is the table point */
+        vli_select(sX, l_point.x, l_isInfinity);
+        vli_select(sY, l_point.y, l_isInfinity);
+        vli_select(sZ, ECDSA_mont_one, l_isInfinity);
+
+        /* digit 0: the accumulator does not change */
+        vli_select(X, sX, ~l_isZeroDigit);
+        vli_select(Y, sY, ~l_isZeroDigit);
+        vli_select(Z, sZ, ~l_isZeroDigit);
+        l_isInfinity &= l_isZeroDigit;
+    }
+
+    /* Back to affine coordinates, out of the Montgomery form */
+    vli_modInv_fast(Z, Z);             /* 1/z */
+    vli_modSquare_fast(sZ, Z);         /* 1/z^2 */
+    vli_modMult_fast(p_result->x, X, sZ);
+    vli_modMult_fast(sZ, sZ, Z);       /* 1/z^3 */
+    vli_modMult_fast(p_result->y, Y, sZ);
+    vli_fromMont(p_result->x, p_result->x);
+    vli_fromMont(p_result->y, p_result->y);
+
+    memset(X, 0, sizeof(X));
+    memset(Y, 0, sizeof(Y));
+    memset(Z, 0, sizeof(Z));
+    memset(sX, 0, sizeof(sX));
+    memset(sY, 0, sizeof(sY));
+    memset(sZ, 0, sizeof(sZ));
+    memset(&l_point, 0, sizeof(l_point));
+}
+
 static void ecc_bytes2native(uint64_t p_native[NUM_ECC_DIGITS], const uint8_t p_bytes[ECC_BYTES])
 {
     unsigned i;
@@ -985,12 +1764,32 @@ static void ecc_native2bytes(uint8_t p_bytes[ECC_BYTES], const uint64_t p_native
     }
 }
 
+#if ECDSA_P256_MONTGOMERY
+
+/* Compute a = sqrt(a) (mod ECDSA_curve_p), a^((p + 1) / 4) with a fixed addition chain (253 squares and
+   7 multiplications). (p + 1) / 4 = 1^32 0^31 1 0^95 1 0^94 (bits from the top). */
+static void mod_sqrt(uint64_t a[NUM_ECC_DIGITS])
+{
+    uint64_t x2[NUM_ECC_DIGITS], x4[NUM_ECC_DIGITS], x8[NUM_ECC_DIGITS], x16[NUM_ECC_DIGITS], x32[NUM_ECC_DIGITS];
+
+    vli_modPow_ones(x2, x4, x8, x16, x32, a);
+    vli_modSquare_n(x32, x32, 32);
+    vli_modMult_fast(x32, x32, a);  /* 1^32 0^31 1 */
+    vli_modSquare_n(x32, x32, 96);
+    vli_modMult_fast(x32, x32, a);  /* 0^95 1 */
+    vli_modSquare_n(a, x32, 94);    /* 0^94 */
+}
+
+#else
+
 /* Compute a = sqrt(a) (mod ECDSA_curve_p). */
 static void mod_sqrt(uint64_t a[NUM_ECC_DIGITS])
 {
     unsigned i;
     uint64_t p1[NUM_ECC_DIGITS] = {1};
-    uint64_t l_result[NUM_ECC_DIGITS] = {1};
+    uint64_t l_result[NUM_ECC_DIGITS];
+
+    vli_set(l_result, ECDSA_mont_one);
     
     /* Since ECDSA_curve_p == 3 (mod 4) for all supported curves, we can
        compute sqrt(a) = a^((ECDSA_curve_p + 1) / 4) (mod ECDSA_curve_p). */
@@ -1006,24 +1805,62 @@ static void mod_sqrt(uint64_t a[NUM_ECC_DIGITS])
     vli_set(a, l_result);
 }
 
-static void ecc_point_decompress(EccPoint *p_point, const uint8_t p_compressed[ECC_BYTES+1])
+#endif /* ECDSA_P256_MONTGOMERY */
+
+/* The point is returned in Montgomery form */
+static void ecc_point_decompress_compute(EccPoint *p_point, const uint8_t p_compressed[ECC_BYTES+1])
 {
     uint64_t _3[NUM_ECC_DIGITS] = {3}; /* -a = 3 */
+    uint64_t l_b[NUM_ECC_DIGITS];
+    uint64_t l_y[NUM_ECC_DIGITS];
     ecc_bytes2native(p_point->x, p_compressed+1);
+    vli_toMont(p_point->x, p_point->x);
+    vli_toMont(_3, _3);
+    vli_toMont(l_b, ECDSA_curve_b);
     
     vli_modSquare_fast(p_point->y, p_point->x); /* y = x^2 */
     vli_modSub(p_point->y, p_point->y, _3, ECDSA_curve_p); /* y = x^2 - 3 */
     vli_modMult_fast(p_point->y, p_point->y, p_point->x); /* y = x^3 - 3x */
-    vli_modAdd(p_point->y, p_point->y, ECDSA_curve_b, ECDSA_curve_p); /* y = x^3 - 3x + b */
+    vli_modAdd(p_point->y, p_point->y, l_b, ECDSA_curve_p); /* y = x^3 - 3x + b */
     
     mod_sqrt(p_point->y);
     
-    if((p_point->y[0] & 0x01) != (p_compressed[0] & 0x01))
+    vli_fromMont(l_y, p_point->y); /* the parity is the one of the plain value */
+    if((l_y[0] & 0x01) != (p_compressed[0] & 0x01))
     {
         vli_sub(p_point->y, ECDSA_curve_p, p_point->y);
     }
 }
 
+/* Same as ecc_point_decompress_compute, the last ECDSA_DECOMPRESS_CACHE_SIZE keys are kept (round robin)
+   so a key seen again is only copied. */
+static void ecc_point_decompress(EccPoint *p_point, const uint8_t p_compressed[ECC_BYTES+1])
+{
+    uint i;
+
+    pthread_mutex_lock(&ECDSA_decompress_lock);
+    for(i = 0; i < ECDSA_DECOMPRESS_CACHE_SIZE; ++i)
+    {
+        if(ECDSA_decompress_cache[i].valid && memcmp(ECDSA_decompress_cache[i].compressed, p_compressed, ECC_BYTES+1) == 0)
+        {
+            *p_point = ECDSA_decompress_cache[i].point;
+            pthread_mutex_unlock(&ECDSA_decompress_lock);
+            return;
+        }
+    }
+    pthread_mutex_unlock(&ECDSA_decompress_lock);
+
+    ecc_point_decompress_compute(p_point, p_compressed);
+
+    pthread_mutex_lock(&ECDSA_decompress_lock);
+    i = ECDSA_decompress_next;
+    ECDSA_decompress_next = (i + 1) % ECDSA_DECOMPRESS_CACHE_SIZE;
+    memcpy(ECDSA_decompress_cache[i].compressed, p_compressed, ECC_BYTES+1);
+    ECDSA_decompress_cache[i].point = *p_point;
+    ECDSA_decompress_cache[i].valid = 1;
+    pthread_mutex_unlock(&ECDSA_decompress_lock);
+}
+
 int ecc_make_key(uint8_t p_publicKey[ECC_BYTES+1], uint8_t p_privateKey[ECC_BYTES])
 {
     uint64_t l_private[NUM_ECC_DIGITS];
@@ -1048,7 +1885,7 @@ int ecc_make_key(uint8_t p_publicKey[ECC_BYTES+1], uint8_t p_privateKey[ECC_BYTE
             vli_sub(l_private, l_private, ECDSA_curve_n);
         }
 
-        EccPoint_mult(&l_public, &ECDSA_curve_G, l_private, NULL);
+        EccPoint_mult_G(&l_public, l_private);
     } while(EccPoint_isZero(&l_public));
     
     ecc_native2bytes(p_privateKey, l_private);
@@ -1074,6 +1911,7 @@ int ecdh_shared_secret(const uint8_t p_publicKey[ECC_BYTES+1], const uint8_t p_p
     EccPoint l_product;
     EccPoint_mult(&l_product, &l_public, l_private, l_random);
     
+    vli_fromMont(l_product.x, l_product.x);
     ecc_native2bytes(p_secret, l_product.x);
     
     return !EccPoint_isZero(&l_product);
@@ -1146,34 +1984,45 @@ static void vli_modMult(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right,
     vli_set(p_result, l_product);
 }
 
-static uint umax(uint a, uint b)
+/* Computes p_result = (p_left * p_right) % n, one of the factors < n. Two Montgomery multiplications with the
+   P-256 layer, the generic reduction otherwise. */
+static void vli_modMult_n(uint64_t *p_result, uint64_t *p_left, uint64_t *p_right)
 {
-    return (a > b ? a : b);
+#if ECDSA_P256_MONTGOMERY
+    vli_montMultN(p_result, p_left, p_right);
+    vli_montMultN(p_result, p_result, ECDSA_n_R2);
+#else
+    vli_modMult(p_result, p_left, p_right, ECDSA_curve_n);
+#endif
 }
 
-int ecdsa_sign(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2])
+/* Draws a nonce k and computes r = x(k*G) mod n and 1/k mod n, the part of a signature that does not depend on
+   the message, into p_ctx->nonce. k is kept in p_ctx->k and zeroized, it runs in the nonce pool thread too. */
+static int ecdsa_make_nonce(ECDSA_CTX *p_ctx)
 {
+    uint64_t *l_k = p_ctx->k;
     EccPoint p;
     unsigned l_tries = 0;
     
     do
     {
-        if(!getRandomNumber(ECDSA_k) || (l_tries++ >= MAX_TRIES))
+        if(!getRandomNumber(l_k) || (l_tries++ >= MAX_TRIES))
         {
+            memset(p_ctx->k, 0, sizeof(p_ctx->k));
             return 0;
         }
-        if(vli_isZero(ECDSA_k))
+        if(vli_isZero(l_k))
         {
             continue;
         }
     
-        if(vli_cmp(ECDSA_curve_n, ECDSA_k) != 1)
+        if(vli_cmp(ECDSA_curve_n, l_k) != 1)
         {
-            vli_sub(ECDSA_k, ECDSA_k, ECDSA_curve_n);
+            vli_sub(l_k, l_k, ECDSA_curve_n);
         }
     
-        /* tmp = ECDSA_k * G */
-        EccPoint_mult(&p, &ECDSA_curve_G, ECDSA_k, NULL);
+        /* tmp = k * G */
+        EccPoint_mult_G(&p, l_k);
     
         /* r = x1 (mod n) */
         if(vli_cmp(ECDSA_curve_n, p.x) != 1)
@@ -1182,32 +2031,311 @@ int ecdsa_sign(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_B
         }
     } while(vli_isZero(p.x));
 
-    ecc_native2bytes(p_signature, p.x);
-    
-    ecc_bytes2native(ECDSA_l_tmp, p_privateKey);
-    vli_modMult(ECDSA_l_s, p.x, ECDSA_l_tmp, ECDSA_curve_n); /* s = r*d */
-    ecc_bytes2native(ECDSA_l_tmp, p_hash);
-    vli_modAdd(ECDSA_l_s, ECDSA_l_tmp, ECDSA_l_s, ECDSA_curve_n); /* s = e + r*d */
-    vli_modInv(ECDSA_k, ECDSA_k, ECDSA_curve_n); /* ECDSA_k = 1 / ECDSA_k */
-    vli_modMult(ECDSA_l_s, ECDSA_l_s, ECDSA_k, ECDSA_curve_n); /* s = (e + r*d) / ECDSA_k */
-    ecc_native2bytes(p_signature + ECC_BYTES, ECDSA_l_s);
+    vli_set(p_ctx->nonce.r, p.x);
+    vli_modInv_n(p_ctx->nonce.k_inv, l_k); /* 1 / k */
+
+    memset(p_ctx->k, 0, sizeof(p_ctx->k));
+    memset(&p, 0, sizeof(p));
+    return 1;
+}
+
+/* ------ Nonce pool ------ */
+
+static struct
+{
+    pthread_mutex_t mutex; // protects ECDSA_nonce_pool and the fields below
+    pthread_cond_t refill_cond;
+    pthread_t thread;
+    int running;
+    int stop;
+} ECDSA_nonce_refill = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+static pthread_once_t ECDSA_nonce_atfork_once = PTHREAD_ONCE_INIT;
+
+/* fork() handlers: the pool is not copied half written, and the child never uses a nonce of the parent, two
+   signatures with the same k reveal the private key */
+static void ecdsa_nonce_atfork_prepare()
+{
+    pthread_mutex_lock(&ECDSA_nonce_refill.mutex);
+}
+
+static void ecdsa_nonce_atfork_parent()
+{
+    pthread_mutex_unlock(&ECDSA_nonce_refill.mutex);
+}
+
+static void ecdsa_nonce_atfork_child()
+{
+    memset(&ECDSA_nonce_pool, 0, sizeof(ECDSA_nonce_pool));
+    pthread_cond_init(&ECDSA_nonce_refill.refill_cond, NULL);
+    ECDSA_nonce_refill.running = 0; /* the refill thread is not copied, the next signature starts a new one */
+    ECDSA_nonce_refill.stop = 0;
+    pthread_mutex_unlock(&ECDSA_nonce_refill.mutex);
+}
+
+static void ecdsa_nonce_atfork_register()
+{
+    pthread_atfork(ecdsa_nonce_atfork_prepare, ecdsa_nonce_atfork_parent, ecdsa_nonce_atfork_child);
+}
+
+/* Keeps the pool full, the nonces are computed in ECDSA_nonce_pool.refill_ctx without holding the mutex */
+static void *ecdsa_nonce_refill_thread(void *p_arg)
+{
+    ECDSA_CTX *l_ctx = &ECDSA_nonce_pool.refill_ctx;
+    int l_ok;
+
+    (void)p_arg;
+    pthread_mutex_lock(&ECDSA_nonce_refill.mutex);
+    while(!ECDSA_nonce_refill.stop)
+    {
+        if(ECDSA_nonce_pool.count == ECDSA_NONCE_POOL_SIZE)
+        {
+            pthread_cond_wait(&ECDSA_nonce_refill.refill_cond, &ECDSA_nonce_refill.mutex);
+            continue;
+        }
+        pthread_mutex_unlock(&ECDSA_nonce_refill.mutex);
+
+        l_ok = ecdsa_make_nonce(l_ctx);
+
+        pthread_mutex_lock(&ECDSA_nonce_refill.mutex);
+        if(!l_ok)
+        { /* no random source, ecdsa_sign computes its nonces and reports the error */
+            break;
+        }
+        if(!ECDSA_nonce_refill.stop && ECDSA_nonce_pool.count < ECDSA_NONCE_POOL_SIZE)
+        {
+            ECDSA_nonce_pool.nonces[ECDSA_nonce_pool.count++] = l_ctx->nonce;
+        }
+        memset(l_ctx, 0, sizeof(*l_ctx));
+    }
+    ECDSA_nonce_refill.running = 0;
+    pthread_mutex_unlock(&ECDSA_nonce_refill.mutex);
+    return NULL;
+}
+
+/* Takes a nonce from the pool, it is zeroized there. Starts the refill thread the first time. Returns 0 if the
+   pool is empty. */
+static int ecdsa_nonce_pool_take(ECDSA_NONCE *p_nonce)
+{
+    int l_taken = 0;
+
+    pthread_once(&ECDSA_nonce_atfork_once, ecdsa_nonce_atfork_register);
+    pthread_mutex_lock(&ECDSA_nonce_refill.mutex);
+    if(!ECDSA_nonce_refill.running && !ECDSA_nonce_refill.stop)
+    {
+        ECDSA_nonce_refill.running = (pthread_create(&ECDSA_nonce_refill.thread, NULL, ecdsa_nonce_refill_thread, NULL) == 0);
+        ECDSA_nonce_refill.stop = !ECDSA_nonce_refill.running; /* do not try again on every signature */
+    }
+    if(ECDSA_nonce_pool.count > 0)
+    {
+        ECDSA_NONCE *l_slot = &ECDSA_nonce_pool.nonces[--ECDSA_nonce_pool.count];
+        *p_nonce = *l_slot;
+        memset(l_slot, 0, sizeof(*l_slot));
+        l_taken = 1;
+    }
+    pthread_cond_signal(&ECDSA_nonce_refill.refill_cond);
+    pthread_mutex_unlock(&ECDSA_nonce_refill.mutex);
+    return l_taken;
+}
+
+void API_ECDSA_nonce_pool_stop()
+{
+    int l_join;
+
+    pthread_mutex_lock(&ECDSA_nonce_refill.mutex);
+    ECDSA_nonce_refill.stop = 1;
+    l_join = ECDSA_nonce_refill.running;
+    pthread_cond_broadcast(&ECDSA_nonce_refill.refill_cond);
+    pthread_mutex_unlock(&ECDSA_nonce_refill.mutex);
+
+    if(l_join)
+    {
+        pthread_join(ECDSA_nonce_refill.thread, NULL);
+    }
+
+    pthread_mutex_lock(&ECDSA_nonce_refill.mutex);
+    memset(&ECDSA_nonce_pool, 0, sizeof(ECDSA_nonce_pool));
+    ECDSA_nonce_refill.running = 0;
+    ECDSA_nonce_refill.stop = 0; /* the next signature starts the pool again */
+    pthread_mutex_unlock(&ECDSA_nonce_refill.mutex);
+}
+
+int ecdsa_sign_ctx(ECDSA_CTX *p_ctx, const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2])
+{
+    /* r and 1/k from the pool, computed here if it is empty */
+    if(!ecdsa_nonce_pool_take(&p_ctx->nonce) && !ecdsa_make_nonce(p_ctx))
+    {
+        memset(p_ctx, 0, sizeof(*p_ctx));
+        return 0;
+    }
+
+    ecc_native2bytes(p_signature, p_ctx->nonce.r);
     
+    ecc_bytes2native(p_ctx->tmp, p_privateKey);
+    vli_modMult_n(p_ctx->s, p_ctx->nonce.r, p_ctx->tmp); /* s = r*d */
+    ecc_bytes2native(p_ctx->tmp, p_hash);
+    vli_modAdd(p_ctx->s, p_ctx->tmp, p_ctx->s, ECDSA_curve_n); /* s = e + r*d */
+    vli_modMult_n(p_ctx->s, p_ctx->s, p_ctx->nonce.k_inv); /* s = (e + r*d) / k */
+    ecc_native2bytes(p_signature + ECC_BYTES, p_ctx->s);
+
+    memset(p_ctx, 0, sizeof(*p_ctx));
     return 1;
 }
 
-int API_ecdsa_verify(const uint8_t p_publicKey[ECC_BYTES+1], const uint8_t p_hash[ECC_BYTES], const uint8_t p_signature[ECC_BYTES*2])
+int ecdsa_sign(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2])
+{
+    int l_result;
+
+    pthread_mutex_lock(&ECDSA_sign_lock);
+    l_result = ecdsa_sign_ctx(&ECDSA_sign_ctx, p_privateKey, p_hash, p_signature);
+    pthread_mutex_unlock(&ECDSA_sign_lock);
+    return l_result;
+}
+
+/* Width-ECDSA_WNAF_WIDTH NAF of p_scalar (public), p_naf[i] is 0 or odd in [-(2^(w-1) - 1), 2^(w-1) - 1].
+   Returns the number of digits. */
+static uint vli_wnaf(int8_t p_naf[ECC_BYTES * 8 + 1], uint64_t *p_scalar)
+{
+    uint64_t k[NUM_ECC_DIGITS];
+    uint64_t l_digit[NUM_ECC_DIGITS] = {0};
+    uint l_len = 0;
+
+    vli_set(k, p_scalar);
+    while(!vli_isZero(k))
+    {
+        int d = 0;
+        if(k[0] & 1)
+        {
+            d = (int)(k[0] & ((1 << ECDSA_WNAF_WIDTH) - 1));
+            if(d >= (1 << (ECDSA_WNAF_WIDTH - 1)))
+            {
+                d -= (1 << ECDSA_WNAF_WIDTH);
+            }
+            /* k -= d, k < n so k + 2^(w-1) does not overflow */
+            l_digit[0] = (uint64_t)(d < 0 ? -d : d);
+            if(d < 0)
+            {
+                vli_add(k, k, l_digit);
+            }
+            else
+            {
+                vli_sub(k, k, l_digit);
+            }
+        }
+        p_naf[l_len++] = (int8_t)d;
+        vli_rshift1(k);
+    }
+    return l_len;
+}
+
+/* Converts p_count Jacobian points to affine with a single inversion (Montgomery's simultaneous inversion).
+   All the Z must be non zero. p_out[i].x holds the prefix products Z[0] * ... * Z[i] until it is overwritten. */
+static void EccPoint_batch_to_affine(EccPoint *p_out, uint64_t (*X)[NUM_ECC_DIGITS], uint64_t (*Y)[NUM_ECC_DIGITS], uint64_t (*Z)[NUM_ECC_DIGITS], uint p_count)
+{
+    uint64_t l_inv[NUM_ECC_DIGITS], l_zinv[NUM_ECC_DIGITS], t[NUM_ECC_DIGITS];
+    uint i;
+
+    vli_set(p_out[0].x, Z[0]);
+    for(i = 1; i < p_count; ++i)
+    {
+        vli_modMult_fast(p_out[i].x, p_out[i-1].x, Z[i]);
+    }
+
+    /* Invert the product of the Z and walk back */
+    vli_modInv_fast(l_inv, p_out[p_count-1].x);
+    for(i = p_count; i-- > 0; )
+    {
+        if(i > 0)
+        {
+            vli_modMult_fast(l_zinv, l_inv, p_out[i-1].x); /* 1/Z[i] */
+            vli_modMult_fast(l_inv, l_inv, Z[i]);          /* 1/(Z[0] * ... * Z[i-1]) */
+        }
+        else
+        {
+            vli_set(l_zinv, l_inv);
+        }
+        vli_modSquare_fast(t, l_zinv);
+        vli_modMult_fast(p_out[i].x, X[i], t);
+        vli_modMult_fast(t, t, l_zinv);
+        vli_modMult_fast(p_out[i].y, Y[i], t);
+    }
+}
+
+/* (X[i], Y[i], Z[i]) = (2i + 1) * p_point in Jacobian coordinates, for the 2^(w-2) odd multiples used by the wNAF.
+   2P is computed in Jacobian coordinates (X2, Y2, Z2) and P is scaled by Z2, so 2P can be added as an affine
+   point: the sums have the Z of a curve isomorphic to the original one and their true Z is Z * Z2 (additions
+   do not depend on the curve parameter a). */
+static void EccPoint_odd_multiples_jacobian(uint64_t (*X)[NUM_ECC_DIGITS], uint64_t (*Y)[NUM_ECC_DIGITS], uint64_t (*Z)[NUM_ECC_DIGITS], EccPoint *p_point)
+{
+    uint64_t X2[NUM_ECC_DIGITS], Y2[NUM_ECC_DIGITS], Z2[NUM_ECC_DIGITS];
+    uint i;
+
+    vli_set(Z2, ECDSA_mont_one);
+    vli_set(X2, p_point->x);
+    vli_set(Y2, p_point->y);
+    EccPoint_double_jacobian(X2, Y2, Z2); /* 2P */
+
+    vli_set(X[0], p_point->x);
+    vli_set(Y[0], p_point->y);
+    apply_z(X[0], Y[0], Z2);
+    vli_set(Z[0], ECDSA_mont_one);
+    for(i = 1; i < ECDSA_WNAF_POINTS; ++i)
+    {
+        vli_set(X[i], X[i-1]);
+        vli_set(Y[i], Y[i-1]);
+        vli_set(Z[i], Z[i-1]);
+        EccPoint_add_mixed_vartime(X[i], Y[i], Z[i], X2, Y2);
+    }
+    for(i = 0; i < ECDSA_WNAF_POINTS; ++i)
+    {
+        vli_modMult_fast(Z[i], Z[i], Z2);
+    }
+}
+
+/* p_table[i] = (2i + 1) * p_point in affine coordinates. */
+static void EccPoint_odd_multiples(EccPoint p_table[ECDSA_WNAF_POINTS], EccPoint *p_point)
+{
+    uint64_t X[ECDSA_WNAF_POINTS][NUM_ECC_DIGITS], Y[ECDSA_WNAF_POINTS][NUM_ECC_DIGITS], Z[ECDSA_WNAF_POINTS][NUM_ECC_DIGITS];
+
+    EccPoint_odd_multiples_jacobian(X, Y, Z, p_point);
+    EccPoint_batch_to_affine(p_table, X, Y, Z, ECDSA_WNAF_POINTS);
+}
+
+/* Jacobian (X, Y, Z) += p_digit * table point, p_digit odd or 0 (nothing is added). */
+static void EccPoint_add_wnaf_digit(uint64_t *X, uint64_t *Y, uint64_t *Z, EccPoint *p_odd, int p_digit)
+{
+    uint64_t l_negY[NUM_ECC_DIGITS];
+    EccPoint *l_point;
+
+    if(p_digit == 0)
+    {
+        return;
+    }
+    l_point = &p_odd[((p_digit < 0 ? -p_digit : p_digit) - 1) / 2];
+    if(p_digit > 0)
+    {
+        EccPoint_add_mixed_vartime(X, Y, Z, l_point->x, l_point->y);
+    }
+    else
+    {
+        vli_sub(l_negY, ECDSA_curve_p, l_point->y); /* -P = (x, p - y) */
+        EccPoint_add_mixed_vartime(X, Y, Z, l_point->x, l_negY);
+    }
+}
+
+/* Verifies a signature with the odd multiples of the public key already computed (EccPoint_odd_multiples). */
+static int ecdsa_verify_odd(EccPoint p_oddQ[ECDSA_WNAF_POINTS], const uint8_t p_hash[ECC_BYTES], const uint8_t p_signature[ECC_BYTES*2])
 {
     uint64_t u1[NUM_ECC_DIGITS], u2[NUM_ECC_DIGITS];
     uint64_t z[NUM_ECC_DIGITS];
-    EccPoint l_public, l_sum;
+    EccPoint l_oddG[ECDSA_WNAF_POINTS];
+    int8_t l_naf1[ECC_BYTES * 8 + 1], l_naf2[ECC_BYTES * 8 + 1];
     uint64_t rx[NUM_ECC_DIGITS];
     uint64_t ry[NUM_ECC_DIGITS];
-    uint64_t tx[NUM_ECC_DIGITS];
-    uint64_t ty[NUM_ECC_DIGITS];
-    uint64_t tz[NUM_ECC_DIGITS];
-    
+    uint64_t t[NUM_ECC_DIGITS];
+    uint i;
+
     uint64_t l_r[NUM_ECC_DIGITS], ECDSA_l_s[NUM_ECC_DIGITS];
-    ecc_point_decompress(&l_public, p_publicKey);
     ecc_bytes2native(l_r, p_signature);
     ecc_bytes2native(ECDSA_l_s, p_signature + ECC_BYTES);
     if(vli_isZero(l_r) || vli_isZero(ECDSA_l_s))
@@ -1219,58 +2347,140 @@ int API_ecdsa_verify(const uint8_t p_publicKey[ECC_BYTES+1], const uint8_t p_has
         return 0;
     }
     /* Calculate u1 and u2. */
-    vli_modInv(z, ECDSA_l_s, ECDSA_curve_n); /* Z = s^-1 */
+    vli_modInv_n(z, ECDSA_l_s); /* Z = s^-1 */
     ecc_bytes2native(u1, p_hash);
     vli_modMult(u1, u1, z, ECDSA_curve_n); /* u1 = e/s */
     vli_modMult(u2, l_r, z, ECDSA_curve_n); /* u2 = r/s */
-    
-    /* Calculate l_sum = G + Q. */
-    vli_set(l_sum.x, l_public.x);
-    vli_set(l_sum.y, l_public.y);
-    vli_set(tx, ECDSA_curve_G.x);
-    vli_set(ty, ECDSA_curve_G.y);
-    vli_modSub(z, l_sum.x, tx, ECDSA_curve_p); /* Z = x2 - x1 */
-    XYcZ_add(tx, ty, l_sum.x, l_sum.y);
-    vli_modInv(z, z, ECDSA_curve_p); /* Z = 1/Z */
-    apply_z(l_sum.x, l_sum.y, z);
-    
-    /* Use Shamir's trick to calculate u1*G + u2*Q */
-    EccPoint *l_points[4] = {NULL, &ECDSA_curve_G, &l_public, &l_sum};
-    uint l_numBits = umax(vli_numBits(u1), vli_numBits(u2));
-    
-    EccPoint *l_point = l_points[(!!vli_testBit(u1, l_numBits-1)) | ((!!vli_testBit(u2, l_numBits-1)) << 1)];
-    vli_set(rx, l_point->x);
-    vli_set(ry, l_point->y);
-    vli_clear(z);
-    z[0] = 1;
 
-    int i;
-    for(i = l_numBits - 2; i >= 0; --i)
+    /* Odd multiples of G come from the first row of the fixed-base table */
+    API_ECDSA_precompute_G_table();
+    for(i = 0; i < ECDSA_WNAF_POINTS; ++i)
+    {
+        l_oddG[i] = ECDSA_G_table[0][2 * i];
+    }
+
+    /* Interleaved wNAF: u1*G + u2*Q with a single chain of doublings */
+    uint l_len1 = vli_wnaf(l_naf1, u1);
+    uint l_len2 = vli_wnaf(l_naf2, u2);
+    uint l_len = (l_len1 > l_len2) ? l_len1 : l_len2;
+
+    vli_clear(rx);
+    vli_clear(ry);
+    vli_clear(z); /* point at infinity */
+    for(i = l_len; i-- > 0; )
     {
         EccPoint_double_jacobian(rx, ry, z);
-        
-        int l_index = (!!vli_testBit(u1, i)) | ((!!vli_testBit(u2, i)) << 1);
-        EccPoint *l_point = l_points[l_index];
-        if(l_point)
+        EccPoint_add_wnaf_digit(rx, ry, z, l_oddG, (i < l_len1) ? l_naf1[i] : 0);
+        EccPoint_add_wnaf_digit(rx, ry, z, p_oddQ, (i < l_len2) ? l_naf2[i] : 0);
+    }
+    if(vli_isZero(z))
+    {
+        return 0;
+    }
+
+    /* Accept only if x(R) mod n == r. x(R) = X/Z^2 is compared as r*Z^2 == X (mod p), and as (r + n)*Z^2
+       when r + n < p, so no inversion is needed. */
+    vli_modSquare_fast(z, z);
+    vli_toMont(t, l_r);
+    vli_modMult_fast(t, t, z);
+    if(vli_cmp(t, rx) == 0)
+    {
+        return 1;
+    }
+    if(!vli_add(t, l_r, ECDSA_curve_n) && vli_cmp(t, ECDSA_curve_p) < 0)
+    {
+        vli_toMont(t, t);
+        vli_modMult_fast(t, t, z);
+        return (vli_cmp(t, rx) == 0);
+    }
+    return 0;
+}
+
+int API_ecdsa_verify(const uint8_t p_publicKey[ECC_BYTES+1], const uint8_t p_hash[ECC_BYTES], const uint8_t p_signature[ECC_BYTES*2])
+{
+    EccPoint l_public;
+    EccPoint l_oddQ[ECDSA_WNAF_POINTS];
+
+    ecc_point_decompress(&l_public, p_publicKey);
+    EccPoint_odd_multiples(l_oddQ, &l_public);
+    return ecdsa_verify_odd(l_oddQ, p_hash, p_signature);
+}
+
+/* Slot of p_publicKey in the first p_count keys of p_keys, or -1 */
+static int ecdsa_batch_find_key(const uint8_t *p_keys[ECDSA_BATCH_KEYS], uint p_count, const uint8_t *p_publicKey)
+{
+    uint i;
+
+    for(i = 0; i < p_count; ++i)
+    {
+        if(p_keys[i] == p_publicKey || memcmp(p_keys[i], p_publicKey, ECC_BYTES+1) == 0)
         {
-            vli_set(tx, l_point->x);
-            vli_set(ty, l_point->y);
-            apply_z(tx, ty, z);
-            vli_modSub(tz, rx, tx, ECDSA_curve_p); /* Z = x2 - x1 */
-            XYcZ_add(tx, ty, rx, ry);
-            vli_modMult_fast(z, z, tz);
+            return i;
         }
     }
-    vli_modInv(z, z, ECDSA_curve_p); /* Z = 1/Z */
-    apply_z(rx, ry, z);
-    
-    /* v = x1 (mod n) */
-    if(vli_cmp(ECDSA_curve_n, rx) != 1)
+    return -1;
+}
+
+int API_ecdsa_verify_batch(const uint8_t *const p_publicKeys[], const uint8_t *const p_hashes[], const uint8_t *const p_signatures[], size_t p_count, uint8_t p_results[])
+{
+    const uint8_t *l_keys[ECDSA_BATCH_KEYS];
+    uint8_t l_bad[ECDSA_BATCH_KEYS];
+    EccPoint l_public;
+    EccPoint l_oddQ[ECDSA_BATCH_KEYS * ECDSA_WNAF_POINTS];
+    uint64_t X[ECDSA_BATCH_KEYS * ECDSA_WNAF_POINTS][NUM_ECC_DIGITS];
+    uint64_t Y[ECDSA_BATCH_KEYS * ECDSA_WNAF_POINTS][NUM_ECC_DIGITS];
+    uint64_t Z[ECDSA_BATCH_KEYS * ECDSA_WNAF_POINTS][NUM_ECC_DIGITS];
+    size_t l_first = 0, l_end, i;
+    uint l_nkeys, k, j;
+    int l_slot, l_all = 1;
+
+    if(!p_publicKeys || !p_hashes || !p_signatures || !p_results)
+    {
+        return 0;
+    }
+
+    while(l_first < p_count)
     {
-        vli_sub(rx, rx, ECDSA_curve_n);
+        /* Distinct keys of the items [l_first, l_end), up to ECDSA_BATCH_KEYS per pass */
+        l_nkeys = 0;
+        for(l_end = l_first; l_end < p_count; ++l_end)
+        {
+            if(ecdsa_batch_find_key(l_keys, l_nkeys, p_publicKeys[l_end]) < 0)
+            {
+                if(l_nkeys == ECDSA_BATCH_KEYS)
+                {
+                    break;
+                }
+                l_keys[l_nkeys++] = p_publicKeys[l_end];
+            }
+        }
+
+        /* Each key is decompressed once, and the odd multiples of all of them share one inversion */
+        for(k = 0; k < l_nkeys; ++k)
+        {
+            ecc_point_decompress(&l_public, l_keys[k]);
+            EccPoint_odd_multiples_jacobian(X + k * ECDSA_WNAF_POINTS, Y + k * ECDSA_WNAF_POINTS, Z + k * ECDSA_WNAF_POINTS, &l_public);
+            l_bad[k] = 0;
+            for(j = k * ECDSA_WNAF_POINTS; j < (k + 1) * ECDSA_WNAF_POINTS; ++j)
+            { /* Only an invalid key reaches infinity, it must not zero the shared inversion */
+                if(vli_isZero(Z[j]))
+                {
+                    l_bad[k] = 1;
+                    vli_set(Z[j], ECDSA_mont_one);
+                }
+            }
+        }
+        EccPoint_batch_to_affine(l_oddQ, X, Y, Z, l_nkeys * ECDSA_WNAF_POINTS);
+
+        for(i = l_first; i < l_end; ++i)
+        {
+            l_slot = ecdsa_batch_find_key(l_keys, l_nkeys, p_publicKeys[i]);
+            p_results[i] = !l_bad[l_slot] && ecdsa_verify_odd(l_oddQ + l_slot * ECDSA_WNAF_POINTS, p_hashes[i], p_signatures[i]);
+            l_all &= p_results[i];
+        }
+        l_first = l_end;
     }
-    /* Accept only if v == r. */
-    return (vli_cmp(rx, l_r) == 0);
+    return l_all;
 }
 
 void API_ECDSA256_API_CP_compress_key(unsigned char *Qx, int length_qx, unsigned char *Qy, int length_qy, uint8_t *compressed_key){
@@ -93,14 +93,152 @@ extern uint64_t ECDSA_curve_b[NUM_ECC_DIGITS];
 extern EccPoint ECDSA_curve_G;
 extern uint64_t ECDSA_curve_n[NUM_ECC_DIGITS];
 
-extern uint64_t ECDSA_k[NUM_ECC_DIGITS];
-extern uint64_t ECDSA_l_tmp[NUM_ECC_DIGITS];
-extern uint64_t ECDSA_l_s[NUM_ECC_DIGITS];
+/** @def ECDSA_G_TABLE_WINDOWS
+ *  @brief Number of 4-bit windows of a scalar, one table row per window.
+ */
+#define ECDSA_G_TABLE_WINDOWS (ECC_BYTES * 2)
+
+/** @def ECDSA_G_TABLE_POINTS
+ *  @brief Points per table row, the multiples 1..15 of the row base (digit 0 is not stored).
+ */
+#define ECDSA_G_TABLE_POINTS 15
+
+/** @def ECDSA_WNAF_WIDTH
+ *  @brief Window width of the wNAF used by API_ecdsa_verify, its odd multiples of G are in the first row of ECDSA_G_table.
+ */
+#define ECDSA_WNAF_WIDTH 5
+
+/** @def ECDSA_WNAF_POINTS
+ *  @brief Odd multiples (1, 3, ..., 2^(w-1) - 1) of a point used by the wNAF.
+ */
+#define ECDSA_WNAF_POINTS (1 << (ECDSA_WNAF_WIDTH - 2))
+
+/** @def ECDSA_BATCH_KEYS
+ *  @brief Distinct public keys prepared per pass of API_ecdsa_verify_batch, a batch with more keys is split in passes.
+ */
+#define ECDSA_BATCH_KEYS 16
+
+/**
+ * @brief Field arithmetic implementations of the curve, selected once with CPUID
+ */
+typedef enum ECDSA_implementation
+{
+    ecdsa_still_to_check,
+    ecdsa_generic,       // vli_mult and the fast reduction of the curve (curves other than P-256)
+    ecdsa_p256_portable, // P-256 Montgomery multiplication in C with 128 bits products
+    ecdsa_p256_MULX_ADX, // P-256 Montgomery multiplication unrolled with MULX/ADCX/ADOX
+} ECDSA_implementation;
+
+/** @def ECDSA_DECOMPRESS_CACHE_SIZE
+ *  @brief Decompressed public keys kept in ECDSA_decompress_cache, the oldest one is replaced.
+ */
+#define ECDSA_DECOMPRESS_CACHE_SIZE 8
+
+/**
+ * @brief Public key in the decompression cache, the point is stored as used internally (Montgomery form for P-256)
+ */
+typedef struct ECDSA_DECOMPRESSED_KEY
+{
+    uint8_t compressed[ECC_BYTES+1]; /**< Compressed key, the cache lookup key */
+    EccPoint point;                  /**< Decompressed point */
+    uint8_t valid;                   /**< 1 if the entry is used */
+} ECDSA_DECOMPRESSED_KEY;
+
+/** @def ECDSA_NONCE_POOL_SIZE
+ *  @brief Precomputed signature nonces kept in ECDSA_nonce_pool.
+ */
+#define ECDSA_NONCE_POOL_SIZE 64
+
+/**
+ * @brief Message independent part of an ECDSA signature, used once
+ */
+typedef struct ECDSA_NONCE
+{
+    uint64_t r[NUM_ECC_DIGITS];     /**< r = x(k*G) mod n */
+    uint64_t k_inv[NUM_ECC_DIGITS]; /**< 1/k mod n, CSP */
+} ECDSA_NONCE;
+
+/**
+ * @brief Scratch of one ECDSA signature, owned by the caller
+ *
+ * Every secret intermediate value of ecdsa_sign_ctx lives here, so several threads can sign at the same time,
+ * each one with its own context. It is zeroized at the end of every signature; the caller can keep it in static
+ * or heap memory and register it with API_MT_add_tracker as a CSP, so it is mlocked and zeroized with the module.
+ */
+typedef struct ECDSA_CTX
+{
+    ECDSA_NONCE nonce;             /**< r and 1/k of the signature in progress, CSP */
+    uint64_t k[NUM_ECC_DIGITS];    /**< Ephemeral key k while a nonce is computed, CSP */
+    uint64_t tmp[NUM_ECC_DIGITS];  /**< Private key, then message hash, CSP */
+    uint64_t s[NUM_ECC_DIGITS];    /**< s value in progress, CSP */
+} ECDSA_CTX;
+
+/**
+ * @brief Pool of precomputed nonces, refilled by a background thread and consumed by ecdsa_sign
+ */
+typedef struct ECDSA_NONCE_POOL
+{
+    ECDSA_NONCE nonces[ECDSA_NONCE_POOL_SIZE]; /**< Available nonces, the first count ones, CSP */
+    uint32_t count;                            /**< Number of available nonces */
+    ECDSA_CTX refill_ctx;                      /**< Scratch of the refill thread, CSP */
+} ECDSA_NONCE_POOL;
+
+/**
+ * Fixed-base table of the generator, ECDSA_G_table[i][j] = (j + 1) * 16^i * G in affine coordinates
+ * (Montgomery form for P-256).
+ * Built once by API_ECDSA_precompute_G_table, public data.
+ */
+extern EccPoint ECDSA_G_table[ECDSA_G_TABLE_WINDOWS][ECDSA_G_TABLE_POINTS];
+
+/**
+ * Last public keys decompressed by ECDH and the verification functions, public data.
+ */
+extern ECDSA_DECOMPRESSED_KEY ECDSA_decompress_cache[ECDSA_DECOMPRESS_CACHE_SIZE];
+
+/**
+ * Precomputed signature nonces, CSP. Zeroized in the child process after fork().
+ */
+extern ECDSA_NONCE_POOL ECDSA_nonce_pool;
+
+/**
+ * Context of ecdsa_sign, the signatures made with it are serialized, CSP.
+ */
+extern ECDSA_CTX ECDSA_sign_ctx;
+
 
 /****************************************************************************************************************
  * Function definition zone
  ****************************************************************************************************************/
 
+/**
+ * @brief Returns the field arithmetic used in this machine, checking it with CPUID the first time.
+ *
+ * P-256 field elements are kept in Montgomery form by every sign, verify, ECDH and key generation, the
+ * multiplication uses MULX/ADCX/ADOX if BMI2 and ADX are supported and portable C otherwise.
+ *
+ * @return ecdsa_p256_MULX_ADX, ecdsa_p256_portable, or ecdsa_generic for the other curves.
+ */
+ECDSA_implementation API_ECDSA_getImplementation();
+
+/**
+ * @brief Builds the fixed-base table of the generator (ECDSA_G_table), only the first call computes it.
+ *
+ * k*G is then computed with one mixed addition per 4-bit window of k and no doublings, instead of the
+ * Montgomery ladder. It is called during the module initialization, and by ecc_make_key and ecdsa_sign if
+ * the table is not built yet (thread safe).
+ */
+void API_ECDSA_precompute_G_table();
+
+/**
+ * @brief Checks the constant time inverses against the binary extended Euclidean algorithm (vli_modInv).
+ *
+ * The field inverse (Fermat, Montgomery form) and the inverse modulo n are compared with vli_modInv on fixed
+ * edge inputs: 0 to 3, p - 1, p - 2, n - 1, n - 2, 2^(bits-1), and inputs with one bit per limb and alternating bits.
+ *
+ * @return 1 if every inverse matches, 0 otherwise.
+ */
+int API_ECDSA_inverse_selftest();
+
 /**
  * @brief Generate a public/private key pair using ECDSA.
  * 
@@ -113,11 +251,23 @@ extern uint64_t ECDSA_l_s[NUM_ECC_DIGITS];
  */
 int ecc_make_key(uint8_t p_publicKey[ECC_BYTES+1], uint8_t p_privateKey[ECC_BYTES]);
 
+/**
+ * @brief Stops and joins the nonce pool thread and zeroizes the precomputed nonces.
+ *
+ * Called on module shutdown and before the zeroization of the module, a later call to ecdsa_sign starts the
+ * pool again.
+ */
+void API_ECDSA_nonce_pool_stop();
+
 /**
  * @brief Generate an ECDSA signature for a given hash.
  * 
  * This function generates an ECDSA signature for the given message hash using the provided
- * private key.
+ * private key. The nonce k, r and 1/k are taken from ECDSA_nonce_pool (each one is used once and zeroized),
+ * which a background thread started on the first call keeps full, so only two multiplications modulo n depend
+ * on the message. They are computed in the call if the pool is empty.
+ * It works on the module context ECDSA_sign_ctx (registered with the memory tracker) under a mutex, threads that
+ * sign in parallel use ecdsa_sign_ctx with a context each.
  *
  * @param[in]  p_privateKey  Pointer to the private key.
  * @param[in]  p_hash        Pointer to the hash of the message.
@@ -126,11 +276,27 @@ int ecc_make_key(uint8_t p_publicKey[ECC_BYTES+1], uint8_t p_privateKey[ECC_BYTE
  */
 int ecdsa_sign(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2]);
 
+/**
+ * @brief Generate an ECDSA signature for a given hash using a caller-owned context.
+ *
+ * Same signature as ecdsa_sign, with all the secret intermediate values in p_ctx, which is zeroized before
+ * returning. The random numbers are read from a single random device descriptor shared by all the threads,
+ * so a pool of threads can sign in parallel, each one with its own context.
+ *
+ * @param[in]  p_ctx         Scratch context, may be registered with the memory tracker (see ECDSA_CTX).
+ * @param[in]  p_privateKey  Pointer to the private key.
+ * @param[in]  p_hash        Pointer to the hash of the message.
+ * @param[out] p_signature   Pointer to buffer where the generated signature will be stored.
+ * @return 1 on success, 0 on failure.
+ */
+int ecdsa_sign_ctx(ECDSA_CTX *p_ctx, const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_BYTES], uint8_t p_signature[ECC_BYTES*2]);
+
 /**
  * @brief Verify an ECDSA signature.
  * 
  * This function verifies an ECDSA signature for the given message hash using the provided
- * public key.
+ * public key. u1*G + u2*Q is computed with an interleaved wNAF (ECDSA_WNAF_WIDTH), variable time as only
+ * public data is involved.
  *
  * @param[in] p_publicKey Pointer to the public key.
  * @param[in] p_hash      Pointer to the hash of the signed message.
@@ -139,6 +305,22 @@ int ecdsa_sign(const uint8_t p_privateKey[ECC_BYTES], const uint8_t p_hash[ECC_B
  */
 int API_ecdsa_verify(const uint8_t p_publicKey[ECC_BYTES+1], const uint8_t p_hash[ECC_BYTES], const uint8_t p_signature[ECC_BYTES*2]);
 
+/**
+ * @brief Verify several ECDSA signatures, usually made with a few public keys.
+ *
+ * Same result as calling API_ecdsa_verify for each item. The items are grouped by public key, each distinct
+ * key is decompressed and its wNAF table is built once per batch, and the tables of all the keys are
+ * converted to affine coordinates with a single field inversion (Montgomery's simultaneous inversion).
+ *
+ * @param[in]  p_publicKeys  Array with the compressed public key of each item (equal keys may be different pointers).
+ * @param[in]  p_hashes      Array with the hash of the signed message of each item.
+ * @param[in]  p_signatures  Array with the ECDSA signature (r and s components) of each item.
+ * @param[in]  p_count       Number of items.
+ * @param[out] p_results     Array of p_count bytes, 1 if the signature of the item is valid, 0 if it failed.
+ * @return 1 if all the signatures are valid, 0 if at least one failed (see p_results) or an array is NULL.
+ */
+int API_ecdsa_verify_batch(const uint8_t *const p_publicKeys[], const uint8_t *const p_hashes[], const uint8_t *const p_signatures[], size_t p_count, uint8_t p_results[]);
+
 /**
  * @brief Compress an ECDSA signature.
  * 
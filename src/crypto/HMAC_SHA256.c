@@ -57,6 +57,144 @@ unsigned char *API_hmac_sha256(unsigned char *key, int keylen, unsigned char *da
     return HMAC256_ohash;
 }
 
+void API_hmac_sha256_precompute(unsigned char *key, int keylen, HMAC_SHA256_MIDSTATE *midstate)
+{
+    unsigned char k[HMAC_SHA256_BLOCK_SIZE] = {0}; // CSP
+    unsigned char pad[HMAC_SHA256_BLOCK_SIZE];      // CSP
+    SHA256_STRUCT ctx;                              // CSP
+    int i;
+
+    if (keylen > HMAC_SHA256_BLOCK_SIZE)
+    {
+        API_sha256(key, keylen, k);
+    }
+    else
+    {
+        memcpy(k, key, keylen);
+    }
+
+    // The pads fill exactly one block, the state after each one is the midstate
+    CP_sha256_init(&ctx);
+    for (i = 0; i < HMAC_SHA256_BLOCK_SIZE; i++)
+        pad[i] = k[i] ^ 0x36;
+    CP_sha256_computation(&ctx, pad);
+    memcpy(midstate->inner, ctx.temp_hash, sizeof(midstate->inner));
+
+    CP_sha256_init(&ctx);
+    for (i = 0; i < HMAC_SHA256_BLOCK_SIZE; i++)
+        pad[i] = k[i] ^ 0x5c;
+    CP_sha256_computation(&ctx, pad);
+    memcpy(midstate->outer, ctx.temp_hash, sizeof(midstate->outer));
+
+    memset(k, 0, sizeof(k));
+    memset(pad, 0, sizeof(pad));
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+// Starts a SHA-256 from a midstate, the pad block is already counted in the length
+static void CP_hmac_sha256_resume(SHA256_STRUCT *ctx, const _INT32 state[8])
+{
+    memcpy(ctx->temp_hash, state, sizeof(ctx->temp_hash));
+    ctx->datalen = 0;
+    ctx->bitlen = HMAC_SHA256_BLOCK_SIZE * 8;
+}
+
+void API_hmac_sha256_init_midstate(HMAC_SHA256_CTX *ctx, const HMAC_SHA256_MIDSTATE *midstate)
+{
+    CP_hmac_sha256_resume(&ctx->inner, midstate->inner);
+    memcpy(ctx->outer, midstate->outer, sizeof(ctx->outer));
+}
+
+void API_hmac_sha256_init(HMAC_SHA256_CTX *ctx, unsigned char *key, int keylen)
+{
+    HMAC_SHA256_MIDSTATE midstate; // CSP
+
+    API_hmac_sha256_precompute(key, keylen, &midstate);
+    API_hmac_sha256_init_midstate(ctx, &midstate);
+    memset(&midstate, 0, sizeof(midstate));
+}
+
+void API_hmac_sha256_update(HMAC_SHA256_CTX *ctx, const unsigned char *data, size_t datalen)
+{
+    CP_sha256_update(&ctx->inner, data, datalen);
+}
+
+void API_hmac_sha256_final(HMAC_SHA256_CTX *ctx, unsigned char out[SHA256_HASH_SIZE])
+{
+    unsigned char ihash[SHA256_HASH_SIZE]; // CSP
+
+    CP_sha256_final(&ctx->inner, ihash);
+    CP_hmac_sha256_resume(&ctx->inner, ctx->outer);
+    CP_sha256_update(&ctx->inner, ihash, SHA256_HASH_SIZE);
+    CP_sha256_final(&ctx->inner, out);
+
+    memset(ihash, 0, sizeof(ihash));
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+int API_hmac_sha256_final_verify(HMAC_SHA256_CTX *ctx, const unsigned char *sign, size_t length_sign)
+{
+    unsigned char mac[SHA256_HASH_SIZE];
+    unsigned char diff = 0;
+
+    API_hmac_sha256_final(ctx, mac);
+    if (!sign || length_sign == 0 || length_sign > SHA256_HASH_SIZE)
+    {
+        return MAC_NOT_VERIFIED;
+    }
+    for (size_t i = 0; i < length_sign; i++)
+        diff |= mac[i] ^ sign[i];
+
+    return (diff == 0) ? MAC_VERIFIED : MAC_NOT_VERIFIED;
+}
+
+void API_hmac_sha256_midstate(const HMAC_SHA256_MIDSTATE *midstate, const unsigned char *data, size_t datalen, unsigned char out[SHA256_HASH_SIZE])
+{
+    HMAC_SHA256_CTX ctx; // CSP
+
+    API_hmac_sha256_init_midstate(&ctx, midstate);
+    API_hmac_sha256_update(&ctx, data, datalen);
+    API_hmac_sha256_final(&ctx, out);
+}
+
+int API_verify_HMAC_midstate(const HMAC_SHA256_MIDSTATE *midstate, const unsigned char *msg, const unsigned char *sign, size_t length_msg, size_t length_sign)
+{
+    HMAC_SHA256_CTX ctx; // CSP
+
+    if (!msg)
+    {
+        return MAC_NOT_VERIFIED;
+    }
+    API_hmac_sha256_init_midstate(&ctx, midstate);
+    API_hmac_sha256_update(&ctx, msg, length_msg);
+    return API_hmac_sha256_final_verify(&ctx, sign, length_sign);
+}
+
+void API_hmac_sha256_many_midstate(const HMAC_SHA256_MIDSTATE *midstate, unsigned char **data, const size_t *datalen, size_t nmsgs, unsigned char **out)
+{
+    size_t hash_lengths[HMAC_SHA256_MANY_BATCH];
+
+    for (int i = 0; i < HMAC_SHA256_MANY_BATCH; i++)
+        hash_lengths[i] = SHA256_HASH_SIZE;
+
+    // Inner hashes are written in the output buffers and then replaced by the outer hashes
+    for (size_t first = 0; first < nmsgs; first += HMAC_SHA256_MANY_BATCH)
+    {
+        size_t n = (nmsgs - first < HMAC_SHA256_MANY_BATCH) ? nmsgs - first : HMAC_SHA256_MANY_BATCH;
+        CP_sha256_many(midstate->inner, HMAC_SHA256_BLOCK_SIZE, data + first, datalen + first, n, out + first);
+        CP_sha256_many(midstate->outer, HMAC_SHA256_BLOCK_SIZE, out + first, hash_lengths, n, out + first);
+    }
+}
+
+void API_hmac_sha256_many(unsigned char *key, int keylen, unsigned char **data, const size_t *datalen, size_t nmsgs, unsigned char **out)
+{
+    HMAC_SHA256_MIDSTATE midstate; // CSP
+
+    API_hmac_sha256_precompute(key, keylen, &midstate);
+    API_hmac_sha256_many_midstate(&midstate, data, datalen, nmsgs, out);
+    memset(&midstate, 0, sizeof(midstate));
+}
+
 int API_verify_HMAC(unsigned char *msg, unsigned char *key, unsigned char *sign, size_t length_msg, size_t length_key, size_t length_sign)
 {
 	int rc = 0; // Returns value variable
@@ -68,15 +206,11 @@ int API_verify_HMAC(unsigned char *msg, unsigned char *key, unsigned char *sign,
 	{ // Error when there is not signature
 		return rc;
 	}
-	unsigned char *out ;
-	out = API_hmac_sha256(key, length_key, msg, length_msg);
-    while(length_sign--)
-        rc|=*out++^*sign++;
-        
-	if (rc)//if not verified
-		return MAC_NOT_VERIFIED;
-	else //if verified
-		return MAC_VERIFIED;
+	// Computed in a caller stack context, so concurrent verifications do not share the HMAC globals
+	HMAC_SHA256_CTX ctx; // CSP
+	API_hmac_sha256_init(&ctx, key, length_key);
+	API_hmac_sha256_update(&ctx, msg, length_msg);
+	return API_hmac_sha256_final_verify(&ctx, sign, length_sign);
 }
 
 static void sha256_HMAC(unsigned char *key,size_t key_length,unsigned char *msg, int length_msg ,unsigned char *out)
@@ -47,6 +47,36 @@
  */
 #define HMAC_SHA256_BLOCK_SIZE 64
 
+/**
+ * @brief Messages authenticated per call to the multi-buffer engine in API_hmac_sha256_many
+ */
+#define HMAC_SHA256_MANY_BATCH 64
+
+/**
+ * @brief SHA-256 states after compressing the inner (key XOR ipad) and outer (key XOR opad) blocks of an HMAC key
+ *
+ * Computed once per key with API_hmac_sha256_precompute, every HMAC then starts from these states and saves
+ * the two pad compressions.
+ */
+typedef struct HMAC_SHA256_MIDSTATE
+{
+    _INT32 inner[8]; /**< State after the inner pad block, CSP */
+    _INT32 outer[8]; /**< State after the outer pad block, CSP */
+} HMAC_SHA256_MIDSTATE;
+
+/**
+ * @brief Caller-owned context of a streaming HMAC-SHA256 (API_hmac_sha256_init/update/final)
+ *
+ * Holds every intermediate value of one HMAC, so several contexts can be used at the same time from different
+ * threads. It contains secret data: the caller can register it with API_MT_add_tracker, and it is zeroized by
+ * API_hmac_sha256_final.
+ */
+typedef struct HMAC_SHA256_CTX
+{
+    SHA256_STRUCT inner; /**< Inner hash in progress, started from the inner midstate, CSP */
+    _INT32 outer[8];     /**< Outer midstate of the key, CSP */
+} HMAC_SHA256_CTX;
+
 /* Global variables definition ...................................... */
 
 extern unsigned char HMAC256_ihash[SHA256_HASH_SIZE];
@@ -73,6 +103,118 @@ extern SHA256_STRUCT HMAC256_sha256_struct;
 unsigned char *API_hmac_sha256(unsigned char *key, int keylen, unsigned char *data, int datalen);
 
 
+/**
+ * @brief Precomputes the inner and outer midstates of an HMAC-SHA256 key.
+ *
+ * @param key HMAC key
+ * @param keylen HMAC key lenght
+ * @param midstate Pointer where the midstates of the key are stored
+ */
+void API_hmac_sha256_precompute(unsigned char *key, int keylen, HMAC_SHA256_MIDSTATE *midstate);
+
+/**
+ * @brief Computes the HMAC-SHA256 of a message from the precomputed midstates of the key.
+ *
+ * Same result as API_hmac_sha256 with the key given to API_hmac_sha256_precompute, with two compressions less.
+ * Only stack buffers are used, so it can be called concurrently with the same midstate.
+ *
+ * @param midstate Midstates of the key (see API_hmac_sha256_precompute)
+ * @param data Message to be hashed
+ * @param datalen Message lenght
+ * @param out Buffer of SHA256_HASH_SIZE bytes where the HMAC is stored
+ */
+void API_hmac_sha256_midstate(const HMAC_SHA256_MIDSTATE *midstate, const unsigned char *data, size_t datalen, unsigned char out[SHA256_HASH_SIZE]);
+
+/**
+ * @brief Verifies an HMAC-SHA256 signature from the precomputed midstates of the key, comparing in constant time.
+ *
+ * @param midstate Midstates of the key (see API_hmac_sha256_precompute)
+ * @param msg Message we want to verify
+ * @param sign HMAC signature to verify
+ * @param length_msg Message length
+ * @param length_sign HMAC signature length (up to SHA256_HASH_SIZE)
+ *
+ * @return MAC_VERIFIED if the signature is correct, MAC_NOT_VERIFIED otherwise
+ */
+int API_verify_HMAC_midstate(const HMAC_SHA256_MIDSTATE *midstate, const unsigned char *msg, const unsigned char *sign, size_t length_msg, size_t length_sign);
+
+/**
+ * @brief Starts a streaming HMAC-SHA256 with a key.
+ *
+ * @param ctx Caller-owned context
+ * @param key HMAC key
+ * @param keylen HMAC key lenght
+ */
+void API_hmac_sha256_init(HMAC_SHA256_CTX *ctx, unsigned char *key, int keylen);
+
+/**
+ * @brief Starts a streaming HMAC-SHA256 from the precomputed midstates of the key, no compression is done.
+ *
+ * @param ctx Caller-owned context
+ * @param midstate Midstates of the key (see API_hmac_sha256_precompute)
+ */
+void API_hmac_sha256_init_midstate(HMAC_SHA256_CTX *ctx, const HMAC_SHA256_MIDSTATE *midstate);
+
+/**
+ * @brief Adds a piece of the message to a streaming HMAC-SHA256.
+ *
+ * The pieces may have any length, whole blocks are compressed directly from the caller buffer.
+ *
+ * @param ctx Context started with API_hmac_sha256_init or API_hmac_sha256_init_midstate
+ * @param data Piece of the message
+ * @param datalen Piece lenght
+ */
+void API_hmac_sha256_update(HMAC_SHA256_CTX *ctx, const unsigned char *data, size_t datalen);
+
+/**
+ * @brief Finishes a streaming HMAC-SHA256 and zeroizes the context.
+ *
+ * @param ctx Context started with API_hmac_sha256_init or API_hmac_sha256_init_midstate
+ * @param out Buffer of SHA256_HASH_SIZE bytes where the HMAC is stored
+ */
+void API_hmac_sha256_final(HMAC_SHA256_CTX *ctx, unsigned char out[SHA256_HASH_SIZE]);
+
+/**
+ * @brief Finishes a streaming HMAC-SHA256 and verifies the signature comparing in constant time, the context is zeroized.
+ *
+ * @param ctx Context started with API_hmac_sha256_init or API_hmac_sha256_init_midstate
+ * @param sign HMAC signature to verify
+ * @param length_sign HMAC signature length (up to SHA256_HASH_SIZE)
+ *
+ * @return MAC_VERIFIED if the signature is correct, MAC_NOT_VERIFIED otherwise
+ */
+int API_hmac_sha256_final_verify(HMAC_SHA256_CTX *ctx, const unsigned char *sign, size_t length_sign);
+
+/**
+ * @brief Computes the HMAC-SHA256 of several messages from the precomputed midstates of the key.
+ *
+ * Batch version of API_hmac_sha256_midstate, see API_hmac_sha256_many.
+ *
+ * @param midstate Midstates of the key (see API_hmac_sha256_precompute)
+ * @param data Array of pointers to the messages
+ * @param datalen Array with the length of each message
+ * @param nmsgs Number of messages
+ * @param out Array of pointers where the 32 bytes HMAC of each message will be stored
+ */
+void API_hmac_sha256_many_midstate(const HMAC_SHA256_MIDSTATE *midstate, unsigned char **data, const size_t *datalen, size_t nmsgs, unsigned char **out);
+
+/**
+ * @brief Computes the HMAC-SHA256 of several messages with the same key.
+ *
+ * Batch version of API_hmac_sha256. The key pads are compressed once (API_hmac_sha256_precompute), then the inner hashes of all the messages
+ * and afterwards their outer hashes are computed with the multi-buffer SHA-256 engine (CP_sha256_many), so
+ * 8 (AVX2) or 16 (AVX-512) messages advance in each pass. The messages may have different lengths.
+ * Only stack buffers are used.
+ *
+ * @param key HMAC key
+ * @param keylen HMAC key lenght
+ * @param data Array of pointers to the messages
+ * @param datalen Array with the length of each message
+ * @param nmsgs Number of messages
+ * @param out Array of pointers where the 32 bytes HMAC of each message will be stored
+ */
+void API_hmac_sha256_many(unsigned char *key, int keylen, unsigned char **data, const size_t *datalen, size_t nmsgs, unsigned char **out);
+
 /**
  * @brief This function concatenates key HMAC256_k and message m, then returns a SHA256 hash of the concatenation.
  * 
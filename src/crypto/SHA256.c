@@ -14,6 +14,21 @@
  ****************************************************************************************************************/
 SHA256_STRUCT SHA256_ctx;
 
+static SHA256_implementation SHA256_implement = sha256_still_to_check;
+
+static int SHA256_mb_lanes = 1; // messages per pass of the multi-buffer engine
+
+// State of a message hashed in one lane of the multi-buffer engine
+typedef struct CP_SHA256_MB_LANE
+{
+	const SHA256_BYTE *msg;
+	size_t full_blocks;	   // blocks read directly from the message
+	size_t nblocks;		   // full blocks and padded tail blocks
+	size_t block;		   // next block to compress
+	size_t index;		   // position of the message in the batch
+	SHA256_BYTE tail[128]; // last bytes of the message with the padding and the length, CSP
+} CP_SHA256_MB_LANE;
+
 // These 0 1 63 words represent the first thirty-two bits of the fractional parts of the cube roots of the first sixtyfour prime numbers.
 
 static const _INT32 k256[64] = {
@@ -32,7 +47,219 @@ static const _INT32 k256[64] = {
  * Function definition zone
  ****************************************************************************************************************/
 
-void CP_sha256_computation(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[])
+// function to check if the SHA extensions are supported
+int supportsSHANI()
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	__cpuid(1, eax, ebx, ecx, edx);
+	if ((ecx & (1 << 9)) == 0 || (ecx & (1 << 19)) == 0 || __get_cpuid_max(0, NULL) < 7) // SSSE3 and SSE4.1
+		return 0;
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return (ebx & (1 << 29)) != 0;
+}
+
+// function to check if AVX2 and BMI2 are supported and the YMM state is enabled by the OS
+static int CP_sha256_supportsAVX2_BMI2()
+{
+	unsigned int eax, ebx, ecx, edx;
+	unsigned int xcr0_lo, xcr0_hi;
+
+	__cpuid(1, eax, ebx, ecx, edx);
+	if ((ecx & (1 << 27)) == 0 || __get_cpuid_max(0, NULL) < 7) // OSXSAVE
+		return 0;
+	__asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+	if ((xcr0_lo & 0x6) != 0x6) // XMM and YMM states
+		return 0;
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return (ebx & (1 << 5)) && (ebx & (1 << 8));
+}
+
+// Lanes of 32 bits usable by the multi-buffer engine: 16 with AVX-512F, 8 with AVX2, 1 otherwise (OS support checked with XGETBV)
+static int CP_sha256_mb_check_lanes()
+{
+	unsigned int eax, ebx, ecx, edx;
+	unsigned int xcr0_lo, xcr0_hi;
+
+	__cpuid(1, eax, ebx, ecx, edx);
+	if ((ecx & (1 << 27)) == 0 || __get_cpuid_max(0, NULL) < 7) // OSXSAVE
+		return 1;
+	__asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+	if ((xcr0_lo & 0x6) != 0x6) // XMM and YMM states
+		return 1;
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	if ((ebx & (1 << 16)) && (xcr0_lo & 0xE0) == 0xE0) // AVX-512F and opmask/ZMM states
+		return 16;
+	if (ebx & (1 << 5)) // AVX2
+		return 8;
+	return 1;
+}
+
+int API_SHA256_checkHWsupport()
+{
+	if (supportsSHANI())
+		SHA256_implement = hardware_SHA_NI;
+	else
+		SHA256_implement = CP_sha256_supportsAVX2_BMI2() ? software_sha256_AVX2 : software_sha256;
+	SHA256_mb_lanes = CP_sha256_mb_check_lanes();
+	return SHA256_implement;
+}
+
+int API_SHA256_getMultiBufferLanes()
+{
+	return SHA256_mb_lanes;
+}
+
+SHA256_implementation API_SHA256_getImplementation()
+{
+	return SHA256_implement;
+}
+
+//////////////////////////////////////////// SHA-NI COMPRESSION //////////////////////////////////////////
+
+// Compresses nblocks consecutive 64 bytes blocks with the SHA extensions. SHA256RNDS2 does two rounds and works on
+// the state split as ABEF and CDGH, the message schedule is computed four words at a time with SHA256MSG1/MSG2
+__attribute__((target("sha,sse4.1,ssse3")))
+static void CP_sha256_shani_blocks(_INT32 state[8], const SHA256_BYTE *data, size_t nblocks)
+{
+	const __m128i byteswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i state0, state1, tmp, abef_save, cdgh_save, msg[4];
+
+	tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1); // CDAB
+	state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B); // EFGH
+	state0 = _mm_alignr_epi8(tmp, state1, 8);	 // ABEF
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+
+	for (; nblocks > 0; nblocks--, data += 64)
+	{
+		abef_save = state0;
+		cdgh_save = state1;
+
+		for (int j = 0; j < 4; j++)
+			msg[j] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * j)), byteswap);
+
+		// 16 groups of 4 rounds, msg[j & 3] holds the words 4j..4j+3 of the schedule
+		#pragma GCC unroll 16
+		for (int j = 0; j < 16; j++)
+		{
+			if (j >= 4)
+			{
+				tmp = _mm_sha256msg1_epu32(msg[j & 3], msg[(j - 3) & 3]);
+				tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(msg[(j - 1) & 3], msg[(j - 2) & 3], 4));
+				msg[j & 3] = _mm_sha256msg2_epu32(tmp, msg[(j - 1) & 3]);
+			}
+			tmp = _mm_add_epi32(msg[j & 3], _mm_loadu_si128((const __m128i *)&k256[4 * j]));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, tmp);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(tmp, 0x0E));
+		}
+
+		state0 = _mm_add_epi32(state0, abef_save);
+		state1 = _mm_add_epi32(state1, cdgh_save);
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1B);		 // FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xB1);	 // DCHG
+	state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+	state1 = _mm_alignr_epi8(state1, tmp, 8);	 // HGFE
+	_mm_storeu_si128((__m128i *)&state[0], state0);
+	_mm_storeu_si128((__m128i *)&state[4], state1);
+}
+
+//////////////////////////////////////////// AVX2 COMPRESSION //////////////////////////////////////////
+
+#define SHA256_AVX2_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+#define SHA256_AVX2_SIG0(x) _mm256_xor_si256(_mm256_xor_si256(SHA256_AVX2_ROTR(x, 7), SHA256_AVX2_ROTR(x, 18)), _mm256_srli_epi32(x, 3))
+
+#define SHA256_AVX2_SIG1(x) _mm256_xor_si256(_mm256_xor_si256(SHA256_AVX2_ROTR(x, 17), SHA256_AVX2_ROTR(x, 19)), _mm256_srli_epi32(x, 10))
+
+// Next 4 words of the schedule from the previous 16 (x0 oldest), each 128 bits lane works on a different block.
+// sigma1 needs the two words computed just before, so the 4 words are obtained in two halves
+__attribute__((target("avx2")))
+static __m256i CP_sha256_avx2_schedule(__m256i x0, __m256i x1, __m256i x2, __m256i x3)
+{
+	__m256i w15 = _mm256_alignr_epi8(x1, x0, 4); // W[t-15..t-12]
+	__m256i w7 = _mm256_alignr_epi8(x3, x2, 4);	 // W[t-7..t-4]
+	__m256i sum = _mm256_add_epi32(_mm256_add_epi32(x0, SHA256_AVX2_SIG0(w15)), w7);
+	__m256i lo = _mm256_add_epi32(sum, SHA256_AVX2_SIG1(_mm256_shuffle_epi32(x3, 0x0E)));	// W[t], W[t+1] in words 0 and 1
+	__m256i hi = _mm256_add_epi32(sum, SHA256_AVX2_SIG1(_mm256_shuffle_epi32(lo, 0x44))); // W[t+2], W[t+3] in words 2 and 3
+	return _mm256_blend_epi32(lo, hi, 0xCC);
+}
+
+// 64 rounds over precomputed W[i] + K[i], the rotations compile to RORX with BMI2
+__attribute__((target("bmi2")))
+static void CP_sha256_bmi2_rounds(_INT32 state[8], const _INT32 wk[64])
+{
+	_INT32 a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+	_INT32 t1, t2;
+
+	for (int i = 0; i < 64; i++)
+	{
+		t1 = h + SHA256_EP1(e) + SHA256_CH(e, f, g) + wk[i];
+		t2 = SHA256_EP0(a) + SHA256_MAJ(a, b, c);
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
+}
+
+// Compresses nblocks blocks, the message schedule of two blocks is computed ahead in the two lanes of the AVX2 registers
+__attribute__((target("avx2,bmi2")))
+static void CP_sha256_avx2_blocks(_INT32 state[8], const SHA256_BYTE *data, size_t nblocks)
+{
+	const __m256i byteswap = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL, 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	_INT32 wk[2][64] __attribute__((aligned(32))); // W + K of the two blocks, CSP
+	__m256i x[4];
+
+	while (nblocks > 0)
+	{
+		// Without a second block the first one is loaded in both lanes and the upper results are not used
+		const SHA256_BYTE *second = (nblocks > 1) ? data + 64 : data;
+
+		for (int j = 0; j < 4; j++)
+		{
+			__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(data + 16 * j))),
+											   _mm_loadu_si128((const __m128i *)(second + 16 * j)), 1);
+			x[j] = _mm256_shuffle_epi8(v, byteswap);
+		}
+
+		#pragma GCC unroll 16
+		for (int g = 0; g < 16; g++)
+		{
+			if (g >= 4)
+				x[g & 3] = CP_sha256_avx2_schedule(x[g & 3], x[(g + 1) & 3], x[(g + 2) & 3], x[(g + 3) & 3]);
+			__m256i wkv = _mm256_add_epi32(x[g & 3], _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)&k256[4 * g])));
+			_mm_store_si128((__m128i *)&wk[0][4 * g], _mm256_castsi256_si128(wkv));
+			_mm_store_si128((__m128i *)&wk[1][4 * g], _mm256_extracti128_si256(wkv, 1));
+		}
+
+		CP_sha256_bmi2_rounds(state, wk[0]);
+		if (nblocks == 1)
+			break;
+		CP_sha256_bmi2_rounds(state, wk[1]);
+		data += 128;
+		nblocks -= 2;
+	}
+	memset(wk, 0, sizeof(wk));
+}
+
+//////////////////////////////////////////// SOFTWARE COMPRESSION //////////////////////////////////////////
+
+static void CP_sha256_computation_soft(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[])
 {
 	_INT32 a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
 
@@ -74,6 +301,293 @@ void CP_sha256_computation(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[])
 	SHA256_ctx->temp_hash[7] += h;
 }
 
+void CP_sha256_computation(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[])
+{
+	CP_sha256_computation_blocks(SHA256_ctx, data, 1);
+}
+
+void CP_sha256_computation_blocks(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[], size_t nblocks)
+{
+	if (SHA256_implement == hardware_SHA_NI)
+	{
+		CP_sha256_shani_blocks(SHA256_ctx->temp_hash, data, nblocks); // the state stays in registers between blocks
+	}
+	else if (SHA256_implement == software_sha256_AVX2)
+	{
+		CP_sha256_avx2_blocks(SHA256_ctx->temp_hash, data, nblocks);
+	}
+	else
+	{
+		for (; nblocks > 0; nblocks--, data += 64)
+			CP_sha256_computation_soft(SHA256_ctx, data);
+	}
+}
+
+//////////////////////////////////////////// MULTI-BUFFER COMPRESSION //////////////////////////////////////////
+
+// Loads the 16 big-endian words of a block of every lane, word-major so each row is one vector of lanes
+static void CP_sha256_mb_load_words(_INT32 *words, int lanes, const SHA256_BYTE *const *blocks)
+{
+	for (int t = 0; t < 16; t++)
+		for (int l = 0; l < lanes; l++)
+		{
+			const SHA256_BYTE *p = blocks[l] + 4 * t;
+			words[t * lanes + l] = ((_INT32)p[0] << 24) | ((_INT32)p[1] << 16) | ((_INT32)p[2] << 8) | (_INT32)p[3];
+		}
+}
+
+#define SHA256_MB_AVX2_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+#define SHA256_MB_AVX2_XOR3(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+
+// One block of 8 messages, digest[i][l] is the word i of the state of lane l
+__attribute__((target("avx2")))
+static void CP_sha256_mb_avx2(_INT32 digest[8][SHA256_MB_MAX_LANES], const SHA256_BYTE *const *blocks)
+{
+	_INT32 words[16 * 8] __attribute__((aligned(32)));
+	__m256i w[16], a, b, c, d, e, f, g, h, t1, t2;
+
+	CP_sha256_mb_load_words(words, 8, blocks);
+	a = _mm256_loadu_si256((const __m256i *)digest[0]);
+	b = _mm256_loadu_si256((const __m256i *)digest[1]);
+	c = _mm256_loadu_si256((const __m256i *)digest[2]);
+	d = _mm256_loadu_si256((const __m256i *)digest[3]);
+	e = _mm256_loadu_si256((const __m256i *)digest[4]);
+	f = _mm256_loadu_si256((const __m256i *)digest[5]);
+	g = _mm256_loadu_si256((const __m256i *)digest[6]);
+	h = _mm256_loadu_si256((const __m256i *)digest[7]);
+
+	for (int i = 0; i < 64; i++)
+	{
+		if (i < 16)
+		{
+			w[i] = _mm256_load_si256((const __m256i *)&words[8 * i]);
+		}
+		else
+		{
+			__m256i w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+			__m256i sig0 = SHA256_MB_AVX2_XOR3(SHA256_MB_AVX2_ROTR(w15, 7), SHA256_MB_AVX2_ROTR(w15, 18), _mm256_srli_epi32(w15, 3));
+			__m256i sig1 = SHA256_MB_AVX2_XOR3(SHA256_MB_AVX2_ROTR(w2, 17), SHA256_MB_AVX2_ROTR(w2, 19), _mm256_srli_epi32(w2, 10));
+			w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], sig0), _mm256_add_epi32(w[(i - 7) & 15], sig1));
+		}
+		t1 = _mm256_add_epi32(h, SHA256_MB_AVX2_XOR3(SHA256_MB_AVX2_ROTR(e, 6), SHA256_MB_AVX2_ROTR(e, 11), SHA256_MB_AVX2_ROTR(e, 25)));
+		t1 = _mm256_add_epi32(t1, _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g)));
+		t1 = _mm256_add_epi32(t1, _mm256_add_epi32(_mm256_set1_epi32((int)k256[i]), w[i & 15]));
+		t2 = SHA256_MB_AVX2_XOR3(SHA256_MB_AVX2_ROTR(a, 2), SHA256_MB_AVX2_ROTR(a, 13), SHA256_MB_AVX2_ROTR(a, 22));
+		t2 = _mm256_add_epi32(t2, _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b))));
+		h = g;
+		g = f;
+		f = e;
+		e = _mm256_add_epi32(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = _mm256_add_epi32(t1, t2);
+	}
+
+	_mm256_storeu_si256((__m256i *)digest[0], _mm256_add_epi32(a, _mm256_loadu_si256((const __m256i *)digest[0])));
+	_mm256_storeu_si256((__m256i *)digest[1], _mm256_add_epi32(b, _mm256_loadu_si256((const __m256i *)digest[1])));
+	_mm256_storeu_si256((__m256i *)digest[2], _mm256_add_epi32(c, _mm256_loadu_si256((const __m256i *)digest[2])));
+	_mm256_storeu_si256((__m256i *)digest[3], _mm256_add_epi32(d, _mm256_loadu_si256((const __m256i *)digest[3])));
+	_mm256_storeu_si256((__m256i *)digest[4], _mm256_add_epi32(e, _mm256_loadu_si256((const __m256i *)digest[4])));
+	_mm256_storeu_si256((__m256i *)digest[5], _mm256_add_epi32(f, _mm256_loadu_si256((const __m256i *)digest[5])));
+	_mm256_storeu_si256((__m256i *)digest[6], _mm256_add_epi32(g, _mm256_loadu_si256((const __m256i *)digest[6])));
+	_mm256_storeu_si256((__m256i *)digest[7], _mm256_add_epi32(h, _mm256_loadu_si256((const __m256i *)digest[7])));
+	memset(words, 0, sizeof(words));
+}
+
+// One block of 16 messages, same as the AVX2 kernel with native rotations and three input logic instructions
+__attribute__((target("avx512f")))
+static void CP_sha256_mb_avx512(_INT32 digest[8][SHA256_MB_MAX_LANES], const SHA256_BYTE *const *blocks)
+{
+	_INT32 words[16 * 16] __attribute__((aligned(64)));
+	__m512i w[16], s[8], t1, t2;
+
+	CP_sha256_mb_load_words(words, 16, blocks);
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm512_loadu_si512((const void *)digest[i]);
+	__m512i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+	for (int i = 0; i < 64; i++)
+	{
+		if (i < 16)
+		{
+			w[i] = _mm512_load_si512((const void *)&words[16 * i]);
+		}
+		else
+		{
+			__m512i w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+			__m512i sig0 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(w15, 7), _mm512_ror_epi32(w15, 18), _mm512_srli_epi32(w15, 3), 0x96);
+			__m512i sig1 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(w2, 17), _mm512_ror_epi32(w2, 19), _mm512_srli_epi32(w2, 10), 0x96);
+			w[i & 15] = _mm512_add_epi32(_mm512_add_epi32(w[i & 15], sig0), _mm512_add_epi32(w[(i - 7) & 15], sig1));
+		}
+		t1 = _mm512_add_epi32(h, _mm512_ternarylogic_epi32(_mm512_ror_epi32(e, 6), _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25), 0x96));
+		t1 = _mm512_add_epi32(t1, _mm512_ternarylogic_epi32(e, f, g, 0xCA)); // CH
+		t1 = _mm512_add_epi32(t1, _mm512_add_epi32(_mm512_set1_epi32((int)k256[i]), w[i & 15]));
+		t2 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(a, 2), _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22), 0x96);
+		t2 = _mm512_add_epi32(t2, _mm512_ternarylogic_epi32(a, b, c, 0xE8)); // MAJ
+		h = g;
+		g = f;
+		f = e;
+		e = _mm512_add_epi32(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = _mm512_add_epi32(t1, t2);
+	}
+
+	s[0] = _mm512_add_epi32(s[0], a);
+	s[1] = _mm512_add_epi32(s[1], b);
+	s[2] = _mm512_add_epi32(s[2], c);
+	s[3] = _mm512_add_epi32(s[3], d);
+	s[4] = _mm512_add_epi32(s[4], e);
+	s[5] = _mm512_add_epi32(s[5], f);
+	s[6] = _mm512_add_epi32(s[6], g);
+	s[7] = _mm512_add_epi32(s[7], h);
+	for (int i = 0; i < 8; i++)
+		_mm512_storeu_si512((void *)digest[i], s[i]);
+	memset(words, 0, sizeof(words));
+}
+
+// Next block of a lane, from the message or from the padded tail
+static const SHA256_BYTE *CP_sha256_mb_lane_block(const CP_SHA256_MB_LANE *lane)
+{
+	if (lane->block < lane->full_blocks)
+		return lane->msg + 64 * lane->block;
+	return lane->tail + 64 * (lane->block - lane->full_blocks);
+}
+
+// Puts a message in a lane: the state starts at init_state and the tail is padded with the length of prefix and message
+static void CP_sha256_mb_lane_start(CP_SHA256_MB_LANE *lane, _INT32 digest[8][SHA256_MB_MAX_LANES], int l, const _INT32 init_state[8], unsigned long long prefix_len, const SHA256_BYTE *msg, size_t length, size_t index)
+{
+	size_t rest = length % 64;
+	size_t tail_blocks = (rest < 56) ? 1 : 2;
+	unsigned long long bitlen = (prefix_len + length) * 8;
+
+	for (int i = 0; i < 8; i++)
+		digest[i][l] = init_state[i];
+	lane->msg = msg;
+	lane->full_blocks = length / 64;
+	lane->nblocks = lane->full_blocks + tail_blocks;
+	lane->block = 0;
+	lane->index = index;
+	memset(lane->tail, 0, sizeof(lane->tail));
+	memcpy(lane->tail, msg + 64 * lane->full_blocks, rest);
+	lane->tail[rest] = 0x80;
+	for (int i = 0; i < 8; i++)
+		lane->tail[64 * tail_blocks - 1 - i] = (SHA256_BYTE)(bitlen >> (8 * i));
+}
+
+static void CP_sha256_mb_store_digest(const _INT32 state[8], unsigned char *out)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		out[4 * i] = (unsigned char)(state[i] >> 24);
+		out[4 * i + 1] = (unsigned char)(state[i] >> 16);
+		out[4 * i + 2] = (unsigned char)(state[i] >> 8);
+		out[4 * i + 3] = (unsigned char)state[i];
+	}
+}
+
+void CP_sha256_many(const _INT32 init_state[8], unsigned long long prefix_len, unsigned char **msgs, const size_t *lengths, size_t nmsgs, unsigned char **out)
+{
+	static const SHA256_BYTE idle_block[64] = {0};
+	_INT32 digest[8][SHA256_MB_MAX_LANES] __attribute__((aligned(64))); // CSP
+	CP_SHA256_MB_LANE lane[SHA256_MB_MAX_LANES];
+	const SHA256_BYTE *blocks[SHA256_MB_MAX_LANES];
+	int lanes = SHA256_mb_lanes;
+	int active = 0;
+	size_t next = 0;
+	SHA256_STRUCT ctx;
+
+	if (lanes == 1)
+	{
+		// No vector lanes, the messages are hashed one after the other
+		for (size_t i = 0; i < nmsgs; i++)
+		{
+			memcpy(ctx.temp_hash, init_state, sizeof(ctx.temp_hash));
+			ctx.datalen = 0;
+			ctx.bitlen = prefix_len * 8;
+			CP_sha256_update(&ctx, msgs[i], lengths[i]);
+			CP_sha256_final(&ctx, out[i]);
+		}
+		memset(&ctx, 0, sizeof(ctx));
+		return;
+	}
+
+	for (int l = 0; l < lanes; l++)
+	{
+		lane[l].msg = NULL;
+		if (next < nmsgs)
+		{
+			CP_sha256_mb_lane_start(&lane[l], digest, l, init_state, prefix_len, msgs[next], lengths[next], next);
+			next++;
+			active++;
+		}
+	}
+
+	while (active > 0)
+	{
+		// A single message left, it is finished with the single buffer compression (SHA-NI if available)
+		if (active == 1 && next == nmsgs)
+		{
+			for (int l = 0; l < lanes; l++)
+			{
+				if (lane[l].msg == NULL)
+					continue;
+				for (int i = 0; i < 8; i++)
+					ctx.temp_hash[i] = digest[i][l];
+				if (lane[l].block < lane[l].full_blocks)
+				{
+					CP_sha256_computation_blocks(&ctx, CP_sha256_mb_lane_block(&lane[l]), lane[l].full_blocks - lane[l].block);
+					lane[l].block = lane[l].full_blocks;
+				}
+				CP_sha256_computation_blocks(&ctx, CP_sha256_mb_lane_block(&lane[l]), lane[l].nblocks - lane[l].block);
+				CP_sha256_mb_store_digest(ctx.temp_hash, out[lane[l].index]);
+			}
+			break;
+		}
+
+		for (int l = 0; l < lanes; l++)
+			blocks[l] = (lane[l].msg != NULL) ? CP_sha256_mb_lane_block(&lane[l]) : idle_block;
+		if (lanes == 16)
+			CP_sha256_mb_avx512(digest, blocks);
+		else
+			CP_sha256_mb_avx2(digest, blocks);
+
+		// Finished messages leave their lane to the next message of the batch
+		for (int l = 0; l < lanes; l++)
+		{
+			if (lane[l].msg == NULL || ++lane[l].block < lane[l].nblocks)
+				continue;
+			_INT32 state[8];
+			for (int i = 0; i < 8; i++)
+				state[i] = digest[i][l];
+			CP_sha256_mb_store_digest(state, out[lane[l].index]);
+			lane[l].msg = NULL;
+			active--;
+			if (next < nmsgs)
+			{
+				CP_sha256_mb_lane_start(&lane[l], digest, l, init_state, prefix_len, msgs[next], lengths[next], next);
+				next++;
+				active++;
+			}
+		}
+	}
+
+	memset(digest, 0, sizeof(digest));
+	memset(lane, 0, sizeof(lane));
+	memset(&ctx, 0, sizeof(ctx));
+}
+
+void API_sha256_many(unsigned char **msgs, const size_t *lengths, size_t nmsgs, unsigned char **out)
+{
+	SHA256_STRUCT ctx;
+
+	CP_sha256_init(&ctx);
+	CP_sha256_many(ctx.temp_hash, 0, msgs, lengths, nmsgs, out);
+}
+
 void CP_sha256_init(SHA256_STRUCT *SHA256_ctx)
 {
 	// These words were obtained by taking the first thirty-two bits of the fractional parts of the square roots of the first eight prime numbers.
@@ -92,21 +606,38 @@ void CP_sha256_init(SHA256_STRUCT *SHA256_ctx)
 
 void CP_sha256_update(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[], size_t len)
 {
-	_INT32 i;
+	size_t nblocks;
 
-	// INTRODUCE OUR DATA INTO THE 512bits CHUNK, IF THE CHUNK IS COMPLETED, WE COMPUTE IT
+	// Complete the buffered partial block first
+	if (SHA256_ctx->datalen > 0)
+	{
+		size_t fill = 64 - SHA256_ctx->datalen;
+		if (fill > len)
+			fill = len;
+		memcpy(SHA256_ctx->data + SHA256_ctx->datalen, data, fill);
+		SHA256_ctx->datalen += fill;
+		data += fill;
+		len -= fill;
+		if (SHA256_ctx->datalen < 64)
+			return;
+		CP_sha256_computation(SHA256_ctx, SHA256_ctx->data);
+		SHA256_ctx->bitlen += 512;
+		SHA256_ctx->datalen = 0;
+	}
 
-	for (i = 0; i < len; ++i)
+	// Whole blocks are compressed directly from the caller buffer
+	nblocks = len / 64;
+	if (nblocks > 0)
 	{
-		SHA256_ctx->data[SHA256_ctx->datalen] = data[i];
-		SHA256_ctx->datalen++;
-		if (SHA256_ctx->datalen == 64)
-		{
-			CP_sha256_computation(SHA256_ctx, SHA256_ctx->data);
-			SHA256_ctx->bitlen += 512;
-			SHA256_ctx->datalen = 0;
-		}
+		CP_sha256_computation_blocks(SHA256_ctx, data, nblocks);
+		SHA256_ctx->bitlen += 512 * (unsigned long long)nblocks;
+		data += 64 * nblocks;
+		len -= 64 * nblocks;
 	}
+
+	// Keep the rest for the next update or the final padding
+	memcpy(SHA256_ctx->data, data, len);
+	SHA256_ctx->datalen = len;
 }
 
 void CP_sha256_final(SHA256_STRUCT *SHA256_ctx, SHA256_BYTE hash[])
@@ -15,6 +15,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <memory.h>
+#include <cpuid.h>
+#include <immintrin.h>
 
 
 /****************************************************************************************************************
@@ -87,6 +89,17 @@ typedef struct
     _INT32 temp_hash[8]; /**< Temporal hash performed */
 } SHA256_STRUCT;
 
+/**
+ * @brief SHA-256 compression implementations, selected once by API_SHA256_checkHWsupport
+ */
+typedef enum SHA256_implementation
+{
+    sha256_still_to_check, /**< Initial state, yet to be checked (the software compression is used) */
+    software_sha256,       /**< Portable C compression function */
+    software_sha256_AVX2,  /**< Message schedule of two blocks at a time in AVX2, rounds with BMI2 rotations (RORX) */
+    hardware_SHA_NI,       /**< Intel SHA extensions (SHA256RNDS2, SHA256MSG1, SHA256MSG2) */
+} SHA256_implementation;
+
 /* Global variables definition ...................................... */
 
 /**
@@ -109,6 +122,11 @@ typedef struct
  */
 #define SHA256_BLOCK_SIZE 32 
 
+/**
+ * @brief Maximum number of messages hashed in parallel by API_sha256_many (16 lanes of 32 bits in an AVX-512 register)
+ */
+#define SHA256_MB_MAX_LANES 16
+
 extern SHA256_STRUCT SHA256_ctx; // CSP
 
 /****************************************************************************************************************
@@ -133,9 +151,9 @@ void CP_sha256_init(SHA256_STRUCT *SHA256_ctx);
 /**
  * @brief Updates the SHA-256 context with new data.
  *
- * This function takes new data and adds it to the SHA-256 context. If a 512-bit chunk is
- * completed, it is processed using the SHA-256 computation function. The function manages
- * the data buffer and keeps track of the length of the data and bit length.
+ * This function takes new data and adds it to the SHA-256 context. Only partial 512-bit chunks are
+ * copied to the context buffer, the whole chunks of the input are processed directly from the caller
+ * buffer with CP_sha256_computation_blocks. The function keeps track of the length of the data and bit length.
  *
  * @param SHA256_ctx [in, out] Pointer to a SHA256_STRUCT that holds the current state of the hash computation.
  * @param data [in] Pointer to the data to be added to the hash.
@@ -150,7 +168,7 @@ void CP_sha256_update(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[], size_
  * This function processes a 512-bit chunk of data using the SHA-256 algorithm and updates the
  * intermediate hash values stored in the provided SHA256_STRUCT. The chunk is expanded into
  * 64 words, and the hash computation is performed in 64 rounds as specified by the SHA-256
- * algorithm.
+ * algorithm. The SHA extensions are used when API_SHA256_checkHWsupport has selected `hardware_SHA_NI`.
  *
  * @param SHA256_ctx [in, out] Pointer to a SHA256_STRUCT that holds the current state of the hash computation.
  * @param data [in] Pointer to the 512-bit chunk of data to be processed.
@@ -158,6 +176,48 @@ void CP_sha256_update(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[], size_
 
 void CP_sha256_computation(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[]);
 
+/**
+ * @brief Computes the SHA-256 hash for several consecutive 512-bit chunks of data.
+ *
+ * Multi-block entry point of the compression function, used by CP_sha256_update for the whole blocks of the
+ * input. The SHA-NI backend keeps the state in registers across the blocks, the software backend compresses
+ * them one by one. A new backend only needs to be dispatched here.
+ *
+ * @param SHA256_ctx [in, out] Pointer to a SHA256_STRUCT that holds the current state of the hash computation.
+ * @param data [in] Pointer to the chunks of data to be processed (nblocks * 64 bytes, no alignment required).
+ * @param nblocks [in] Number of 512-bit chunks.
+ */
+
+void CP_sha256_computation_blocks(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[], size_t nblocks);
+
+/**
+ * @brief Function to check if the Intel SHA extensions are supported in this machine core.
+ *
+ * This function uses the CPUID instruction to check the SHA bit (leaf 7, EBX bit 29), and the SSSE3 and SSE4.1
+ * bits used to load the message and to arrange the state for the SHA256RNDS2 instruction.
+ *
+ * @return Returns 1 if the SHA extensions can be used, 0 otherwise.
+ */
+int supportsSHANI();
+
+/**
+ * @brief Function to check hardware support for the SHA extensions and set the SHA-256 implementation
+ *
+ * Sets the compression function used by CP_sha256_computation to `hardware_SHA_NI` if `supportsSHANI` reports
+ * it, to `software_sha256_AVX2` if AVX2 and BMI2 are available, and to `software_sha256` otherwise. Called once
+ * during the module initialization, like API_AES_checkHWsupport.
+ *
+ * @return The SHA-256 implementation selected.
+ */
+int API_SHA256_checkHWsupport();
+
+/**
+ * @brief Returns the SHA-256 implementation selected by API_SHA256_checkHWsupport
+ *
+ * @return The SHA-256 implementation being used (sha256_still_to_check if API_SHA256_checkHWsupport was not called yet)
+ */
+SHA256_implementation API_SHA256_getImplementation();
+
 /**
  * @brief Finalizes the SHA-256 hash computation and produces the final hash value.
  *
@@ -171,6 +231,43 @@ void CP_sha256_computation(SHA256_STRUCT *SHA256_ctx, const SHA256_BYTE data[]);
 
 void CP_sha256_final(SHA256_STRUCT *SHA256_ctx, SHA256_BYTE hash[]);
 
+/**
+ * @brief Returns the number of messages hashed in parallel by API_sha256_many in this machine.
+ *
+ * @return 16 with AVX-512, 8 with AVX2, 1 otherwise (the messages are hashed one after the other). Set by API_SHA256_checkHWsupport.
+ */
+int API_SHA256_getMultiBufferLanes();
+
+/**
+ * @brief Multi-buffer SHA-256 engine, hashes several independent messages that continue a common prefix.
+ *
+ * Every lane of the vector registers holds the state of a different message, so one pass of the compression
+ * function processes one block of API_SHA256_getMultiBufferLanes() messages. When a message ends its lane is
+ * refilled with the next one, so messages of different lengths can be mixed. When a single message remains it is
+ * finished with CP_sha256_computation.
+ *
+ * @param init_state [in] Hash state after the common prefix (the SHA-256 initial values if there is no prefix).
+ * @param prefix_len [in] Length of the common prefix in bytes, a multiple of 64, counted in the padding of every message.
+ * @param msgs [in] Array of pointers to the messages.
+ * @param lengths [in] Array with the length of each message in bytes.
+ * @param nmsgs [in] Number of messages.
+ * @param out [out] Array of pointers where the 32 bytes hash of each message is stored. out[i] may be msgs[i] if lengths[i] < 56.
+ */
+void CP_sha256_many(const _INT32 init_state[8], unsigned long long prefix_len, unsigned char **msgs, const size_t *lengths, size_t nmsgs, unsigned char **out);
+
+/**
+ * @brief Computes the SHA-256 hash of several independent messages.
+ *
+ * Batch version of API_sha256, the messages are hashed in parallel with the multi-buffer engine (8 messages per
+ * AVX2 pass, 16 per AVX-512 pass). The messages may have different lengths.
+ *
+ * @param msgs [in] Array of pointers to the messages.
+ * @param lengths [in] Array with the length of each message in bytes.
+ * @param nmsgs [in] Number of messages.
+ * @param out [out] Array of pointers where the 32 bytes hash of each message will be stored.
+ */
+void API_sha256_many(unsigned char **msgs, const size_t *lengths, size_t nmsgs, unsigned char **out);
+
 /**
  * @brief Computes the SHA-256 hash of a message.
  *
@@ -29,6 +29,17 @@ int API_CP_hmac_sha256(unsigned char *msg, unsigned char *key, size_t datalen, s
 	return 1;
 }
 
+int API_CP_verify_HMAC_SHA256_midstate(const unsigned char *msg, HMAC_SHA256_MIDSTATE const *midstate, const unsigned char *sign, size_t length_msg, size_t length_sign, uint8_t *result)
+{
+	*result = API_verify_HMAC_midstate(midstate, msg, sign, length_msg, length_sign);
+	return 1;
+}
+int API_CP_hmac_sha256_midstate(const unsigned char *msg, HMAC_SHA256_MIDSTATE const *midstate, size_t datalen, unsigned char *result)
+{
+	API_hmac_sha256_midstate(midstate, msg, datalen, result);
+	return 1;
+}
+
 int API_CP_ECDSA256_sign(unsigned char p_privateKey[ECC_BYTES], unsigned char *msg, size_t msg_length, unsigned char p_signature[ECC_BYTES * 2])
 {
 	unsigned char hash[32];
@@ -97,6 +108,28 @@ int API_CP_AESCBC_decrypt(unsigned char *ciphertext, size_t *len, unsigned char
 
 	int padding = CP_getPaddingLength(plaintext, *len);
 
+	if (padding != -1)
+		*len -= padding;
+
+	return 1;
+}
+
+int API_CP_AESCBC_encrypt_ctx(AesContext const *ctx, unsigned char *plaintext, size_t *len, unsigned char *iv, unsigned char *ciphertext)
+{
+	// updates length if padding is required
+	CP_addPaddingAes(plaintext, len, plaintext);
+	//just encrypt with CBC mode, the key is already expanded
+	API_AESCBC_encrypt_ctx(ctx, plaintext, *len, iv, ciphertext);
+
+	return 1;
+}
+
+int API_CP_AESCBC_decrypt_ctx(AesContext const *ctx, unsigned char *ciphertext, size_t *len, unsigned char *iv, unsigned char *plaintext)
+{
+	API_AESCBC_decrypt_ctx(ctx, ciphertext, *len, iv, plaintext);
+
+	int padding = CP_getPaddingLength(plaintext, *len);
+
 	if (padding != -1)
 		*len -= padding;
 
@@ -74,6 +74,32 @@ int API_CP_verify_HMAC_SHA256(unsigned char *msg, unsigned char *key, unsigned c
  */
 int API_CP_hmac_sha256(unsigned char* msg, unsigned char* key, size_t datalen, size_t length_key , unsigned char **result);
 
+/**
+ * @brief Verifies the HMAC-SHA256 signature of a message from the precomputed midstates of the key.
+ *
+ * @param msg Pointer to the message data.
+ * @param midstate Midstates of the HMAC key (see API_hmac_sha256_precompute).
+ * @param sign Pointer to the signature to verify.
+ * @param length_msg Length of the message in bytes.
+ * @param length_sign Length of the signature in bytes.
+ * @param result Pointer to store the verification result (1 if successful, 0 if not).
+ *
+ * @return 1 on success.
+ */
+int API_CP_verify_HMAC_SHA256_midstate(const unsigned char *msg, HMAC_SHA256_MIDSTATE const *midstate, const unsigned char *sign, size_t length_msg, size_t length_sign, uint8_t *result);
+
+/**
+ * @brief Computes the HMAC-SHA256 of a message from the precomputed midstates of the key.
+ *
+ * @param msg Pointer to the message data.
+ * @param midstate Midstates of the HMAC key (see API_hmac_sha256_precompute).
+ * @param datalen Length of the message in bytes.
+ * @param result Buffer of HMAC_SHA256_SIGN_SIZE bytes where the HMAC is stored.
+ *
+ * @return 1 on success.
+ */
+int API_CP_hmac_sha256_midstate(const unsigned char *msg, HMAC_SHA256_MIDSTATE const *midstate, size_t datalen, unsigned char *result);
+
 /**
  * @brief Verifies an ECDSA-256 signature.
  *
@@ -153,4 +179,30 @@ int API_CP_AESCBC_encrypt(unsigned char *plaintext, size_t *len, unsigned char *
  */
 int API_CP_AESCBC_decrypt(unsigned char *ciphertext, size_t *len, unsigned char *key, unsigned int AES_KEY_SIZE, unsigned char *iv, unsigned char *plaintext);
 
+/**
+ * @brief Encrypts a plaintext message using AES-CBC mode and PKCS7 padding with an already expanded key
+ *
+ * @param ctx AES context initialized with API_AES_initkey (key schedule handle).
+ * @param plaintext Pointer to the plaintext buffer, must have room for the padding.
+ * @param len Pointer to the length of the plaintext, updated with the padded length.
+ * @param iv Pointer to the initialization vector (IV) for CBC mode.
+ * @param ciphertext Pointer to the buffer to store the resulting ciphertext.
+ *
+ * @return 1 on success.
+ */
+int API_CP_AESCBC_encrypt_ctx(AesContext const *ctx, unsigned char *plaintext, size_t *len, unsigned char *iv, unsigned char *ciphertext);
+
+/**
+ * @brief Decrypts a ciphertext message using AES-CBC mode and PKCS7 padding with an already expanded key
+ *
+ * @param ctx AES context initialized with API_AES_initkey (key schedule handle).
+ * @param ciphertext Pointer to the ciphertext buffer.
+ * @param len Pointer to the length of the ciphertext (multiple of 16 bytes), updated without the padding.
+ * @param iv Pointer to the initialization vector (IV) for CBC mode.
+ * @param plaintext Pointer to the buffer to store the resulting plaintext.
+ *
+ * @return 1 on success.
+ */
+int API_CP_AESCBC_decrypt_ctx(AesContext const *ctx, unsigned char *ciphertext, size_t *len, unsigned char *iv, unsigned char *plaintext);
+
 #endif
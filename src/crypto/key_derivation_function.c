@@ -19,6 +19,17 @@ const unsigned char constant2[HASH_SIZE] = {
     0xaa, 0x23, 0x39, 0x94, 0xd2, 0x4f, 0xc8, 0x81, 0x6e, 0x5b, 0x90, 0xef, 0x37, 0x63, 0xd1, 0x7f
 };
 
+// Constants of the AEAD packet suite keys, each of 32 bytes (256 bits)
+const unsigned char constant3[HASH_SIZE] = {
+    0x5e, 0x97, 0x0b, 0xd4, 0x3a, 0x68, 0xf1, 0x2c, 0xc6, 0x81, 0x4d, 0xb9, 0x07, 0xe3, 0x76, 0x5a,
+    0x93, 0x2f, 0xd8, 0x64, 0xab, 0x1e, 0x50, 0xcf, 0x38, 0x86, 0xe5, 0x0d, 0x7c, 0xb4, 0x29, 0xf6
+};
+
+const unsigned char constant4[HASH_SIZE] = {
+    0xc4, 0x0e, 0x72, 0x9b, 0xe8, 0x35, 0x5d, 0xa1, 0x16, 0xfb, 0x83, 0x4c, 0xd7, 0x20, 0x9e, 0x67,
+    0x3b, 0xa9, 0xf5, 0x08, 0x61, 0xcc, 0x27, 0x94, 0xed, 0x52, 0x1a, 0x8f, 0xb6, 0x43, 0x7d, 0xe0
+};
+
 void API_KDF_derive_complex_key(uint8_t input_key[32], uint8_t derived_key_cipher[32], uint8_t derived_key_auth[32]) {
     
     // Step 1: Derive cipher key by concatenating input_key and constant1, then applying SHA-256
@@ -30,4 +41,17 @@ void API_KDF_derive_complex_key(uint8_t input_key[32], uint8_t derived_key_ciphe
     memcpy(kdf_buffer, input_key, HASH_SIZE);        
     memcpy(kdf_buffer + HASH_SIZE, constant2, HASH_SIZE);  
     API_sha256(kdf_buffer, HASH_SIZE * 2, derived_key_auth);  // Hash the concatenation to produce the auth key (32 bytes)
+}
+
+void API_KDF_derive_suite_keys(uint8_t input_key[32], uint8_t derived_key_gcm[32], uint8_t derived_key_chacha[32]) {
+
+    // AES-GCM key, SHA-256 of input_key and constant3
+    memcpy(kdf_buffer, input_key, HASH_SIZE);
+    memcpy(kdf_buffer + HASH_SIZE, constant3, HASH_SIZE);
+    API_sha256(kdf_buffer, HASH_SIZE * 2, derived_key_gcm);
+
+    // ChaCha20-Poly1305 key, SHA-256 of input_key and constant4
+    memcpy(kdf_buffer, input_key, HASH_SIZE);
+    memcpy(kdf_buffer + HASH_SIZE, constant4, HASH_SIZE);
+    API_sha256(kdf_buffer, HASH_SIZE * 2, derived_key_chacha);
 }
\ No newline at end of file
@@ -34,4 +34,14 @@
 
 void API_KDF_derive_complex_key(uint8_t input_key[32], uint8_t derived_key_cipher[32], uint8_t derived_key_auth[32]) ;
 
+/**
+ * Derive the keys of the AEAD packet suites from an input key using predefined constants, the same way as
+ * API_KDF_derive_complex_key, so no key is shared between two algorithms.
+ * 
+ * @param input_key: The original key or master key input (32 bytes).
+ * @param derived_key_gcm: A pointer to store the derived key used for AES-GCM (32 bytes).
+ * @param derived_key_chacha: A pointer to store the derived key used for ChaCha20-Poly1305 (32 bytes).
+ */
+void API_KDF_derive_suite_keys(uint8_t input_key[32], uint8_t derived_key_gcm[32], uint8_t derived_key_chacha[32]);
+
 #endif
\ No newline at end of file
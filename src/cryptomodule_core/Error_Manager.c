@@ -82,6 +82,7 @@ void API_EM_zeroize_entire_module() {
     uint8_t previus_state = 2;
     int result = API_FS_update_file_data(CONF_FILENAME,strlen(CONF_FILENAME),&previus_state,sizeof(u_int8_t));
 
+    API_ECDSA_nonce_pool_stop();     /**< Stop the nonce pool thread so it does not refill the pool after the zeroization. */
     API_MT_zeroize_and_free_all();   /**< Zeroize and free all memory tracked by the memory tracker. */
     API_MM_Zeroize_root();           /**< Zeroize the entire memory management tree. */
     API_FS_zeroize_file_system();    /**< Zeroize and wipe the file system. */
@@ -119,6 +120,9 @@ const char* API_EM_get_error_message(int error_code) {
         [SFT_AES256_CBC_SELFTEST_FAILED + 2010] = "AES256CBC Self-test FAILED",
         [SFT_AES256_OFB_SELFTEST_FAILED + 2010] = "AES256OFB Self-test FAILED",
         [SFT_MODULE_INTEGRITY_SELFTEST_FAILED + 2010] = "MODULE INTEGRITY Self-test FAILED",
+        [SFT_AES256_CTR_SELFTEST_FAILED + 2010] = "AES256CTR Self-test FAILED",
+        [SFT_AES256_GCM_SELFTEST_FAILED + 2010] = "AES256GCM Self-test FAILED",
+        [SFT_CHACHA20_POLY1305_SELFTEST_FAILED + 2010] = "CHACHA20-POLY1305 Self-test FAILED",
         [INIT_INCORRECT_TRACKER_INIT + 2010] = "Incorrect tracker initialization",
         [INIT_INCORRECT_KEYFILE_PATH + 2010] = "Incorrect keyfile path",
         [INIT_INCORRECT_KEYFILE_FORMAT + 2010] = "Incorrect keyfile format",
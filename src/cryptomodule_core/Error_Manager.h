@@ -65,6 +65,9 @@
 #define SFT_AES256_CBC_SELFTEST_FAILED -1604
 #define SFT_AES256_OFB_SELFTEST_FAILED -1605
 #define SFT_MODULE_INTEGRITY_SELFTEST_FAILED -1606
+#define SFT_AES256_CTR_SELFTEST_FAILED -1607
+#define SFT_AES256_GCM_SELFTEST_FAILED -1608
+#define SFT_CHACHA20_POLY1305_SELFTEST_FAILED -1609
 #define INIT_INCORRECT_TRACKER_INIT -1700
 #define INIT_INCORRECT_KEYFILE_PATH -1701
 #define INIT_INCORRECT_KEYFILE_FORMAT -1702
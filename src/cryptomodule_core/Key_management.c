@@ -6,6 +6,8 @@
 #include "Key_management.h"
 
 current_key_in_use Current_key_in_use = {.IsLoaded = 0};
+AesContext Current_key_AES_ctx; // expanded cipher key of the key in use, CSP!
+AesContext Current_key_GCM_ctx; // expanded AES-GCM key of the key in use, CSP!
 const char *Keyname_initial = "KEY_ID:";
 
 
@@ -84,13 +86,30 @@ int API_KM_loadkey(unsigned char *Key_id, size_t Key_id_length)
 
 	// Derive complex keys from the main key
 	API_KDF_derive_complex_key(Current_key_in_use.Main_key, Current_key_in_use.Cipher_key, Current_key_in_use.Auth_key);
+	// and one key per AEAD suite, no key is used by two algorithms
+	API_KDF_derive_suite_keys(Current_key_in_use.Main_key, Current_key_in_use.GCM_key, Current_key_in_use.ChaCha_key);
 
 	// Store the key name in the current key structure
 	memcpy(Current_key_in_use.keyname, Key_id, Key_id_length);
 
+	// Expand the cipher key once, every packet reuses this key schedule
+	API_AES_initkey(&Current_key_AES_ctx, Current_key_in_use.Cipher_key, AES_KEY_SIZE_256);
+	API_AES_initkey(&Current_key_GCM_ctx, Current_key_in_use.GCM_key, AES_KEY_SIZE_256);
+	// Compress the HMAC pads once, every packet signature starts from these midstates
+	API_hmac_sha256_precompute(Current_key_in_use.Auth_key, HMAC_SHA256_KEY_SIZE, &Current_key_in_use.Auth_midstate);
+	Current_key_in_use.Packet_suite = API_PCA_default_suite(); // ChaCha20-Poly1305 if AES is computed in software
+
 	// Update the memory tracker for the current key in use
 	Current_key_in_use.IsLoaded = 1;
 	result = API_MT_update_tracker(&MT_trackers[TI_Current_Key_In_Use]);
+	if (result == MT_OK)
+	{
+		result = API_MT_update_tracker(&MT_trackers[TI_Current_Key_AES_ctx]);
+	}
+	if (result == MT_OK)
+	{
+		result = API_MT_update_tracker(&MT_trackers[TI_Current_Key_GCM_ctx]);
+	}
 	if (result != MT_OK)
 	{
 		Current_key_in_use.IsLoaded = 0;
@@ -127,8 +146,45 @@ int API_KM_delete_key(unsigned char *Key_id, size_t Key_id_length)
     }
     if(memcmp(Key_id,Current_key_in_use.keyname,Key_id_length) == 0){
 	API_MM_secure_zeroize(&Current_key_in_use,sizeof(Current_key_in_use));
+	API_MM_secure_zeroize(&Current_key_AES_ctx,sizeof(Current_key_AES_ctx));
+	API_MM_secure_zeroize(&Current_key_GCM_ctx,sizeof(Current_key_GCM_ctx));
 	Current_key_in_use.IsLoaded = 0;
     }
 
     return KM_OK;
 }
+
+int API_KM_set_packet_suite(uint8_t suite)
+{
+	// Check if the current state is CSP, required for key management operations
+	if (API_SM_get_current_state() != STATE_CSP)
+	{
+		return SM_ERROR_STATE;
+	}
+
+	// Validate input parameters
+	if (!API_PCA_is_valid_suite(suite))
+	{
+		return KM_PARAMETERS_ERROR;
+	}
+	if (Current_key_in_use.IsLoaded == 0)
+	{
+		return KM_KEY_NOT_LOADED;
+	}
+
+	// Verify the key in use before it is hashed again, a corrupted key must not be taken as valid
+	int result = API_MT_verify_integrity(&MT_trackers[TI_Current_Key_In_Use]);
+	if (result != MT_OK)
+	{
+		return result;
+	}
+
+	// Change the suite and update the memory tracker of the current key in use
+	Current_key_in_use.Packet_suite = suite;
+	result = API_MT_update_tracker(&MT_trackers[TI_Current_Key_In_Use]);
+	if (result != MT_OK)
+	{
+		return result;
+	}
+	return KM_OK;
+}
@@ -21,6 +21,7 @@
 #include "../state_machine/State_Machine.h"
 #include "../secure_memory_management/file_system.h"
 #include "../crypto/AES_CORE.h"
+#include "../crypto/HMAC_SHA256.h"
 #include "../crypto/key_derivation_function.h"
 #include "../secure_memory_management/MemoryTracker.h"
 #include "module_initialization.h"
@@ -40,12 +41,19 @@ typedef struct current_key_in_use{
 	uint8_t Main_key[32];
 	uint8_t Cipher_key[32];
 	uint8_t Auth_key[32];
+	uint8_t GCM_key[32];    // AES-GCM packet suite key, derived by API_KM_loadkey
+	uint8_t ChaCha_key[32]; // ChaCha20-Poly1305 packet suite key, derived by API_KM_loadkey
+	HMAC_SHA256_MIDSTATE Auth_midstate; // SHA-256 states after the HMAC pads of Auth_key, computed by API_KM_loadkey
 	unsigned char keyname[MAX_FILENAME_LENGTH];
 	uint8_t IsLoaded;
+	uint8_t Packet_suite; // packet suite used with this key (see packet_cipher_auth.h)
 }current_key_in_use;
 
 extern current_key_in_use Current_key_in_use;
 
+extern AesContext Current_key_AES_ctx; // Key schedule of Current_key_in_use.Cipher_key, computed by API_KM_loadkey, CSP
+extern AesContext Current_key_GCM_ctx; // Key schedule of Current_key_in_use.GCM_key, computed by API_KM_loadkey, CSP
+
 /****************************************************************************************************************
  * Function definition zone
  ****************************************************************************************************************/
@@ -70,8 +78,12 @@ int API_KM_storekey(uint8_t In_Key[32], size_t key_size, unsigned char *Key_id,
  * @brief Loads a cryptographic key from the file system using the provided Key ID.
  *
  * This function retrieves a key from the file system based on a given Key ID. The key is loaded
- * into the current key structure and used for further cryptographic operations. It also updates
- * the memory tracker for the current key.
+ * into the current key structure and used for further cryptographic operations. The AES key schedule
+ * of the derived cipher key is computed once here (`Current_key_AES_ctx`) and reused by every packet, as are
+ * the HMAC midstates of the derived authentication key (`Current_key_in_use.Auth_midstate`).
+ * Each packet suite has its own key derived from the main key: AES-CBC/HMAC-SHA256 the cipher and authentication
+ * keys, AES-GCM `GCM_key` (schedule in `Current_key_GCM_ctx`) and ChaCha20-Poly1305 `ChaCha_key`.
+ * It also updates the memory trackers for the current key and its key schedules.
  *
  * @param Key_id Pointer to the key identifier.
  * @param Key_id_length Length of the key identifier.
@@ -95,4 +107,17 @@ int API_KM_loadkey(unsigned char *Key_id, size_t Key_id_length);
  */
 
 int API_KM_delete_key(unsigned char *Key_id, size_t Key_id_length);
+
+/**
+ * @brief Selects the packet suite used with the key in use.
+ *
+ * The suite is set to API_PCA_default_suite() every time a key is loaded, this function verifies the integrity
+ * of the loaded key, changes its suite and updates its memory tracker.
+ *
+ * @param suite Packet suite (PCA_SUITE_AES_CBC_HMAC_SHA256, PCA_SUITE_AES_GCM or PCA_SUITE_CHACHA20_POLY1305).
+ *
+ * @return `KM_OK` on success, `KM_PARAMETERS_ERROR` if the suite is not supported, `KM_KEY_NOT_LOADED`
+ * if there is no key loaded, `MT_MEMORYVIOLATION` if the key in use is corrupted, error code otherwise.
+ */
+int API_KM_set_packet_suite(uint8_t suite);
 #endif
\ No newline at end of file
@@ -7,20 +7,26 @@
 
 // Tracker indexs for memory tracking
 int TI_FS_cipher_key;
+int TI_FS_cipher_ctx;
 int TI_FS_data_buffer;
 int TI_PCA_data_buffer_sed;
 int TI_Current_Key_In_Use;
+int TI_Current_Key_AES_ctx;
+int TI_Current_Key_GCM_ctx;
 int TI_AES_CBC_ctx;
 int TI_AESOFB_CTX;
 int TI_AESOFB_outputBlock;
 int TI_AESOFB_ivEnc;
+int TI_AESCTR_CTX;
+int TI_AESGCM_CTX;
 int TI_ECDSA_curve_p;
 int TI_ECDSA_curve_B;
 int TI_ECDSA_curve_G;
 int TI_ECDSA_curve_n;
-int TI_ECDSA_k;
-int TI_ECDSA_l_tmp;
-int TI_ECDSA_l_s;
+int TI_ECDSA_G_table;
+int TI_ECDSA_decompress_cache;
+int TI_ECDSA_nonce_pool;
+int TI_ECDSA_sign_ctx;
 int TI_HMAC256_ihash;
 int TI_HMAC256_ohash;
 int TI_HMAC256_k;
@@ -46,6 +52,9 @@ int Memory_tracking_initialization()
     TI_FS_cipher_key = API_MT_add_tracker(FS_cipher_key, sizeof(FS_cipher_key), CSP); // FS cipher key
     correct_tracker_init_result[counter++] = (TI_FS_cipher_key >= 0) ? 1 : 0;
 
+    TI_FS_cipher_ctx = API_MT_add_tracker(&FS_cipher_ctx, sizeof(FS_cipher_ctx), CSP); // FS cipher key schedule
+    correct_tracker_init_result[counter++] = (TI_FS_cipher_ctx >= 0) ? 1 : 0;
+
     TI_FS_data_buffer = API_MT_add_tracker(FS_data_buffer, sizeof(FS_data_buffer), CSP); // FS auxiliary buffer
     correct_tracker_init_result[counter++] = (TI_FS_data_buffer >= 0) ? 1 : 0;
 
@@ -55,6 +64,12 @@ int Memory_tracking_initialization()
     TI_Current_Key_In_Use = API_MT_add_tracker(&Current_key_in_use, sizeof(Current_key_in_use), CSP); // Packet cipher and auth auxiliary buffer
     correct_tracker_init_result[counter++] = (TI_Current_Key_In_Use >= 0) ? 1 : 0;
 
+    TI_Current_Key_AES_ctx = API_MT_add_tracker(&Current_key_AES_ctx, sizeof(Current_key_AES_ctx), CSP); // Key schedule of the current key in use
+    correct_tracker_init_result[counter++] = (TI_Current_Key_AES_ctx >= 0) ? 1 : 0;
+
+    TI_Current_Key_GCM_ctx = API_MT_add_tracker(&Current_key_GCM_ctx, sizeof(Current_key_GCM_ctx), CSP); // AES-GCM key schedule of the current key in use
+    correct_tracker_init_result[counter++] = (TI_Current_Key_GCM_ctx >= 0) ? 1 : 0;
+
     TI_AES_CBC_ctx = API_MT_add_tracker(&AES_CBC_ctx, sizeof(AES_CBC_ctx), CSP); // AES-CBC context
     correct_tracker_init_result[counter++] = (TI_AES_CBC_ctx >= 0) ? 1 : 0;
 
@@ -67,6 +82,12 @@ int Memory_tracking_initialization()
     TI_AESOFB_ivEnc = API_MT_add_tracker(&AESOFB_ivEnc, sizeof(AESOFB_ivEnc), CSP); // AES-OFB encrypted IV
     correct_tracker_init_result[counter++] = (TI_AESOFB_ivEnc >= 0) ? 1 : 0;
 
+    TI_AESCTR_CTX = API_MT_add_tracker(&AESCTR_CTX, sizeof(AESCTR_CTX), CSP); // AES-CTR context
+    correct_tracker_init_result[counter++] = (TI_AESCTR_CTX >= 0) ? 1 : 0;
+
+    TI_AESGCM_CTX = API_MT_add_tracker(&AESGCM_CTX, sizeof(AESGCM_CTX), CSP); // AES-GCM context
+    correct_tracker_init_result[counter++] = (TI_AESGCM_CTX >= 0) ? 1 : 0;
+
     TI_ECDSA_curve_p = API_MT_add_tracker(ECDSA_curve_p, sizeof(ECDSA_curve_p), CSP); // ECDSA curve parameter p
     correct_tracker_init_result[counter++] = (TI_ECDSA_curve_p >= 0) ? 1 : 0;
 
@@ -79,14 +100,17 @@ int Memory_tracking_initialization()
     TI_ECDSA_curve_n = API_MT_add_tracker(ECDSA_curve_n, sizeof(ECDSA_curve_n), CSP); // ECDSA curve order n
     correct_tracker_init_result[counter++] = (TI_ECDSA_curve_n >= 0) ? 1 : 0;
 
-    TI_ECDSA_k = API_MT_add_tracker(ECDSA_k, sizeof(ECDSA_k), CSP); // ECDSA ephemeral key k
-    correct_tracker_init_result[counter++] = (TI_ECDSA_k >= 0) ? 1 : 0;
+    TI_ECDSA_G_table = API_MT_add_tracker(ECDSA_G_table, sizeof(ECDSA_G_table), PSP); // ECDSA fixed-base table of G
+    correct_tracker_init_result[counter++] = (TI_ECDSA_G_table >= 0) ? 1 : 0;
+
+    TI_ECDSA_decompress_cache = API_MT_add_tracker(ECDSA_decompress_cache, sizeof(ECDSA_decompress_cache), PSP); // ECDSA decompressed public keys cache
+    correct_tracker_init_result[counter++] = (TI_ECDSA_decompress_cache >= 0) ? 1 : 0;
 
-    TI_ECDSA_l_tmp = API_MT_add_tracker(ECDSA_l_tmp, sizeof(ECDSA_l_tmp), CSP); // ECDSA temporary value
-    correct_tracker_init_result[counter++] = (TI_ECDSA_l_tmp >= 0) ? 1 : 0;
+    TI_ECDSA_nonce_pool = API_MT_add_tracker(&ECDSA_nonce_pool, sizeof(ECDSA_nonce_pool), CSP); // ECDSA precomputed nonces (r, 1/k) and refill scratch
+    correct_tracker_init_result[counter++] = (TI_ECDSA_nonce_pool >= 0) ? 1 : 0;
 
-    TI_ECDSA_l_s = API_MT_add_tracker(ECDSA_l_s, sizeof(ECDSA_l_s), CSP); // ECDSA signature value
-    correct_tracker_init_result[counter++] = (TI_ECDSA_l_s >= 0) ? 1 : 0;
+    TI_ECDSA_sign_ctx = API_MT_add_tracker(&ECDSA_sign_ctx, sizeof(ECDSA_sign_ctx), CSP); // ECDSA signature scratch (k, 1/k, d, s)
+    correct_tracker_init_result[counter++] = (TI_ECDSA_sign_ctx >= 0) ? 1 : 0;
 
     TI_HMAC256_ihash = API_MT_add_tracker(HMAC256_ihash, sizeof(HMAC256_ihash), CSP); // HMAC-SHA256 inner hash
     correct_tracker_init_result[counter++] = (TI_HMAC256_ihash >= 0) ? 1 : 0;
@@ -163,8 +187,9 @@ int File_system_first_initialization(unsigned char *KEK_CERTIFICATE_file, unsign
     // Set up AES encryption with the loaded key.
     API_FS_setup_cipher(CIPHER_ON, key_AES256_certificate);
 
-    // Update the memory tracker with the new key.
+    // Update the memory tracker with the new key and its key schedule.
     API_MT_update_tracker(&MT_trackers[TI_FS_cipher_key]);
+    API_MT_update_tracker(&MT_trackers[TI_FS_cipher_ctx]);
 
     uint8_t previus_state = PREVIUS_NORMAL_STATE;
     int result1 = API_FS_create_file_data(CONF_FILENAME, strlen(CONF_FILENAME), &previus_state, 1, NOT_CSP);
@@ -236,8 +261,9 @@ int File_system_normal_initialization(unsigned char *KEK_CERTIFICATE_file, unsig
         return INIT_INCORRECT_FILESYSTEM_INIT;
     }
 
-    // Update the memory tracker with the new key.
+    // Update the memory tracker with the new key and its key schedule.
     API_MT_update_tracker(&MT_trackers[TI_FS_cipher_key]);
+    API_MT_update_tracker(&MT_trackers[TI_FS_cipher_ctx]);
 
     unsigned char Schneier_patterns[] = {0x00, 0xFF, 0xAA, 0x55, 0xAA, 0x55}; // zeroize old memory space for key
     for (int i = 0; i < 6; i++)
@@ -270,6 +296,10 @@ int API_INIT_initialize_module(unsigned char *KEK_CERTIFICATE_file, unsigned cha
     }
     //Check AES Hardware support
     API_AES_checkHWsupport();
+    //Check SHA-256 Hardware support
+    API_SHA256_checkHWsupport();
+    //Build the fixed-base table of the ECDSA generator before its tracker is registered
+    API_ECDSA_precompute_G_table();
     //Check PRNG Hardware support
     check_rdrand();
     
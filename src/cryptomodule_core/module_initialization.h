@@ -29,6 +29,8 @@
 #include "../library_tracer/log_manager.h"
 #include "../crypto/AES_CBC.h"
 #include "../crypto/AES_OFB.h"
+#include "../crypto/AES_CTR.h"
+#include "../crypto/AES_GCM.h"
 #include "../crypto/AES_CORE.h"
 #include "../crypto/ECDSA_256.h"
 #include "../crypto/SHA256.h"
@@ -58,25 +60,31 @@
 
 // TI (TRACKER INDEX) LIST for volatile memory integrity/zeroization
 extern int TI_FS_cipher_key;	       /**< File system cipher key tracker index */
+extern int TI_FS_cipher_ctx;	       /**< File system cipher key schedule tracker index */
 extern int TI_FS_data_buffer;	       /**< File system auxiliary data buffer tracker index */
 extern int TI_PCA_data_buffer_sed;     /**< Packet cipher and authentication module data buffer tracker index */
 extern int TI_PCA_data_buffer_sed_aux; /**< Packet cipher and authentication module auxiliary data buffer tracker index */
 extern int TI_Current_Key_In_Use;      /**< Current key in use for cipher and authenticate packets */
+extern int TI_Current_Key_AES_ctx;     /**< Key schedule of the current key in use tracker index */
+extern int TI_Current_Key_GCM_ctx;     /**< AES-GCM key schedule of the current key in use tracker index */
 
 // AES CSPs parameters
 extern int TI_AES_CBC_ctx;	  /**< AES-CBC context tracker index */
 extern int TI_AESOFB_CTX;	  /**< AES-OFB context tracker index */
 extern int TI_AESOFB_outputBlock; /**< AES-OFB output block tracker index */
 extern int TI_AESOFB_ivEnc;	  /**< AES-OFB initialization vector encryption tracker index */
+extern int TI_AESCTR_CTX;	  /**< AES-CTR context tracker index */
+extern int TI_AESGCM_CTX;	  /**< AES-GCM context tracker index */
 
 // ECDSA-256 operation parameters with private keys
 extern int TI_ECDSA_curve_p; /**< ECDSA curve parameter p tracker index */
 extern int TI_ECDSA_curve_B; /**< ECDSA curve parameter B tracker index */
 extern int TI_ECDSA_curve_G; /**< ECDSA curve generator point G tracker index */
 extern int TI_ECDSA_curve_n; /**< ECDSA curve order n tracker index */
-extern int TI_ECDSA_k;	     /**< ECDSA ephemeral key k tracker index */
-extern int TI_ECDSA_l_tmp;   /**< ECDSA temporary value tracker index */
-extern int TI_ECDSA_l_s;     /**< ECDSA signature value tracker index */
+extern int TI_ECDSA_G_table; /**< ECDSA fixed-base table of G tracker index */
+extern int TI_ECDSA_decompress_cache; /**< ECDSA decompressed public keys cache tracker index */
+extern int TI_ECDSA_nonce_pool; /**< ECDSA precomputed nonces pool tracker index */
+extern int TI_ECDSA_sign_ctx; /**< ECDSA signature context of ecdsa_sign tracker index */
 
 // HMAC-SHA256 operation parameters with secret keys
 extern int TI_HMAC256_ihash;	     /**< HMAC-SHA256 inner hash tracker index */
@@ -18,7 +18,7 @@ unsigned char PCA_data_buffer_sed[data_buffer_sign_encrypt_length]; // 256 kilob
  ****************************************************************************************************************/
 
 // Function to encrypt and sign a data packet.
-int API_PCA_sign_encrypt_packet(unsigned char *data_in, size_t data_in_length, unsigned char *key_AES, unsigned char *key_HMAC, unsigned char **out_data, size_t *out_data_length)
+int API_PCA_sign_encrypt_packet(unsigned char *data_in, size_t data_in_length, AesContext const *ctx_AES, HMAC_SHA256_MIDSTATE const *midstate_HMAC, unsigned char **out_data, size_t *out_data_length)
 {
 	if (API_SM_get_current_state() != STATE_CRYPTOGRAPHIC)
 	{
@@ -27,7 +27,7 @@ int API_PCA_sign_encrypt_packet(unsigned char *data_in, size_t data_in_length, u
 
 	unsigned char allocated_memory ;     		   // Flag to manage dynamically allocated memory release.
 	unsigned char AES_IV[16];					   // Buffer for AES initialization vector.
-	unsigned char *sign_out, *out_buffer_pointer;  // Pointers for the signature and output buffers.
+	unsigned char *out_buffer_pointer;             // Pointer for the output buffer.
 	unsigned int padding;						   // Variable for padding calculation.
 	size_t out_buffer_length, data_in_len_aux;	   // Buffer and input data lengths.
 
@@ -59,9 +59,6 @@ int API_PCA_sign_encrypt_packet(unsigned char *data_in, size_t data_in_length, u
 		return PRNG_GENERATION_FAILED;
 	}
 
-	// Encrypt the data and signature using AES in CBC mode.
-	int result2 = API_CP_AESCBC_encrypt(data_in, &data_in_len_aux, key_AES, AES_KEY_SIZE_256, AES_IV, out_buffer_pointer + IV_SIZE_HEADER_LENGTH);
-
 	// Copy the total size and IV to the beginning of the output buffer.
 	size_t copysize = out_buffer_length;
 	for (int i = 7; i >= 0; i--)
@@ -71,10 +68,33 @@ int API_PCA_sign_encrypt_packet(unsigned char *data_in, size_t data_in_length, u
 	}
 	memcpy(out_buffer_pointer + 8, AES_IV, 16);
 
-	// Generate HMAC signature.
-	int result3 = API_CP_hmac_sha256(out_buffer_pointer, key_HMAC, data_in_len_aux + IV_SIZE_HEADER_LENGTH, HMAC_SHA256_KEY_SIZE, &sign_out);
-	// copy HMAC signature at the end of the packet
-	memcpy(out_buffer_pointer + data_in_len_aux + IV_SIZE_HEADER_LENGTH,sign_out,HMAC_SHA256_SIGN_SIZE);
+	// Encrypt with AES in CBC mode and sign chunk by chunk, every ciphertext chunk is authenticated while it is still in L1.
+	HMAC_SHA256_CTX hmac_ctx; // CSP
+	API_hmac_sha256_init_midstate(&hmac_ctx, midstate_HMAC);
+	API_hmac_sha256_update(&hmac_ctx, out_buffer_pointer, IV_SIZE_HEADER_LENGTH);
+
+	unsigned char *ciphertext = out_buffer_pointer + IV_SIZE_HEADER_LENGTH;
+	const unsigned char *chain = out_buffer_pointer + 8; // IV, then the last ciphertext block of the previous chunk
+	size_t full_length = data_in_length - (data_in_length % 16);
+	for (size_t offset = 0; offset < full_length; offset += PCA_FUSED_CHUNK_SIZE)
+	{
+		size_t chunk = (full_length - offset < PCA_FUSED_CHUNK_SIZE) ? full_length - offset : PCA_FUSED_CHUNK_SIZE;
+		CP_AESCBC_encrypt_blocks(ctx_AES, data_in + offset, chunk / 16, chain, ciphertext + offset);
+		API_hmac_sha256_update(&hmac_ctx, ciphertext + offset, chunk);
+		chain = ciphertext + offset + chunk - 16;
+	}
+
+	// Last block with the PKCS#7 padding, built aside so the input buffer is not written
+	unsigned char last_block[16]; // CSP
+	memcpy(last_block, data_in + full_length, data_in_length - full_length);
+	memset(last_block + (data_in_length - full_length), padding, padding);
+	CP_AESCBC_encrypt_blocks(ctx_AES, last_block, 1, chain, ciphertext + full_length);
+	API_hmac_sha256_update(&hmac_ctx, ciphertext + full_length, 16);
+	data_in_len_aux = full_length + 16;
+	memset(last_block, 0, sizeof(last_block));
+
+	// Finish the HMAC signature directly at the end of the packet.
+	API_hmac_sha256_final(&hmac_ctx, ciphertext + data_in_len_aux);
 
 	// Assign the output buffer and its length to the output pointers.
 	*out_data = out_buffer_pointer;
@@ -83,8 +103,88 @@ int API_PCA_sign_encrypt_packet(unsigned char *data_in, size_t data_in_length, u
 	return allocated_memory; // Return success.
 }
 
+// Function to encrypt and sign several data packets with the same keys, the CBC encryption of the packets runs in lockstep.
+int API_PCA_sign_encrypt_packets(unsigned char **data_in, size_t *data_in_length, size_t npackets, AesContext const *ctx_AES, HMAC_SHA256_MIDSTATE const *midstate_HMAC, unsigned char **packets_out, size_t *packets_out_length)
+{
+	if (API_SM_get_current_state() != STATE_CRYPTOGRAPHIC)
+	{
+		return SM_ERROR_STATE; // Return error if not operational
+	}
+
+	AESCBC_stream streams[PCA_BATCH_PACKETS]; // CBC streams encrypted together
+	unsigned char *hmac_msgs[PCA_BATCH_PACKETS];  // Signed part of each packet
+	size_t hmac_lengths[PCA_BATCH_PACKETS];
+	unsigned char *hmac_out[PCA_BATCH_PACKETS];   // Where the signature of each packet goes
+	size_t padded_length, packet_length;	  // Ciphertext and packet lengths
+
+	// Generate the IV of every packet directly in the packet before anything else is written, so a PRNG
+	// failure leaves no packet half built
+	for (size_t i = 0; i < npackets; i++)
+	{
+		if (API_RNG_fill_buffer_random(packets_out[i] + 8, 16) == PRNG_GENERATION_FAILED)
+		{
+			for (size_t j = 0; j < i; j++)
+			{
+				memset(packets_out[j] + 8, 0, 16);
+			}
+			memset(packets_out_length, 0, npackets * sizeof(size_t));
+			return PRNG_GENERATION_FAILED;
+		}
+	}
+
+	for (size_t first = 0; first < npackets; first += PCA_BATCH_PACKETS)
+	{
+		size_t count = (npackets - first < PCA_BATCH_PACKETS) ? npackets - first : PCA_BATCH_PACKETS;
+
+		// Build the header of every packet and copy the padded plaintext where its ciphertext goes
+		for (size_t i = 0; i < count; i++)
+		{
+			unsigned char *packet = packets_out[first + i];
+			size_t length = data_in_length[first + i];
+			unsigned char padding = 16 - (length % 16);
+			padded_length = length + padding;
+			packet_length = padded_length + IV_SIZE_HEADER_LENGTH + HMAC_SHA256_SIGN_SIZE;
+
+			// Copy the total size to the beginning of the packet.
+			size_t copysize = packet_length;
+			for (int j = 7; j >= 0; j--)
+			{
+				packet[j] = (unsigned char)(copysize & 0xFF);
+				copysize >>= 8;
+			}
+
+			// Plaintext and PKCS#7 padding, encrypted in place
+			memcpy(packet + IV_SIZE_HEADER_LENGTH, data_in[first + i], length);
+			memset(packet + IV_SIZE_HEADER_LENGTH + length, padding, padding);
+
+			streams[i].ctx = ctx_AES;
+			streams[i].iv = packet + 8;
+			streams[i].plaintext = packet + IV_SIZE_HEADER_LENGTH;
+			streams[i].len = padded_length;
+			streams[i].ciphertext = packet + IV_SIZE_HEADER_LENGTH;
+			packets_out_length[first + i] = packet_length;
+		}
+
+		// Encrypt all the packets of the group at the same time using AES in CBC mode.
+		API_AESCBC_encrypt_multi(streams, count);
+
+		// Generate the HMAC signatures of the group from the key midstates, directly at the end of each packet
+		for (size_t i = 0; i < count; i++)
+		{
+			unsigned char *packet = packets_out[first + i];
+			padded_length = streams[i].len;
+			hmac_msgs[i] = packet;
+			hmac_lengths[i] = padded_length + IV_SIZE_HEADER_LENGTH;
+			hmac_out[i] = packet + padded_length + IV_SIZE_HEADER_LENGTH;
+		}
+		API_hmac_sha256_many_midstate(midstate_HMAC, hmac_msgs, hmac_lengths, count, hmac_out);
+	}
+
+	return NOT_ALLOCATED_MEMORY; // Return success, the packets are built in the caller buffers.
+}
+
 // Function to decrypt a data packet and verify its signature.
-int API_PCA_decrypt_verify_packet(unsigned char *data_in, size_t data_in_length, unsigned char *key_AES, unsigned char *key_HMAC, unsigned char **out_data, size_t *out_data_length, unsigned char *verify)
+int API_PCA_decrypt_verify_packet(unsigned char *data_in, size_t data_in_length, AesContext const *ctx_AES, HMAC_SHA256_MIDSTATE const *midstate_HMAC, unsigned char **out_data, size_t *out_data_length, unsigned char *verify)
 {
 	if (API_SM_get_current_state() != STATE_CRYPTOGRAPHIC)
 	{
@@ -111,11 +211,10 @@ int API_PCA_decrypt_verify_packet(unsigned char *data_in, size_t data_in_length,
 	// auxiliar length corresponding to the entire packet excluding HMAC signature
 	data_in_len_aux = data_len_packet - HMAC_SHA256_SIGN_SIZE;
 
-	// verify HMAC signature
-	int result1 = API_CP_verify_HMAC_SHA256(data_in,key_HMAC,data_in + data_in_len_aux,data_in_len_aux,HMAC_SHA256_KEY_SIZE,HMAC_SHA256_SIGN_SIZE,verify);
-
-	//if packet not verified, stop the operation
-	if(!(*verify)){
+	*verify = MAC_NOT_VERIFIED;
+	// the ciphertext must be made of whole blocks, at least the padding one
+	if (data_in_len_aux < IV_SIZE_HEADER_LENGTH + 16 || data_in_len_aux > data_in_length || (data_in_len_aux - IV_SIZE_HEADER_LENGTH) % 16 != 0)
+	{
 		return MAC_NOT_VERIFIED;
 	}
 
@@ -128,8 +227,35 @@ int API_PCA_decrypt_verify_packet(unsigned char *data_in, size_t data_in_length,
 		allocated_memory = ALLOCATED_MEMORY;
 	}
 
-	//decipher the ciphertext
-	int result2 = API_CP_AESCBC_decrypt(data_in + IV_SIZE_HEADER_LENGTH, &data_in_len_aux, key_AES, AES_KEY_SIZE_256, data_in + 8, out_buffer_pointer); // data in +8 to acced IV
+	// Authenticate and decipher the ciphertext chunk by chunk, every chunk is decrypted while it is still in L1.
+	HMAC_SHA256_CTX hmac_ctx; // CSP
+	API_hmac_sha256_init_midstate(&hmac_ctx, midstate_HMAC);
+	API_hmac_sha256_update(&hmac_ctx, data_in, IV_SIZE_HEADER_LENGTH);
+
+	const unsigned char *ciphertext = data_in + IV_SIZE_HEADER_LENGTH;
+	for (size_t offset = 0; offset < data_in_len_aux; offset += PCA_FUSED_CHUNK_SIZE)
+	{
+		size_t chunk = (data_in_len_aux - offset < PCA_FUSED_CHUNK_SIZE) ? data_in_len_aux - offset : PCA_FUSED_CHUNK_SIZE;
+		const unsigned char *chain = (offset == 0) ? data_in + 8 : ciphertext + offset - 16; // data in +8 to acced IV
+		API_hmac_sha256_update(&hmac_ctx, ciphertext + offset, chunk);
+		CP_AESCBC_decrypt_blocks(ctx_AES, ciphertext + offset, chunk / 16, chain, out_buffer_pointer + offset);
+	}
+
+	// verify HMAC signature, the plaintext is never released if the packet is not verified
+	*verify = API_hmac_sha256_final_verify(&hmac_ctx, ciphertext + data_in_len_aux, HMAC_SHA256_SIGN_SIZE);
+	if(!(*verify)){
+		API_MM_secure_zeroize(out_buffer_pointer, data_in_len_aux);
+		if (allocated_memory == ALLOCATED_MEMORY)
+		{
+			API_MM_freeMem(out_buffer_pointer, ROOT);
+		}
+		return MAC_NOT_VERIFIED;
+	}
+
+	// remove the PKCS#7 padding
+	int padding = CP_getPaddingLength(out_buffer_pointer, data_in_len_aux);
+	if (padding != -1)
+		data_in_len_aux -= padding;
 
 	// assign output parameters
 	*out_data = out_buffer_pointer;
@@ -137,3 +263,165 @@ int API_PCA_decrypt_verify_packet(unsigned char *data_in, size_t data_in_length,
 
 	return allocated_memory; // Return success.
 }
+
+// Function to encrypt and authenticate a data packet with AES-GCM, the packet is built in the caller buffer.
+int API_PCA_encrypt_packet_GCM(unsigned char *data_in, size_t data_in_length, AesContext const *ctx_AES, unsigned char *packet_out, size_t *packet_out_length)
+{
+	if (API_SM_get_current_state() != STATE_CRYPTOGRAPHIC)
+	{
+		return SM_ERROR_STATE; // Return error if not operational
+	}
+
+	size_t packet_length = data_in_length + PCA_GCM_OVERHEAD; // Header, IV, ciphertext and tag.
+
+	// Generate IV for AES-GCM directly in the packet.
+	if (API_RNG_fill_buffer_random(packet_out + 8, AES_GCM_IV_SIZE) == PRNG_GENERATION_FAILED)
+	{
+		return PRNG_GENERATION_FAILED;
+	}
+
+	// Copy the total size to the last 7 bytes of the header, and the suite to the first one.
+	size_t copysize = packet_length;
+	for (int i = 7; i >= 1; i--)
+	{
+		packet_out[i] = (unsigned char)(copysize & 0xFF);
+		copysize >>= 8;
+	}
+	packet_out[0] = PCA_SUITE_AES_GCM;
+
+	// Encrypt the data and compute the tag in a single pass, the header is the additional authenticated data.
+	API_AES_GCM_encrypt_ctx(ctx_AES, data_in, data_in_length, packet_out + 8, AES_GCM_IV_SIZE, packet_out, 8,
+							packet_out + PCA_GCM_HEADER_LENGTH, packet_out + PCA_GCM_HEADER_LENGTH + data_in_length);
+
+	*packet_out_length = packet_length;
+	return NOT_ALLOCATED_MEMORY; // Return success, the packet is built in the caller buffer.
+}
+
+// Function to decrypt an AES-GCM data packet and verify its tag.
+int API_PCA_decrypt_packet_GCM(unsigned char *data_in, size_t data_in_length, AesContext const *ctx_AES, unsigned char *out_data, size_t *out_data_length, unsigned char *verify)
+{
+	if (API_SM_get_current_state() != STATE_CRYPTOGRAPHIC)
+	{
+		return SM_ERROR_STATE; // Return error if not operational
+	}
+	size_t data_len_packet = 0; // Packet size in the header.
+
+	*verify = MAC_NOT_VERIFIED;
+	*out_data_length = 0;
+	if (data_in_length < PCA_GCM_OVERHEAD || data_in[0] != PCA_SUITE_AES_GCM)
+	{
+		return MAC_NOT_VERIFIED;
+	}
+	for (int i = 1; i < 8; i++)
+	{
+		data_len_packet = (data_len_packet << 8) | data_in[i];
+	}
+	if (data_len_packet != data_in_length)
+	{
+		return MAC_NOT_VERIFIED;
+	}
+
+	// Decrypt and verify the tag in a single pass, the output is zeroized if the tag does not match.
+	size_t ciphertext_length = data_in_length - PCA_GCM_OVERHEAD;
+	if (API_AES_GCM_decrypt_ctx(ctx_AES, data_in + PCA_GCM_HEADER_LENGTH, ciphertext_length, data_in + 8, AES_GCM_IV_SIZE, data_in, 8,
+								data_in + PCA_GCM_HEADER_LENGTH + ciphertext_length, AES_GCM_TAG_SIZE, out_data) != AES_GCM_TAG_OK)
+	{
+		return MAC_NOT_VERIFIED;
+	}
+
+	*verify = MAC_VERIFIED;
+	*out_data_length = ciphertext_length;
+	return NOT_ALLOCATED_MEMORY; // Return success, the data is decrypted in the caller buffer.
+}
+
+// Function to encrypt and authenticate a data packet with ChaCha20-Poly1305, the packet is built in the caller buffer.
+int API_PCA_encrypt_packet_CHACHA(unsigned char *data_in, size_t data_in_length, const unsigned char *key_ChaCha, unsigned char *packet_out, size_t *packet_out_length)
+{
+	if (API_SM_get_current_state() != STATE_CRYPTOGRAPHIC)
+	{
+		return SM_ERROR_STATE; // Return error if not operational
+	}
+
+	size_t packet_length = data_in_length + PCA_CHACHA_OVERHEAD; // Header, nonce, ciphertext and tag.
+
+	// Generate the nonce directly in the packet.
+	if (API_RNG_fill_buffer_random(packet_out + 8, CHACHA20_NONCE_SIZE) == PRNG_GENERATION_FAILED)
+	{
+		return PRNG_GENERATION_FAILED;
+	}
+
+	// Copy the total size to the last 7 bytes of the header, and the suite to the first one.
+	size_t copysize = packet_length;
+	for (int i = 7; i >= 1; i--)
+	{
+		packet_out[i] = (unsigned char)(copysize & 0xFF);
+		copysize >>= 8;
+	}
+	packet_out[0] = PCA_SUITE_CHACHA20_POLY1305;
+
+	// Encrypt the data and compute the tag in a single pass, the header is the additional authenticated data.
+	API_CHACHA20_POLY1305_encrypt(key_ChaCha, packet_out + 8, packet_out, 8, data_in, data_in_length,
+								  packet_out + PCA_CHACHA_HEADER_LENGTH, packet_out + PCA_CHACHA_HEADER_LENGTH + data_in_length);
+
+	*packet_out_length = packet_length;
+	return NOT_ALLOCATED_MEMORY; // Return success, the packet is built in the caller buffer.
+}
+
+// Function to decrypt a ChaCha20-Poly1305 data packet and verify its tag.
+int API_PCA_decrypt_packet_CHACHA(unsigned char *data_in, size_t data_in_length, const unsigned char *key_ChaCha, unsigned char *out_data, size_t *out_data_length, unsigned char *verify)
+{
+	if (API_SM_get_current_state() != STATE_CRYPTOGRAPHIC)
+	{
+		return SM_ERROR_STATE; // Return error if not operational
+	}
+	size_t data_len_packet = 0; // Packet size in the header.
+
+	*verify = MAC_NOT_VERIFIED;
+	*out_data_length = 0;
+	if (data_in_length < PCA_CHACHA_OVERHEAD || data_in[0] != PCA_SUITE_CHACHA20_POLY1305)
+	{
+		return MAC_NOT_VERIFIED;
+	}
+	for (int i = 1; i < 8; i++)
+	{
+		data_len_packet = (data_len_packet << 8) | data_in[i];
+	}
+	if (data_len_packet != data_in_length)
+	{
+		return MAC_NOT_VERIFIED;
+	}
+
+	// Decrypt and verify the tag in a single pass, the output is zeroized if the tag does not match.
+	size_t ciphertext_length = data_in_length - PCA_CHACHA_OVERHEAD;
+	if (API_CHACHA20_POLY1305_decrypt(key_ChaCha, data_in + 8, data_in, 8, data_in + PCA_CHACHA_HEADER_LENGTH, ciphertext_length,
+									  data_in + PCA_CHACHA_HEADER_LENGTH + ciphertext_length, out_data) != CHACHA20_POLY1305_TAG_OK)
+	{
+		return MAC_NOT_VERIFIED;
+	}
+
+	*verify = MAC_VERIFIED;
+	*out_data_length = ciphertext_length;
+	return NOT_ALLOCATED_MEMORY; // Return success, the data is decrypted in the caller buffer.
+}
+
+// Suite given to the keys, ChaCha20-Poly1305 when AES-NI is not available.
+unsigned char API_PCA_default_suite()
+{
+	if (AES_IMPLEMENTATION_IS_AESNI(API_AES_getImplementation()))
+	{
+		return PCA_SUITE_AES_CBC_HMAC_SHA256;
+	}
+	return PCA_SUITE_CHACHA20_POLY1305;
+}
+
+// Suite of a packet, first byte of its header.
+unsigned char API_PCA_get_packet_suite(const unsigned char *packet)
+{
+	return packet[0];
+}
+
+// Check if the suite is supported.
+int API_PCA_is_valid_suite(unsigned char suite)
+{
+	return suite == PCA_SUITE_AES_CBC_HMAC_SHA256 || suite == PCA_SUITE_AES_GCM || suite == PCA_SUITE_CHACHA20_POLY1305;
+}
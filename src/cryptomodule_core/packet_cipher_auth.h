@@ -17,6 +17,8 @@
  ****************************************************************************************************************/
 
 #include "../crypto/crypto.h"
+#include "../crypto/AES_GCM.h"
+#include "../crypto/CHACHA20_POLY1305.h"
 #include "../secure_memory_management/DmemManager.h"
 #include "../prng/random_number.h"
 #include "../state_machine/State_Machine.h"
@@ -36,6 +38,26 @@
 #define data_buffer_sign_encrypt_length 262144 //256 kilobytes of static memory so it is not necesary to allocate memory all time CSP
 
 
+#define PCA_BATCH_PACKETS 32 // packets prepared at a time by API_PCA_sign_encrypt_packets, their CBC streams share the AES-NI lanes
+
+#define PCA_FUSED_CHUNK_SIZE 16384 // bytes encrypted (or decrypted) and then authenticated while still in L1, by the CBC+HMAC packet functions
+
+#define PCA_SUITE_AES_CBC_HMAC_SHA256 0 // AES-256-CBC with PKCS#7 padding and HMAC-SHA256 over the header and ciphertext
+
+#define PCA_SUITE_AES_GCM 1 // AES-256-GCM, single pass authenticated encryption
+
+#define PCA_SUITE_CHACHA20_POLY1305 2 // ChaCha20-Poly1305 (RFC 8439), for the hosts without AES-NI
+
+#define PCA_SUITE_KEY 0xFF // not a packet suite, selects the suite of the loaded key (see API_KM_set_packet_suite)
+
+#define PCA_GCM_HEADER_LENGTH 20 // suite and size (8 bytes) and GCM IV (12 bytes)
+
+#define PCA_GCM_OVERHEAD (PCA_GCM_HEADER_LENGTH + AES_GCM_TAG_SIZE)
+
+#define PCA_CHACHA_HEADER_LENGTH 20 // suite and size (8 bytes) and ChaCha20 nonce (12 bytes)
+
+#define PCA_CHACHA_OVERHEAD (PCA_CHACHA_HEADER_LENGTH + POLY1305_TAG_SIZE)
+
 #define NOT_ALLOCATED_MEMORY 1
 
 #define ALLOCATED_MEMORY 2
@@ -43,9 +65,11 @@
 extern unsigned char PCA_data_buffer_sed[data_buffer_sign_encrypt_length]; // 256 kilobytes of static memory to avoid memory allocation every time CSP is used
 
 /*
-Structure of the encrypted packet; the size, iv and HMAC signature are in plaintext, the Ciphertexts is (obviusly) ciphered
-
+Structure of the encrypted packet; the size, iv and HMAC signature are in plaintext, the Ciphertexts is (obviusly) ciphered.
+The first byte of the 8-byte header is the suite of the packet and the other 7 bytes the packet size, as the packet size
+of the AES-CBC packets never reaches 2^56 bytes their first byte is always 0 (PCA_SUITE_AES_CBC_HMAC_SHA256).
 
+AES-CBC + HMAC-SHA256 (PCA_SUITE_AES_CBC_HMAC_SHA256):
 
 +-----------------------+-----------------------+--------------------------+---------------------------+
 |   8-byte Packet       |   AES IV (16 bytes)   |   Cipherext (length n)   | HMAC Signature (32 bytes) |
@@ -56,6 +80,28 @@ Structure of the encrypted packet; the size, iv and HMAC signature are in plaint
 |                       |                       |                          |                           |
 +-----------------------+-----------------------+--------------------------+---------------------------+
 
+AES-GCM (PCA_SUITE_AES_GCM), no padding, the 8-byte header is the additional authenticated data:
+
++-----------------------+-----------------------+--------------------------+---------------------------+
+|   8-byte Packet       |   GCM IV (12 bytes)   |   Cipherext (length n)   |   GCM Tag (16 bytes)      |
++-----------------------+-----------------------+--------------------------+---------------------------+
+|                       |                       |                          |                           |
+| [Suite | Packet Size] |   [12-byte GCM IV]    | [Ciphertext of length n] |    [16-byte GCM Tag]      |
+|     (1 B + 7 B)       |        (12 B)         |          (n B)           |          (16 B)           |
+|                       |                       |                          |                           |
++-----------------------+-----------------------+--------------------------+---------------------------+
+
+ChaCha20-Poly1305 (PCA_SUITE_CHACHA20_POLY1305), same layout as AES-GCM with a ChaCha20 nonce and a Poly1305 tag:
+
++-----------------------+-----------------------+--------------------------+---------------------------+
+|   8-byte Packet       |   Nonce (12 bytes)    |   Cipherext (length n)   | Poly1305 Tag (16 bytes)   |
++-----------------------+-----------------------+--------------------------+---------------------------+
+|                       |                       |                          |                           |
+| [Suite | Packet Size] |   [12-byte nonce]     | [Ciphertext of length n] |  [16-byte Poly1305 Tag]   |
+|     (1 B + 7 B)       |        (12 B)         |          (n B)           |          (16 B)           |
+|                       |                       |                          |                           |
++-----------------------+-----------------------+--------------------------+---------------------------+
+
 */
 
 
@@ -73,15 +119,37 @@ Structure of the encrypted packet; the size, iv and HMAC signature are in plaint
  * 
  * @param data_in Pointer to the input data.
  * @param data_in_length Length of the input data.
- * @param key_AES Pointer to the AES key.
- * @param key_HMAC Pointer to the HMAC key.
+ * @param ctx_AES Pointer to the expanded AES key (key schedule handle, see API_KM_loadkey).
+ * @param midstate_HMAC Pointer to the precomputed midstates of the HMAC key (see API_KM_loadkey).
  * @param out_data Pointer to the output buffer that will contain the encrypted data.
  * @param out_data_length Pointer to a size_t that will be set to the length of the encrypted data.
  * 
  * @return Returns 1 on NOT ALLOCATED MEMORY, 2 on ALLOCATED_MEMORY, PRNG_GENERATION_FAILED if not enough entropy is avaiable in the system
  * , potentially different values on failure to indicate the type of error.
  */
-int API_PCA_sign_encrypt_packet(unsigned char *data_in, size_t data_in_length, unsigned char *key_AES, unsigned char *key_HMAC, unsigned char **out_data, size_t *out_data_length);
+int API_PCA_sign_encrypt_packet(unsigned char *data_in, size_t data_in_length, AesContext const *ctx_AES, HMAC_SHA256_MIDSTATE const *midstate_HMAC, unsigned char **out_data, size_t *out_data_length);
+
+/**
+ * @brief Encrypt and sign several data packets using AES CBC and HMAC-SHA256.
+ *
+ * Batch version of API_PCA_sign_encrypt_packet for when several packets are queued. Every packet gets its own
+ * random IV and has the same format, but the packets are built directly in the caller buffers and the CBC
+ * encryption of up to AESCBC_MAX_LANES packets advances in lockstep (API_AESCBC_encrypt_multi), as CBC
+ * encryption is serial inside one packet.
+ *
+ * @param data_in Array of pointers to the input data of each packet.
+ * @param data_in_length Array with the length of the input data of each packet.
+ * @param npackets Number of packets.
+ * @param ctx_AES Pointer to the expanded AES key (key schedule handle, see API_KM_loadkey).
+ * @param midstate_HMAC Pointer to the precomputed midstates of the HMAC key (see API_KM_loadkey).
+ * @param packets_out Array of pointers to the output buffers, each one at least 72 bytes larger than its input data (must not overlap it).
+ * @param packets_out_length Array that will be set to the length of each packet.
+ *
+ * @return Returns 1 on NOT ALLOCATED MEMORY (success), PRNG_GENERATION_FAILED if not enough entropy is avaiable in the system
+ * (the IVs are generated before any packet is built, so no packet is written and every length is set to 0),
+ * SM_ERROR_STATE if the module is not in cryptographic state.
+ */
+int API_PCA_sign_encrypt_packets(unsigned char **data_in, size_t *data_in_length, size_t npackets, AesContext const *ctx_AES, HMAC_SHA256_MIDSTATE const *midstate_HMAC, unsigned char **packets_out, size_t *packets_out_length);
 
 /**
  * @brief Verify the signature of a packet using HMAC-SHA256 , and decrypt the packet if the signature is verified
@@ -99,14 +167,113 @@ int API_PCA_sign_encrypt_packet(unsigned char *data_in, size_t data_in_length, u
  *
  * @param data_in Pointer to the encrypted data packet.
  * @param data_in_length Length of the encrypted data packet.
- * @param key_AES Pointer to the AES key.
- * @param key_HMAC Pointer to the HMAC key.
+ * @param ctx_AES Pointer to the expanded AES key (key schedule handle, see API_KM_loadkey).
+ * @param midstate_HMAC Pointer to the precomputed midstates of the HMAC key (see API_KM_loadkey).
  * @param out_data Pointer to the output buffer that will contain the sign + the decrypted data, in order to access decrypted data, +32 the pointer.
  * @param out_data_length  Pointer to a size_t that will be set to the length of the plain data.
  * @param verify Pointer to the buffer where the result of the HMAC verification will be stored.
  * 
  * @return Returns 0 on MAC_NOT_VERIFIED, 1 on NOT ALLOCATED MEMORY, 2 on ALLOCATED_MEMORY, potentially different values on failure to indicate the type of error.
  */
-int API_PCA_decrypt_verify_packet(unsigned char *data_in, size_t data_in_length, unsigned char *key_AES, unsigned char *key_HMAC, unsigned char **out_data, size_t *out_data_length ,unsigned char *verify);
+int API_PCA_decrypt_verify_packet(unsigned char *data_in, size_t data_in_length, AesContext const *ctx_AES, HMAC_SHA256_MIDSTATE const *midstate_HMAC, unsigned char **out_data, size_t *out_data_length ,unsigned char *verify);
+
+/**
+ * @brief Encrypt and authenticate a data packet using AES-GCM.
+ *
+ * This function generates a random 96 bits IV and builds the AES-GCM packet directly in the output buffer:
+ * the suite and size header, the IV, the ciphertext and the tag. The encryption and the GHASH of the payload
+ * are done in a single pass, and the header is authenticated as additional data.
+ *
+ * @note The IVs are random, so at most 2^32 packets should be encrypted with the same key (NIST SP 800-38D, 8.3).
+ *
+ * @param data_in Pointer to the input data.
+ * @param data_in_length Length of the input data.
+ * @param ctx_AES Pointer to the expanded AES key (key schedule handle, see API_KM_loadkey).
+ * @param packet_out Pointer to the output buffer, at least PCA_GCM_OVERHEAD bytes larger than the input data (must not overlap it).
+ * @param packet_out_length Pointer to a size_t that will be set to the length of the packet.
+ *
+ * @return Returns 1 on NOT ALLOCATED MEMORY (success), PRNG_GENERATION_FAILED if not enough entropy is avaiable in the system,
+ * SM_ERROR_STATE if the module is not in cryptographic state.
+ */
+int API_PCA_encrypt_packet_GCM(unsigned char *data_in, size_t data_in_length, AesContext const *ctx_AES, unsigned char *packet_out, size_t *packet_out_length);
+
+/**
+ * @brief Verify and decrypt a data packet built by API_PCA_encrypt_packet_GCM.
+ *
+ * The ciphertext is decrypted and authenticated in a single pass directly into the output buffer. If the tag
+ * is not verified the output buffer is zeroized and the output length is set to 0.
+ *
+ * @param data_in Pointer to the packet.
+ * @param data_in_length Length of the packet.
+ * @param ctx_AES Pointer to the expanded AES key (key schedule handle, see API_KM_loadkey).
+ * @param out_data Pointer to the output buffer, at least data_in_length - PCA_GCM_OVERHEAD bytes.
+ * @param out_data_length Pointer to a size_t that will be set to the length of the plain data.
+ * @param verify Pointer to the buffer where the result of the tag verification will be stored.
+ *
+ * @return Returns 0 on MAC_NOT_VERIFIED, 1 on NOT ALLOCATED MEMORY (success), SM_ERROR_STATE if the module is not in cryptographic state.
+ */
+int API_PCA_decrypt_packet_GCM(unsigned char *data_in, size_t data_in_length, AesContext const *ctx_AES, unsigned char *out_data, size_t *out_data_length, unsigned char *verify);
+
+/**
+ * @brief Encrypt and authenticate a data packet using ChaCha20-Poly1305.
+ *
+ * Same packet construction as API_PCA_encrypt_packet_GCM with a random 96 bits nonce. ChaCha20 only uses
+ * additions, rotations and XORs, so it is constant time and fast on the hosts where AES is computed in software.
+ *
+ * @param data_in Pointer to the input data.
+ * @param data_in_length Length of the input data.
+ * @param key_ChaCha Pointer to the 32 bytes ChaCha20-Poly1305 key.
+ * @param packet_out Pointer to the output buffer, at least PCA_CHACHA_OVERHEAD bytes larger than the input data (must not overlap it).
+ * @param packet_out_length Pointer to a size_t that will be set to the length of the packet.
+ *
+ * @return Returns 1 on NOT ALLOCATED MEMORY (success), PRNG_GENERATION_FAILED if not enough entropy is avaiable in the system,
+ * SM_ERROR_STATE if the module is not in cryptographic state.
+ */
+int API_PCA_encrypt_packet_CHACHA(unsigned char *data_in, size_t data_in_length, const unsigned char *key_ChaCha, unsigned char *packet_out, size_t *packet_out_length);
+
+/**
+ * @brief Verify and decrypt a data packet built by API_PCA_encrypt_packet_CHACHA.
+ *
+ * The ciphertext is decrypted and authenticated in a single pass directly into the output buffer. If the tag
+ * is not verified the output buffer is zeroized and the output length is set to 0.
+ *
+ * @param data_in Pointer to the packet.
+ * @param data_in_length Length of the packet.
+ * @param key_ChaCha Pointer to the 32 bytes ChaCha20-Poly1305 key.
+ * @param out_data Pointer to the output buffer, at least data_in_length - PCA_CHACHA_OVERHEAD bytes.
+ * @param out_data_length Pointer to a size_t that will be set to the length of the plain data.
+ * @param verify Pointer to the buffer where the result of the tag verification will be stored.
+ *
+ * @return Returns 0 on MAC_NOT_VERIFIED, 1 on NOT ALLOCATED MEMORY (success), SM_ERROR_STATE if the module is not in cryptographic state.
+ */
+int API_PCA_decrypt_packet_CHACHA(unsigned char *data_in, size_t data_in_length, const unsigned char *key_ChaCha, unsigned char *out_data, size_t *out_data_length, unsigned char *verify);
+
+/**
+ * @brief Returns the suite given to a key when it is loaded.
+ *
+ * AES-CBC + HMAC-SHA256 if API_AES_getImplementation() reports AES-NI, ChaCha20-Poly1305 if AES is computed
+ * in software (table based, bitsliced or vector permute AES are several times slower than ChaCha20).
+ *
+ * @return PCA_SUITE_AES_CBC_HMAC_SHA256 or PCA_SUITE_CHACHA20_POLY1305.
+ */
+unsigned char API_PCA_default_suite();
+
+/**
+ * @brief Returns the suite of a packet, stored in the first byte of its header.
+ *
+ * @param packet Pointer to the packet (at least 8 bytes).
+ *
+ * @return The suite of the packet (PCA_SUITE_AES_CBC_HMAC_SHA256, PCA_SUITE_AES_GCM, PCA_SUITE_CHACHA20_POLY1305, or an unknown value).
+ */
+unsigned char API_PCA_get_packet_suite(const unsigned char *packet);
+
+/**
+ * @brief Checks if a suite identifier is one of the packet suites supported by this module.
+ *
+ * @param suite Suite identifier.
+ *
+ * @return 1 if the suite is supported, 0 otherwise.
+ */
+int API_PCA_is_valid_suite(unsigned char suite);
 
 #endif
\ No newline at end of file
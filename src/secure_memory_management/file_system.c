@@ -19,6 +19,7 @@ unsigned char FS_data_buffer[MAX_FILE_DATA]; // CSP shared data buffer wich is o
                                              // the data in this buffer is supposed to be copied to another buffer which is not going to be overwriten by consecutive operations
                                              // FS does not really support threads as this buffer can be overwriten with 2 consecutive FS calls
 unsigned char FS_cipher_key[32];
+AesContext FS_cipher_ctx; // key schedule of FS_cipher_key, CSP
 // Schneier patrons for secure zeroization making it harder for data recovery
 static const unsigned char Schneier_patterns[] = {0x00, 0xFF, 0xAA, 0x55, 0xAA, 0x55};
 
@@ -205,6 +206,7 @@ int API_FS_setup_cipher(uint8_t mode, uint8_t *fs_Key)
     {
         MetadataBlock.cipher_mode = CIPHER_ON;
         memcpy(FS_cipher_key, fs_Key, 32);
+        API_AES_initkey(&FS_cipher_ctx, FS_cipher_key, AES_KEY_SIZE_256); // expanded once, reused by every file operation
         return 1;
     }
     else if (mode == CIPHER_OFF)
@@ -307,7 +309,7 @@ int API_FS_create_file_data(unsigned char *filename, size_t filename_length, uns
     if (isCSP && MetadataBlock.cipher_mode == CIPHER_ON)
     {
         API_RNG_fill_buffer_random(MetadataBlock.allocations[new_allocation_index].IV, AES_BLOCK_SIZE);
-        API_AES_OFB_EncryptDecrypt(data, data_size, FS_cipher_key, AES_KEY_SIZE_256, MetadataBlock.allocations[new_allocation_index].IV, FS_data_buffer);
+        API_AES_OFB_EncryptDecrypt_ctx(&FS_cipher_ctx, data, data_size, MetadataBlock.allocations[new_allocation_index].IV, FS_data_buffer);
         fseek(MetadataBlock.FS_data_descriptor, offset + sizeof(MetadataBlock), SEEK_SET);
         write_bytes = fwrite(FS_data_buffer, 1, data_size, MetadataBlock.FS_data_descriptor);
     }
@@ -386,7 +388,7 @@ int API_FS_zeroize_file(unsigned char *filename, size_t filename_length)
         // Decrypt the data if encryption is enabled
         if (MetadataBlock.cipher_mode == CIPHER_ON)
         {
-            API_AES_OFB_EncryptDecrypt(FS_data_buffer, MetadataBlock.allocations[index].size, FS_cipher_key, AES_KEY_SIZE_256, MetadataBlock.allocations[index].IV, FS_data_buffer);
+            API_AES_OFB_EncryptDecrypt_ctx(&FS_cipher_ctx, FS_data_buffer, MetadataBlock.allocations[index].size, MetadataBlock.allocations[index].IV, FS_data_buffer);
         }
         // Verify data integrity via CRC32
         unsigned int New_CRC32 = crc_32(FS_data_buffer, MetadataBlock.allocations[index].size);
@@ -454,7 +456,7 @@ int API_FS_delete_file(unsigned char *filename, size_t filename_length)
         }
         // if cipher mode, decipher it
         if (MetadataBlock.allocations[index].isCSP && MetadataBlock.cipher_mode == CIPHER_ON)
-            API_AES_OFB_EncryptDecrypt(FS_data_buffer, MetadataBlock.allocations[index].size, FS_cipher_key, AES_KEY_SIZE_256, MetadataBlock.allocations[index].IV, FS_data_buffer);
+            API_AES_OFB_EncryptDecrypt_ctx(&FS_cipher_ctx, FS_data_buffer, MetadataBlock.allocations[index].size, MetadataBlock.allocations[index].IV, FS_data_buffer);
 
         unsigned int New_CRC32 = crc_32(FS_data_buffer, MetadataBlock.allocations[index].size);
         corrupted_data = (New_CRC32 == MetadataBlock.allocations[index].CRC_32_checksum) ? 0 : 1;
@@ -519,7 +521,7 @@ int API_FS_read_file_data(unsigned char *filename, size_t filename_length, unsig
         }
         // if setup to cipher mode, we decipher it
         if (MetadataBlock.allocations[index].isCSP && MetadataBlock.cipher_mode == CIPHER_ON)
-            API_AES_OFB_EncryptDecrypt(FS_data_buffer, MetadataBlock.allocations[index].size, FS_cipher_key, AES_KEY_SIZE_256, MetadataBlock.allocations[index].IV, FS_data_buffer);
+            API_AES_OFB_EncryptDecrypt_ctx(&FS_cipher_ctx, FS_data_buffer, MetadataBlock.allocations[index].size, MetadataBlock.allocations[index].IV, FS_data_buffer);
 
         *buffer_out = FS_data_buffer;                         // assign input parameter pointer, to the global data buffer
         *data_length = MetadataBlock.allocations[index].size; // assign input length pointer to the size of the file
@@ -611,7 +613,7 @@ int API_FS_update_file_data(unsigned char *filename, size_t filename_length, uns
         }
         if (MetadataBlock.cipher_mode == CIPHER_ON)
         {
-            API_AES_OFB_EncryptDecrypt(FS_data_buffer, MetadataBlock.allocations[index].size, FS_cipher_key, AES_KEY_SIZE_256, MetadataBlock.allocations[index].IV, FS_data_buffer);
+            API_AES_OFB_EncryptDecrypt_ctx(&FS_cipher_ctx, FS_data_buffer, MetadataBlock.allocations[index].size, MetadataBlock.allocations[index].IV, FS_data_buffer);
         }
         int New_CRC32 = crc_32(FS_data_buffer, MetadataBlock.allocations[index].size);
         corrupted_data = (New_CRC32 == MetadataBlock.allocations[index].CRC_32_checksum) ? 0 : 1;
@@ -627,7 +629,7 @@ int API_FS_update_file_data(unsigned char *filename, size_t filename_length, uns
         // cipher the new data in case is csp, and cipher mode is on:
         if (MetadataBlock.allocations[index].isCSP && MetadataBlock.cipher_mode == CIPHER_ON)
         {
-            API_AES_OFB_EncryptDecrypt(data, data_size, FS_cipher_key, AES_KEY_SIZE_256, MetadataBlock.allocations[index].IV, FS_data_buffer);
+            API_AES_OFB_EncryptDecrypt_ctx(&FS_cipher_ctx, data, data_size, MetadataBlock.allocations[index].IV, FS_data_buffer);
             fseek(MetadataBlock.FS_data_descriptor, current_offset + sizeof(MetadataBlock), SEEK_SET);
             bytes_trafic = fwrite(FS_data_buffer, 1, data_size, MetadataBlock.FS_data_descriptor);
         }
@@ -683,7 +685,7 @@ int API_FS_update_file_data(unsigned char *filename, size_t filename_length, uns
         // if is csp and CIPHER mode is activated, cipher it before write:
         if (MetadataBlock.allocations[index].isCSP && MetadataBlock.cipher_mode == CIPHER_ON)
         {
-            API_AES_OFB_EncryptDecrypt(data, data_size, FS_cipher_key, AES_KEY_SIZE_256, MetadataBlock.allocations[index].IV, FS_data_buffer);
+            API_AES_OFB_EncryptDecrypt_ctx(&FS_cipher_ctx, data, data_size, MetadataBlock.allocations[index].IV, FS_data_buffer);
             fseek(MetadataBlock.FS_data_descriptor, new_offset + sizeof(MetadataBlock), SEEK_SET);
             bytes_trafic = fwrite(FS_data_buffer, 1, data_size, MetadataBlock.FS_data_descriptor);
         }
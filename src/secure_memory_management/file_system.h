@@ -139,6 +139,8 @@ extern unsigned char FS_data_buffer[MAX_FILE_DATA]; // CSP
 
 extern unsigned char FS_cipher_key[32]; //CSP
 
+extern AesContext FS_cipher_ctx; // key schedule of FS_cipher_key computed by API_FS_setup_cipher, CSP
+
 /* Type definitions ................................................. */
 
 /**
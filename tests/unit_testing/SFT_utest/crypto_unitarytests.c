@@ -11,6 +11,9 @@ START_TEST(test_crypto_primitives)
     ck_assert_int_eq(API_SFT_SHA256Tests(),1); 
     ck_assert_int_eq(API_SFT_HMAC256_SHA256_Test(),1);
     ck_assert_int_eq(API_SFT_AES256_CBC_Tests(),1);
+    ck_assert_int_eq(API_SFT_AES256_CTR_Tests(),1);
+    ck_assert_int_eq(API_SFT_AES256_GCM_Tests(),1);
+    ck_assert_int_eq(API_SFT_CHACHA20_POLY1305_Tests(),1);
     ck_assert_int_eq(API_SFT_ECDSA256_SHA256_Tests(),1);
 }
 
@@ -10,6 +10,9 @@
 
 //include the already made selftests
 #include "../../../src/crypto-selftests/AES256_CBC_Tests.h"
+#include "../../../src/crypto-selftests/AES256_CTR_Tests.h"
+#include "../../../src/crypto-selftests/AES256_GCM_Tests.h"
+#include "../../../src/crypto-selftests/CHACHA20_POLY1305_Tests.h"
 #include "../../../src/crypto-selftests/ECDSA256Tests.h"
 #include "../../../src/crypto-selftests/HMACTests.h"
 #include "../../../src/crypto-selftests/SHA256Tests.h"